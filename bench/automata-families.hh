@@ -0,0 +1,201 @@
+/**
+ * @file automata-families.hh
+ * @brief Parameterized families of automata for scaling benchmarks.
+ *
+ * Families (symbols are 0, ..., alphabet - 1; state 0 is the only initial state):
+ * - `random`: Tabakov-Vardi random NFA; every symbol has round(density * states) transitions
+ *   between distinct random pairs of states and round(final-density * states) states are final.
+ * - `nth-from-end`: words whose (states - 1)-th symbol from the end is 0, the worst case of the subset
+ *   construction (its minimal DFA has 2^(states - 1) states).
+ * - `wide-sparse`: every state has out-degree transitions on distinct random symbols of a wide alphabet.
+ * - `nondet`: every state has nondet distinct random targets on every symbol, so the MONA encoding
+ *   needs ceil(log2(nondet)) nondeterminism variables.
+ */
+#ifndef MAMONATA_BENCH_AUTOMATA_FAMILIES_HH_
+#define MAMONATA_BENCH_AUTOMATA_FAMILIES_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "mata-bridge/nfa.hh"
+
+namespace mamonata::bench {
+
+using MataNfa = mamonata::mata::nfa::Nfa;
+using State = mamonata::mata::nfa::State;
+using Symbol = mamonata::mata::nfa::Symbol;
+
+// Parameters of all families; every family reads only some of them.
+struct FamilyParameters {
+    size_t num_of_states = 64;   // states: Number of states.
+    size_t alphabet_size = 2;    // alphabet: Number of symbols.
+    double density = 1.25;       // density: Transitions per symbol divided by the number of states (random).
+    double final_density = 0.5;  // final-density: Fraction of final states (random, wide-sparse, nondet).
+    size_t out_degree = 2;       // out-degree: Transitions per state (wide-sparse).
+    size_t nondeterminism = 4;   // nondet: Targets per state and symbol (nondet).
+    uint64_t seed = 1;           // seed: Seed of the random generator.
+};
+
+const std::vector<std::string> FAMILIES = { "random", "nth-from-end", "wide-sparse", "nondet" };
+
+// Sets a parameter given by its name (see FamilyParameters) from its textual value.
+inline void set_family_parameter(FamilyParameters& parameters, const std::string& name, const std::string& value) {
+    if (name == "states") {
+        parameters.num_of_states = std::stoul(value);
+    } else if (name == "alphabet") {
+        parameters.alphabet_size = std::stoul(value);
+    } else if (name == "density") {
+        parameters.density = std::stod(value);
+    } else if (name == "final-density") {
+        parameters.final_density = std::stod(value);
+    } else if (name == "out-degree") {
+        parameters.out_degree = std::stoul(value);
+    } else if (name == "nondet") {
+        parameters.nondeterminism = std::stoul(value);
+    } else if (name == "seed") {
+        parameters.seed = std::stoull(value);
+    } else {
+        throw std::runtime_error("Unknown family parameter: " + name);
+    }
+}
+
+// Sets parameters from a list `name=value,name=value,...`.
+inline void set_family_parameters(FamilyParameters& parameters, const std::string& list) {
+    std::istringstream iss(list);
+    std::string assignment;
+    while (std::getline(iss, assignment, ',')) {
+        const size_t separator = assignment.find('=');
+        if (separator == std::string::npos) {
+            throw std::runtime_error("Expected name=value: " + assignment);
+        }
+        set_family_parameter(parameters, assignment.substr(0, separator), assignment.substr(separator + 1));
+    }
+}
+
+// Makes round(fraction * num_of_states) random states final, at least one.
+inline void add_random_final_states(MataNfa& nfa, const double fraction, std::mt19937_64& rng) {
+    std::vector<State> states(nfa.num_of_states());
+    std::iota(states.begin(), states.end(), State{ 0 });
+    std::shuffle(states.begin(), states.end(), rng);
+    const size_t num_of_final = std::clamp<size_t>(static_cast<size_t>(std::llround(fraction * static_cast<double>(states.size()))),
+                                                   1, states.size());
+    for (size_t i = 0; i < num_of_final; ++i) {
+        nfa.add_final_state(states[i]);
+    }
+}
+
+inline MataNfa generate_random(const FamilyParameters& parameters, std::mt19937_64& rng) {
+    const size_t n = parameters.num_of_states;
+    MataNfa nfa(n);
+    nfa.add_initial_state(0);
+    const size_t num_of_pairs = n * n;
+    const size_t per_symbol = std::min(num_of_pairs, static_cast<size_t>(std::llround(parameters.density * static_cast<double>(n))));
+    std::unordered_set<size_t> pairs;
+    for (Symbol symbol = 0; symbol < parameters.alphabet_size; ++symbol) {
+        pairs.clear();
+        while (pairs.size() < per_symbol) {
+            const size_t pair = rng() % num_of_pairs;
+            if (pairs.insert(pair).second) {
+                nfa.add_transition(pair / n, symbol, pair % n);
+            }
+        }
+    }
+    add_random_final_states(nfa, parameters.final_density, rng);
+    return nfa;
+}
+
+inline MataNfa generate_nth_from_end(const FamilyParameters& parameters) {
+    if (parameters.num_of_states < 2 || parameters.alphabet_size < 2) {
+        throw std::runtime_error("The nth-from-end family needs at least two states and two symbols.");
+    }
+    const size_t n = parameters.num_of_states;
+    MataNfa nfa(n);
+    nfa.add_initial_state(0);
+    nfa.add_final_state(n - 1);
+    for (Symbol symbol = 0; symbol < parameters.alphabet_size; ++symbol) {
+        nfa.add_transition(0, symbol, 0);
+        for (State state = 1; state + 1 < n; ++state) {
+            nfa.add_transition(state, symbol, state + 1);
+        }
+    }
+    nfa.add_transition(0, 0, 1);
+    return nfa;
+}
+
+inline MataNfa generate_wide_sparse(const FamilyParameters& parameters, std::mt19937_64& rng) {
+    const size_t n = parameters.num_of_states;
+    const size_t out_degree = std::min(parameters.out_degree, parameters.alphabet_size);
+    MataNfa nfa(n);
+    nfa.add_initial_state(0);
+    std::unordered_set<Symbol> symbols;
+    for (State state = 0; state < n; ++state) {
+        symbols.clear();
+        while (symbols.size() < out_degree) {
+            const Symbol symbol = static_cast<Symbol>(rng() % parameters.alphabet_size);
+            if (symbols.insert(symbol).second) {
+                nfa.add_transition(state, symbol, rng() % n);
+            }
+        }
+    }
+    add_random_final_states(nfa, parameters.final_density, rng);
+    return nfa;
+}
+
+inline MataNfa generate_nondet(const FamilyParameters& parameters, std::mt19937_64& rng) {
+    const size_t n = parameters.num_of_states;
+    const size_t num_of_targets = std::min(parameters.nondeterminism, n);
+    MataNfa nfa(n);
+    nfa.add_initial_state(0);
+    std::unordered_set<State> targets;
+    for (State state = 0; state < n; ++state) {
+        for (Symbol symbol = 0; symbol < parameters.alphabet_size; ++symbol) {
+            targets.clear();
+            while (targets.size() < num_of_targets) {
+                const State target = rng() % n;
+                if (targets.insert(target).second) {
+                    nfa.add_transition(state, symbol, target);
+                }
+            }
+        }
+    }
+    add_random_final_states(nfa, parameters.final_density, rng);
+    return nfa;
+}
+
+/**
+ * @brief Generates an automaton of a family.
+ *
+ * @throws std::runtime_error If the family is unknown or the parameters do not fit it.
+ *
+ * @param family Name of the family (see FAMILIES).
+ * @param parameters Parameters of the family; equal parameters give equal automata.
+ *
+ * @return Generated automaton.
+ */
+inline MataNfa generate_family(const std::string& family, const FamilyParameters& parameters) {
+    if (parameters.num_of_states == 0 || parameters.alphabet_size == 0) {
+        throw std::runtime_error("Generated automata need at least one state and one symbol.");
+    }
+    std::mt19937_64 rng(parameters.seed);
+    if (family == "random") {
+        return generate_random(parameters, rng);
+    } else if (family == "nth-from-end") {
+        return generate_nth_from_end(parameters);
+    } else if (family == "wide-sparse") {
+        return generate_wide_sparse(parameters, rng);
+    } else if (family == "nondet") {
+        return generate_nondet(parameters, rng);
+    }
+    throw std::runtime_error("Unknown automata family: " + family);
+}
+
+} // namespace mamonata::bench
+
+#endif // MAMONATA_BENCH_AUTOMATA_FAMILIES_HH_
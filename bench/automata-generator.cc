@@ -0,0 +1,109 @@
+/**
+ * @file automata-generator.cc
+ * @brief Generator of scaling benchmark inputs from parameterized families of automata.
+ *
+ * Usage: automata-generator --family NAME --output PREFIX [--parameters name=value,...]
+ *                           [--sweep name=v1,v2,...] [--binary]
+ *
+ * Families and parameters are described in automata-families.hh. Every automaton is written
+ * to PREFIX.mata; with --binary, its MONA conversion is also written to PREFIX.bin
+ * (see Nfa::save_binary). With --sweep, one pair of automata is generated per value of the swept
+ * parameter: PREFIX-NAME-VALUE-a.mata and PREFIX-NAME-VALUE-b.mata, the second one with the next seed.
+ * A manifest of the pairs (see mamonata-bench) is written to standard output.
+ */
+#include <iostream>
+#include <sstream>
+#include "automata-families.hh"
+#include "mona-bridge/nfa.hh"
+
+using namespace mamonata::bench;
+using MonaNfa = mamonata::mona::nfa::Nfa;
+
+namespace {
+
+struct Options {
+    std::string family;
+    std::string output;
+    FamilyParameters parameters;
+    std::string sweep_parameter;
+    std::vector<std::string> sweep_values;
+    bool binary = false;
+};
+
+Options parse_options(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next_value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for option: " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--family") {
+            options.family = next_value();
+        } else if (arg == "--output") {
+            options.output = next_value();
+        } else if (arg == "--parameters") {
+            set_family_parameters(options.parameters, next_value());
+        } else if (arg == "--sweep") {
+            const std::string sweep = next_value();
+            const size_t separator = sweep.find('=');
+            if (separator == std::string::npos) {
+                throw std::runtime_error("Expected --sweep name=v1,v2,...: " + sweep);
+            }
+            options.sweep_parameter = sweep.substr(0, separator);
+            std::istringstream iss(sweep.substr(separator + 1));
+            std::string value;
+            while (std::getline(iss, value, ',')) {
+                options.sweep_values.push_back(value);
+            }
+        } else if (arg == "--binary") {
+            options.binary = true;
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+
+    if (options.family.empty() || options.output.empty()) {
+        throw std::runtime_error("Usage: automata-generator --family NAME --output PREFIX [--parameters name=value,...] "
+                                 "[--sweep name=v1,v2,...] [--binary]");
+    }
+    return options;
+}
+
+void write_automaton(const MataNfa& nfa, const std::string& prefix, const bool binary) {
+    nfa.save(prefix + ".mata");
+    if (binary) {
+        MonaNfa(nfa).save_binary(prefix + ".bin");
+    }
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        const Options options = parse_options(argc, argv);
+        if (options.sweep_values.empty()) {
+            write_automaton(generate_family(options.family, options.parameters), options.output, options.binary);
+            return 0;
+        }
+
+        for (const std::string& value : options.sweep_values) {
+            FamilyParameters parameters = options.parameters;
+            set_family_parameter(parameters, options.sweep_parameter, value);
+            const std::string name = options.family + "-" + options.sweep_parameter + "-" + value;
+            const std::string prefix = options.output + "-" + options.sweep_parameter + "-" + value;
+            write_automaton(generate_family(options.family, parameters), prefix + "-a", options.binary);
+            ++parameters.seed;
+            write_automaton(generate_family(options.family, parameters), prefix + "-b", options.binary);
+            std::cout << name << " " << prefix << "-a.mata " << prefix << "-b.mata\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,610 @@
+/**
+ * @file mamonata-batch.cc
+ * @brief Parallel driver running the example comparisons over a corpus of automata.
+ *
+ * Usage: mamonata-batch (--manifest FILE | --corpus DIR) [--operations op1,op2,...] [--threads N]
+ *                       [--timeout SECONDS] [--memory-limit MB] [--isolate]
+ *                       [--format csv|json] [--output FILE]
+ *
+ * The manifest has the format of mamonata-bench: `name path_a [path_b]` per line.
+ * With --corpus, every `*.mata` file of the directory is a benchmark named after the file;
+ * binary operations pair it with the next file in sorted order (the last one with the first).
+ *
+ * Each (benchmark, operation) pair is a job running the comparison of the example of the same
+ * name (see examples/): the Mata operation, the projection of nondeterminism bits of the MONA
+ * operands and the MONA operation. Jobs run on a work-stealing pool of --threads workers
+ * (0 = number of hardware threads). Every automaton is parsed once, by the first job needing it,
+ * and shared by all later jobs running in this process. One row is written per job as soon as it finishes.
+ *
+ * The MONA parts of jobs running in this process (conversions, projections and operations) run
+ * one at a time (see mona::nfa::Nfa on threads), while the Mata parts overlap.
+ *
+ * MONA operations cannot be interrupted, so with --timeout or --memory-limit every job runs in
+ * a child process started by posix_spawn() as `mamonata-batch --job OPERATION PATH_A PATH_B MB`,
+ * which parses the operands itself, runs the single job and writes its result to stdout. The child
+ * is killed when it exceeds the timeout and its address space is limited to the given size. Crashing
+ * jobs are reported without stopping the batch as well; --isolate runs the jobs in children even
+ * without limits.
+ *
+ * Statuses: ok, timeout, memout and error (with a message).
+ */
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <spawn.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "mata-bridge/nfa.hh"
+#include "mona-bridge/nfa.hh"
+#include "timer.hh"
+#include "work-stealing-pool.hh"
+
+#ifndef TIMING_ENABLED
+#error "The batch driver requires timing to be enabled. Please enable TIMING_ENABLED in CMake configuration."
+#endif
+
+using MataNfa = mamonata::mata::nfa::Nfa;
+using MonaNfa = mamonata::mona::nfa::Nfa;
+
+namespace {
+
+// Operations of the examples; binary operations take two operands.
+const std::vector<std::pair<std::string, bool>> OPERATIONS = {
+    { "brzozowski", false },
+    { "hopcroft", false },
+    { "complement", false },
+    { "determinize", false },
+    { "intersection", true },
+    { "union", true },
+    { "to_mona", false },
+};
+
+// Single benchmark from the manifest or the corpus.
+struct Benchmark {
+    std::string name;
+    std::string path_a;
+    std::string path_b;
+};
+
+// Automaton parsed by the first job using it.
+struct Operand {
+    std::once_flag parsed;
+    MataNfa nfa;
+    std::string error;  // Non-empty if the file could not be parsed.
+};
+
+// Result of one job, i.e., one operation on one benchmark.
+struct JobResult {
+    std::string benchmark;
+    std::string operation;
+    std::string status = "ok";
+    Timer::microseconds mata_us = 0;
+    Timer::microseconds mona_det_us = 0;  // Projection of nondeterminism bits of the MONA operands.
+    Timer::microseconds mona_us = 0;
+    size_t mata_states = 0;
+    size_t mona_states = 0;
+    long wall_ms = 0;  // Duration of the whole job, including parsing, conversions and child processes.
+    size_t worker = 0;
+    std::string message;
+};
+
+struct Options {
+    std::string manifest;
+    std::string corpus;
+    std::vector<std::string> operations;
+    size_t num_of_threads = 0;
+    long timeout_seconds = 0;
+    size_t memory_limit_mb = 0;
+    bool isolate = false;
+    std::string format = "csv";
+    std::string output;
+};
+
+// Converts the operands to MONA with a shared encoding and projects out their nondeterminism bits.
+std::vector<MonaNfa> make_mona_operands(const std::vector<const MataNfa*>& operands, JobResult& result) {
+    std::set<mamonata::mata::nfa::Symbol> symbols;
+    for (const MataNfa* operand : operands) {
+        for (const auto symbol : operand->get_used_symbols()) {
+            symbols.insert(symbol);
+        }
+    }
+    const auto encoding = MonaNfa::make_alphabet_encoding(mamonata::mona::nfa::MataSymbolVector(symbols.begin(), symbols.end()));
+
+    std::vector<MonaNfa> mona_operands;
+    mona_operands.reserve(operands.size());
+    for (const MataNfa* operand : operands) {
+        MonaNfa& mona = mona_operands.emplace_back(*operand, encoding);
+        if (!mona.is_deterministic()) {
+            mona.determinize();
+            result.mona_det_us += Timer::get("determinize");
+        }
+    }
+    return mona_operands;
+}
+
+// Serializes the MONA parts of the jobs running in this process.
+std::mutex mona_mutex;
+
+// Runs the comparison of the example of the operation, filling in the durations and result sizes.
+// The Mata part runs concurrently with other jobs; the MONA part, including the conversions, holds mona_mutex.
+void run_operation(const std::string& operation, const MataNfa& operand_a, const MataNfa& operand_b, JobResult& result) {
+    MataNfa a = operand_a;
+    MataNfa b = operand_b;
+
+    if (operation == "brzozowski" || operation == "hopcroft") {
+        if (operation == "brzozowski") {
+            a.minimize_brzozowski();
+            result.mata_us = Timer::get("minimize_brzozowski");
+        } else {
+            a.minimize_hopcroft();
+            result.mata_us = Timer::get("minimize_hopcroft");
+        }
+        result.mata_states = a.num_of_states();
+
+        std::lock_guard<std::mutex> lock(mona_mutex);
+        std::vector<MonaNfa> mona = make_mona_operands({ &operand_a }, result);
+        if (operation == "brzozowski") {
+            mona[0].minimize();
+            result.mona_us = Timer::get("minimize");
+        } else {
+            // Both sides run Hopcroft's partition refinement.
+            mona[0].minimize_hopcroft();
+            result.mona_us = Timer::get("minimize_hopcroft");
+        }
+        result.mona_states = mona[0].num_of_states();
+    } else if (operation == "complement") {
+        a.complement_classical(a.get_used_symbols());
+        result.mata_us = Timer::get("complement_classical");
+        result.mata_states = a.num_of_states();
+
+        std::lock_guard<std::mutex> lock(mona_mutex);
+        std::vector<MonaNfa> mona = make_mona_operands({ &operand_a }, result);
+        mona[0].complement();
+        result.mona_us = Timer::get("complement");
+        result.mona_states = mona[0].num_of_states();
+    } else if (operation == "determinize") {
+        a.determinize();
+        result.mata_us = Timer::get("determinize");
+        result.mata_states = a.num_of_states();
+
+        std::lock_guard<std::mutex> lock(mona_mutex);
+        MonaNfa mona(operand_a);
+        mona.determinize();
+        result.mona_us = Timer::get("determinize");
+        result.mona_states = mona.num_of_states();
+    } else if (operation == "intersection" || operation == "union") {
+        if (operation == "intersection") {
+            a.intersection(b);
+            result.mata_us = Timer::get("intersection");
+        } else {
+            a.union_nondet(b);
+            result.mata_us = Timer::get("union_nondet");
+        }
+        result.mata_states = a.num_of_states();
+
+        std::lock_guard<std::mutex> lock(mona_mutex);
+        std::vector<MonaNfa> mona = make_mona_operands({ &operand_a, &operand_b }, result);
+        if (operation == "intersection") {
+            mona[0].intersection(mona[1]);
+            result.mona_us = Timer::get("intersection");
+        } else {
+            mona[0].union_det_complete(mona[1]);
+            result.mona_us = Timer::get("union_det_complete");
+        }
+        result.mona_states = mona[0].num_of_states();
+    } else if (operation == "to_mona") {
+        result.mata_states = a.num_of_states();
+
+        std::lock_guard<std::mutex> lock(mona_mutex);
+        Timer::Span span("batch_from_mata");
+        MonaNfa mona(a);
+        result.mona_us = span.stop() / 1000;
+        result.mona_states = mona.num_of_states();
+    } else {
+        throw std::runtime_error("Unknown operation: " + operation);
+    }
+}
+
+// Runs the job in the calling thread, turning exceptions into statuses.
+void run_job(const std::string& operation, const MataNfa& a, const MataNfa& b, JobResult& result) {
+    try {
+        run_operation(operation, a, b, result);
+    } catch (const std::bad_alloc&) {
+        result.status = "memout";
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.message = e.what();
+    }
+}
+
+// Serializes the fields computed by a job, one per line, to pass them from a child process.
+std::string serialize(const JobResult& result) {
+    std::ostringstream oss;
+    std::string message = result.message;
+    std::replace(message.begin(), message.end(), '\n', ' ');
+    oss << result.status << '\n' << result.mata_us << '\n' << result.mona_det_us << '\n' << result.mona_us << '\n'
+        << result.mata_states << '\n' << result.mona_states << '\n' << message << '\n';
+    return oss.str();
+}
+
+// Reads the fields written by serialize(); returns false if the data is incomplete.
+bool deserialize(const std::string& data, JobResult& result) {
+    std::istringstream iss(data);
+    if (!(iss >> result.status >> result.mata_us >> result.mona_det_us >> result.mona_us
+              >> result.mata_states >> result.mona_states)) {
+        return false;
+    }
+    iss.ignore(1);
+    std::getline(iss, result.message);
+    return true;
+}
+
+/**
+ * @brief Runs the job in a child process limited by the options.
+ *
+ * The child is this driver started by posix_spawn() in the single-job mode (see run_single_job()),
+ * so no code of the parent runs in a copy of its threads. Its stdout is the write end of a pipe;
+ * the pipe is created close-on-exec, so children of other jobs started meanwhile do not inherit it.
+ */
+void run_job_isolated(const std::string& operation, const std::string& path_a, const std::string& path_b,
+                      const Options& options, JobResult& result) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        throw std::runtime_error("Could not create a pipe: " + std::string(std::strerror(errno)));
+    }
+    std::vector<std::string> args{ "mamonata-batch", "--job", operation, path_a, path_b, std::to_string(options.memory_limit_mb) };
+    std::vector<char*> child_argv;
+    for (std::string& arg : args) {
+        child_argv.push_back(arg.data());
+    }
+    child_argv.push_back(nullptr);
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    pid_t pid;
+    const int error = posix_spawn(&pid, "/proc/self/exe", &actions, nullptr, child_argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (error != 0) {
+        close(fds[0]);
+        throw std::runtime_error("Could not start a job process: " + std::string(std::strerror(error)));
+    }
+
+    // Collect the output of the child until it closes the pipe or the timeout expires.
+    using clock_t = std::chrono::steady_clock;
+    const clock_t::time_point deadline = clock_t::now() + std::chrono::seconds(options.timeout_seconds);
+    std::string data;
+    bool timed_out = false;
+    char buffer[4096];
+    while (true) {
+        int wait_ms = -1;
+        if (options.timeout_seconds > 0) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock_t::now());
+            if (remaining.count() <= 0) {
+                timed_out = true;
+                break;
+            }
+            wait_ms = static_cast<int>(remaining.count());
+        }
+        struct pollfd pfd{ fds[0], POLLIN, 0 };
+        const int ready = poll(&pfd, 1, wait_ms);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready == 0) {
+            continue;  // The deadline is checked at the start of the loop.
+        }
+        const ssize_t n = read(fds[0], buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+
+    if (timed_out) {
+        kill(pid, SIGKILL);
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+    if (timed_out) {
+        result.status = "timeout";
+    } else if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && deserialize(data, result)) {
+        // The child reported its result.
+    } else if (WIFEXITED(status) && options.memory_limit_mb > 0) {
+        // MONA terminates the process when an allocation fails.
+        result.status = "memout";
+    } else if (WIFSIGNALED(status)) {
+        result.status = "error";
+        result.message = "killed by signal " + std::to_string(WTERMSIG(status));
+    } else {
+        result.status = "error";
+        result.message = "exited with status " + std::to_string(WEXITSTATUS(status));
+    }
+}
+
+/**
+ * @brief Runs a single job given as `--job OPERATION PATH_A PATH_B MEMORY_LIMIT_MB` in this process.
+ *
+ * This is the child of run_job_isolated(). The address space is limited before the operands are
+ * parsed and the result is written to stdout by serialize().
+ *
+ * @return Exit status of the process.
+ */
+int run_single_job(int argc, char *argv[]) {
+    if (argc != 6) {
+        std::cerr << "Usage: mamonata-batch --job OPERATION PATH_A PATH_B MEMORY_LIMIT_MB" << std::endl;
+        return 1;
+    }
+    const std::string operation = argv[2];
+    const std::string path_a = argv[3];
+    const std::string path_b = argv[4];
+    const size_t memory_limit_mb = std::stoul(argv[5]);
+    if (memory_limit_mb > 0) {
+        const rlim_t limit = static_cast<rlim_t>(memory_limit_mb) << 20;
+        const struct rlimit rl{ limit, limit };
+        setrlimit(RLIMIT_AS, &rl);
+    }
+
+    JobResult result;
+    MataNfa a;
+    MataNfa b;
+    try {
+        a.load(path_a);
+        if (path_b == path_a) {
+            b = a;
+        } else {
+            b.load(path_b);
+        }
+    } catch (const std::bad_alloc&) {
+        result.status = "memout";
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.message = e.what();
+    }
+    if (result.status == "ok") {
+        run_job(operation, a, b, result);
+    }
+    std::cout << serialize(result) << std::flush;
+    return 0;
+}
+
+std::vector<Benchmark> read_manifest(const std::string& manifest_path) {
+    std::ifstream ifs(manifest_path);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Could not open manifest: " + manifest_path);
+    }
+
+    std::vector<Benchmark> benchmarks;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(line);
+        Benchmark benchmark;
+        if (!(iss >> benchmark.name) || benchmark.name[0] == '#') {
+            continue;
+        }
+        if (!(iss >> benchmark.path_a)) {
+            throw std::runtime_error("Missing automaton path for benchmark: " + benchmark.name);
+        }
+        if (!(iss >> benchmark.path_b)) {
+            benchmark.path_b = benchmark.path_a;
+        }
+        benchmarks.push_back(std::move(benchmark));
+    }
+    return benchmarks;
+}
+
+std::vector<Benchmark> read_corpus(const std::string& corpus_path) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(corpus_path)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".mata") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<Benchmark> benchmarks;
+    for (size_t i = 0; i < files.size(); ++i) {
+        benchmarks.push_back({ files[i].stem().string(), files[i].string(), files[(i + 1) % files.size()].string() });
+    }
+    return benchmarks;
+}
+
+Options parse_options(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next_value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for option: " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--manifest") {
+            options.manifest = next_value();
+        } else if (arg == "--corpus") {
+            options.corpus = next_value();
+        } else if (arg == "--operations") {
+            std::istringstream iss(next_value());
+            std::string operation;
+            while (std::getline(iss, operation, ',')) {
+                options.operations.push_back(operation);
+            }
+        } else if (arg == "--threads") {
+            options.num_of_threads = std::stoul(next_value());
+        } else if (arg == "--timeout") {
+            options.timeout_seconds = std::stol(next_value());
+        } else if (arg == "--memory-limit") {
+            options.memory_limit_mb = std::stoul(next_value());
+        } else if (arg == "--isolate") {
+            options.isolate = true;
+        } else if (arg == "--format") {
+            options.format = next_value();
+        } else if (arg == "--output") {
+            options.output = next_value();
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+
+    if (options.manifest.empty() == options.corpus.empty()) {
+        throw std::runtime_error("Usage: mamonata-batch (--manifest FILE | --corpus DIR) [--operations op1,op2,...] "
+                                 "[--threads N] [--timeout SECONDS] [--memory-limit MB] [--isolate] "
+                                 "[--format csv|json] [--output FILE]");
+    }
+    if (options.format != "csv" && options.format != "json") {
+        throw std::runtime_error("Unknown output format: " + options.format);
+    }
+    for (const std::string& operation : options.operations) {
+        if (std::none_of(OPERATIONS.begin(), OPERATIONS.end(), [&](const auto& op) { return op.first == operation; })) {
+            throw std::runtime_error("Unknown operation: " + operation);
+        }
+    }
+    if (options.timeout_seconds > 0 || options.memory_limit_mb > 0) {
+        options.isolate = true;
+    }
+    return options;
+}
+
+// Writes job results as CSV rows or JSON Lines from any thread, flushing after every row.
+class Writer {
+    std::ostream& os;
+    std::string format;
+    std::mutex mutex;
+
+public:
+    Writer(std::ostream& os, std::string format) : os(os), format(std::move(format)) {
+        if (this->format == "csv") {
+            os << "benchmark,operation,status,mata_us,mona_det_us,mona_us,mata_states,mona_states,wall_ms,worker,message" << std::endl;
+        }
+    }
+
+    void write(const JobResult& r) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (format == "csv") {
+            std::string message = r.message;
+            std::replace(message.begin(), message.end(), ',', ';');
+            os << r.benchmark << "," << r.operation << "," << r.status << "," << r.mata_us << "," << r.mona_det_us << ","
+               << r.mona_us << "," << r.mata_states << "," << r.mona_states << "," << r.wall_ms << "," << r.worker << ","
+               << message << "\n";
+        } else {
+            std::string message;
+            for (const char c : r.message) {
+                if (c == '"' || c == '\\') {
+                    message += '\\';
+                }
+                message += c;
+            }
+            os << "{\"benchmark\": \"" << r.benchmark << "\", \"operation\": \"" << r.operation
+               << "\", \"status\": \"" << r.status << "\", \"mata_us\": " << r.mata_us
+               << ", \"mona_det_us\": " << r.mona_det_us << ", \"mona_us\": " << r.mona_us
+               << ", \"mata_states\": " << r.mata_states << ", \"mona_states\": " << r.mona_states
+               << ", \"wall_ms\": " << r.wall_ms << ", \"worker\": " << r.worker
+               << ", \"message\": \"" << message << "\"}\n";
+        }
+        os.flush();
+    }
+};
+
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--job") {
+        return run_single_job(argc, argv);
+    }
+
+    try {
+        const Options options = parse_options(argc, argv);
+        const std::vector<Benchmark> benchmarks = options.manifest.empty() ? read_corpus(options.corpus)
+                                                                           : read_manifest(options.manifest);
+
+        std::ofstream ofs;
+        if (!options.output.empty()) {
+            ofs.open(options.output);
+            if (!ofs.is_open()) {
+                throw std::runtime_error("Could not open output file: " + options.output);
+            }
+        }
+        Writer writer(options.output.empty() ? std::cout : ofs, options.format);
+
+        // Every file is parsed at most once; the map itself is not modified by the jobs.
+        std::map<std::string, std::unique_ptr<Operand>> operands;
+        for (const Benchmark& benchmark : benchmarks) {
+            for (const std::string& path : { benchmark.path_a, benchmark.path_b }) {
+                if (!operands.contains(path)) {
+                    operands.emplace(path, std::make_unique<Operand>());
+                }
+            }
+        }
+        auto get_operand = [&](const std::string& path) -> const Operand& {
+            Operand& operand = *operands.at(path);
+            std::call_once(operand.parsed, [&]() {
+                try {
+                    operand.nfa.load(path);
+                } catch (const std::exception& e) {
+                    operand.error = e.what();
+                }
+            });
+            return operand;
+        };
+
+        mamonata::WorkStealingPool pool(options.num_of_threads);
+        for (const Benchmark& benchmark : benchmarks) {
+            for (const auto& [operation, is_binary] : OPERATIONS) {
+                if (!options.operations.empty() &&
+                    std::find(options.operations.begin(), options.operations.end(), operation) == options.operations.end()) {
+                    continue;
+                }
+
+                pool.submit([&, operation = operation, is_binary = is_binary]() {
+                    const auto start = std::chrono::steady_clock::now();
+                    JobResult result;
+                    result.benchmark = benchmark.name;
+                    result.operation = operation;
+                    result.worker = pool.get_worker_index();
+
+                    const std::string& path_b = is_binary ? benchmark.path_b : benchmark.path_a;
+                    if (options.isolate) {
+                        // The child parses the operands itself.
+                        run_job_isolated(operation, benchmark.path_a, path_b, options, result);
+                    } else {
+                        const Operand& a = get_operand(benchmark.path_a);
+                        const Operand& b = get_operand(path_b);
+                        if (!a.error.empty() || !b.error.empty()) {
+                            result.status = "error";
+                            result.message = a.error.empty() ? b.error : a.error;
+                        } else {
+                            run_job(operation, a.nfa, b.nfa, result);
+                        }
+                    }
+
+                    result.wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                    writer.write(result);
+                });
+            }
+        }
+        pool.wait();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
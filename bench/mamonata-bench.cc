@@ -0,0 +1,610 @@
+/**
+ * @file mamonata-bench.cc
+ * @brief Reproducible benchmark harness comparing Mata and MONA operations.
+ *
+ * Usage: mamonata-bench (--manifest FILE | --sweep FAMILY:NAME=V1,V2,...) [--repetitions N] [--warmup N]
+ *                       [--operations op1,op2,...] [--format csv|json] [--output FILE]
+ *                       [--conversion-cache BYTES] [--threads N] [--optimize-encoding] [--recycle-mona]
+ *                       [--family-parameters name=value,...] [--curves FILE]
+ *
+ * The manifest lists one benchmark per line: `name path_a [path_b]`.
+ * Empty lines and lines starting with '#' are ignored. Binary operations
+ * use `path_a` as the second operand when `path_b` is missing.
+ *
+ * With --sweep, the benchmarks are generated instead (see automata-families.hh): one benchmark
+ * `FAMILY:NAME=V` per value V of the swept parameter, with the other parameters given by
+ * --family-parameters. The second operand is generated with the next seed. Besides the rows, one
+ * curve point is written per (value, operation, backend) to --curves (standard error by default):
+ * the median times and the maximum memory over the repetitions.
+ *
+ * Each operation of the README table is run on every backend that supports it.
+ * One row is written per (benchmark, operation, backend, repetition); warmup runs are not reported.
+ *
+ * With --conversion-cache, conversions between Mata and MONA go through a cache of the given
+ * capacity and its counters are written to standard error at the end of the run.
+ * With --threads, conversions between Mata and MONA use the given number of threads.
+ * With --optimize-encoding, MONA operands share an encoding searched for once per benchmark
+ * (see Nfa::optimize_alphabet_encoding) instead of the sorted order of symbols; the search is not measured.
+ * With --recycle-mona, MONA storage freed by one operation is reused by the next ones (see MonaRecyclingScope).
+ * When built with MAMONATA_MONA_ALLOCATOR, counters of the MONA allocator are written to standard error at the end.
+ * When built with COUNTERS_ENABLED, every row also has the counts (see Counters) of the measured
+ * conversions and the operation, one column per counter. The harness then also replaces the global
+ * operator new to count heap allocations (heap_allocations) of the running thread.
+ */
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <new>
+#include <optional>
+#include <set>
+#include <sstream>
+#include "mata-bridge/nfa.hh"
+#include "mona-bridge/nfa.hh"
+#include "mona-bridge/allocator.hh"
+#include "mona-bridge/conversion-cache.hh"
+#include "memory-tracker.hh"
+#include "timer.hh"
+#include "automata-families.hh"
+
+#ifdef COUNTERS_ENABLED
+// Counts every heap allocation of the calling thread, so the Timer attributes them to the measured operation.
+// The other forms of operator new and delete forward to these by default.
+void* operator new(const size_t size) {
+    COUNT(HEAP_ALLOCATIONS, 1);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+using MataNfa = mamonata::mata::nfa::Nfa;
+using MonaNfa = mamonata::mona::nfa::Nfa;
+using SymbolVector = mamonata::mata::nfa::SymbolVector;
+
+namespace {
+
+// Single benchmark from the manifest or of a sweep.
+struct Benchmark {
+    std::string name;
+    std::string path_a;
+    std::string path_b;
+    // Generated benchmarks of a sweep have a family instead of paths.
+    std::string family;
+    mamonata::bench::FamilyParameters parameters;
+    std::string parameter;  // Swept parameter.
+    std::string value;      // Value of the swept parameter.
+};
+
+// Parsed operands of a benchmark shared by all repetitions.
+struct Operands {
+    MataNfa a;
+    MataNfa b;
+    SymbolVector alphabet;  // Union of symbols used by both operands.
+    mamonata::mona::nfa::AlphabetEncodingPtr encoding;  // Encoding of the alphabet shared by MONA operands.
+};
+
+// Measurement of one repetition of one operation on one backend.
+struct Measurement {
+    std::string benchmark;
+    std::string operation;
+    std::string backend;
+    size_t repetition = 0;
+    Timer::nanoseconds operation_ns = 0;    // Time of the operation itself.
+    Timer::nanoseconds from_mata_ns = 0;    // Conversion of operands to MONA.
+    Timer::nanoseconds determinize_ns = 0;  // Projection of nondeterminism bits of MONA operands.
+    Timer::nanoseconds to_mata_ns = 0;      // Conversion of the MONA result back to Mata.
+    size_t result_states = 0;
+    size_t result_bytes = 0;         // Estimated memory held by the result (memory_footprint()).
+    size_t operation_peak_kb = 0;    // Growth of the peak resident set size during the operation.
+    long peak_rss_kb = 0;
+    Counters::Values counters{};     // Counts of the conversions and the operation.
+};
+
+struct Options {
+    std::string manifest;
+    size_t repetitions = 5;
+    size_t warmup = 1;
+    std::vector<std::string> operations;
+    std::string format = "csv";
+    std::string output;
+    size_t conversion_cache_bytes = 0;
+    size_t num_of_threads = 1;
+    bool optimize_encoding = false;
+    bool recycle_mona = false;
+    std::string sweep_family;
+    std::string sweep_parameter;
+    std::vector<std::string> sweep_values;
+    mamonata::bench::FamilyParameters family_parameters;
+    std::string curves;
+};
+
+// Operations of the README table with the backends supporting them.
+const std::vector<std::pair<std::string, std::vector<std::string>>> OPERATIONS = {
+    { "trim", { "mata" } },
+    { "remove_epsilon", { "mata" } },
+    { "revert", { "mata" } },
+    { "minimize_brzozowski", { "mata" } },
+    { "minimize_hopcroft", { "mata", "mona" } },
+    { "minimize", { "mona" } },
+    { "reduce_simulation", { "mata", "mona" } },
+    { "reduce_residual", { "mata", "mona" } },
+    { "concatenate", { "mata" } },
+    { "union_nondet", { "mata" } },
+    { "union_det_complete", { "mata", "mona" } },
+    { "determinize", { "mata", "mona" } },
+    { "intersection", { "mata", "mona" } },
+    { "complement_classical", { "mata" } },
+    { "complement_brzozowski", { "mata" } },
+    { "complement", { "mona" } },
+};
+
+// Returns the peak resident set size of the process in kilobytes. The operation scopes reset the
+// peak that ru_maxrss reports, so it is taken from PeakMemoryTracker, which keeps it across resets.
+long get_peak_rss_kb() {
+    return static_cast<long>(PeakMemoryTracker::get_process_peak_rss_bytes() / 1024);
+}
+
+/**
+ * Returns the duration recorded by the library for the operation,
+ * or the duration measured by the harness if the library is built without timing.
+ */
+Timer::nanoseconds get_operation_time(const std::string& label, const Timer::nanoseconds measured) {
+    try {
+        return Timer::get_nanoseconds(label);
+    } catch (const std::runtime_error&) {
+        return measured;
+    }
+}
+
+// Makes a deterministic complete automaton accepting the same language (used for union_det_complete operands).
+MataNfa make_det_complete(MataNfa aut, const SymbolVector& alphabet) {
+    // Classical complement yields a complete DFA, so complementing twice keeps the language.
+    return aut.complement_classical(alphabet).complement_classical(alphabet);
+}
+
+std::optional<Measurement> run_mata(const std::string& operation, const Operands& operands) {
+    static const std::map<std::string, std::function<void(MataNfa&, const MataNfa&, const SymbolVector&)>> mata_operations = {
+        { "trim", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.trim(); } },
+        { "remove_epsilon", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.remove_epsilon(); } },
+        { "revert", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.revert(); } },
+        { "minimize_brzozowski", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.minimize_brzozowski(); } },
+        { "minimize_hopcroft", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.minimize_hopcroft(); } },
+        { "reduce_simulation", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.reduce_simulation(); } },
+        { "reduce_residual", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.reduce_residual("with", "forward"); } },
+        { "concatenate", [](MataNfa& a, const MataNfa& b, const SymbolVector&) { a.concatenate(b); } },
+        { "union_nondet", [](MataNfa& a, const MataNfa& b, const SymbolVector&) { a.union_nondet(b); } },
+        { "union_det_complete", [](MataNfa& a, const MataNfa& b, const SymbolVector&) { a.union_det_complete(b); } },
+        { "determinize", [](MataNfa& a, const MataNfa&, const SymbolVector&) { a.determinize(); } },
+        { "intersection", [](MataNfa& a, const MataNfa& b, const SymbolVector&) { a.intersection(b); } },
+        { "complement_classical", [](MataNfa& a, const MataNfa&, const SymbolVector& symbols) { a.complement_classical(symbols); } },
+        { "complement_brzozowski", [](MataNfa& a, const MataNfa&, const SymbolVector& symbols) { a.complement_brzozowski(symbols); } },
+    };
+
+    auto it = mata_operations.find(operation);
+    if (it == mata_operations.end()) {
+        return std::nullopt;
+    }
+
+    // Prepare operands outside of the measurement.
+    MataNfa a = operands.a;
+    MataNfa b = operands.b;
+    if (operation == "union_det_complete") {
+        a = make_det_complete(std::move(a), operands.alphabet);
+        b = make_det_complete(std::move(b), operands.alphabet);
+    }
+
+    Measurement measurement;
+    Timer::reset();
+    // The library records the operation itself nested under this span.
+    PeakMemoryTracker::Scope memory_scope;
+    Timer::Span span("bench_operation");
+    it->second(a, b, operands.alphabet);
+    const Timer::nanoseconds measured = span.stop();
+    memory_scope.stop();
+    measurement.operation_ns = get_operation_time(operation, measured);
+    measurement.operation_peak_kb = memory_scope.get_peak_increase_bytes() / 1024;
+    measurement.counters = Timer::get_counters("bench_operation");
+    measurement.result_states = a.num_of_states();
+    measurement.result_bytes = a.memory_footprint();
+    return measurement;
+}
+
+std::optional<Measurement> run_mona(const std::string& operation, const Operands& operands, const size_t num_of_threads) {
+    // The second operand is converted only for binary operations.
+    struct MonaOperation {
+        bool is_binary;
+        std::function<void(MonaNfa&, const MonaNfa&)> run;
+    };
+    static const std::map<std::string, MonaOperation> mona_operations = {
+        { "minimize", { false, [](MonaNfa& a, const MonaNfa&) { a.minimize(); } } },
+        { "minimize_hopcroft", { false, [](MonaNfa& a, const MonaNfa&) { a.minimize_hopcroft(); } } },
+        { "union_det_complete", { true, [](MonaNfa& a, const MonaNfa& b) { a.union_det_complete(b); } } },
+        { "reduce_simulation", { false, [](MonaNfa& a, const MonaNfa&) { a.reduce_simulation(); } } },
+        { "reduce_residual", { false, [](MonaNfa& a, const MonaNfa&) { a.reduce_residual(); } } },
+        { "determinize", { false, [](MonaNfa& a, const MonaNfa&) { a.determinize(); } } },
+        { "intersection", { true, [](MonaNfa& a, const MonaNfa& b) { a.intersection(b); } } },
+        { "complement", { false, [](MonaNfa& a, const MonaNfa&) { a.complement(); } } },
+    };
+
+    auto it = mona_operations.find(operation);
+    if (it == mona_operations.end()) {
+        return std::nullopt;
+    }
+
+    Measurement measurement;
+    Timer::reset();
+
+    // Convert operands with a shared alphabet encoding.
+    Timer::Span from_mata_span("bench_from_mata");
+    const bool is_binary = it->second.is_binary;
+    MonaNfa a(operands.a, operands.encoding, num_of_threads);
+    MonaNfa b = is_binary ? MonaNfa(operands.b, operands.encoding, num_of_threads) : MonaNfa();
+    measurement.from_mata_ns = from_mata_span.stop();
+    Counters::accumulate(measurement.counters, Timer::get_counters("bench_from_mata"));
+
+    // Project out nondeterminism bits unless the operation is the projection itself, reduces the NFA before it
+    // or, like reduce_residual, determinizes by itself.
+    if (operation != "determinize" && operation != "reduce_simulation" && operation != "reduce_residual") {
+        std::vector<MonaNfa*> converted{ &a };
+        if (is_binary) {
+            converted.push_back(&b);
+        }
+        for (MonaNfa* operand : converted) {
+            if (!operand->is_deterministic()) {
+                Timer::Span determinize_span("bench_determinize");
+                operand->determinize();
+                measurement.determinize_ns += determinize_span.stop();
+                Counters::accumulate(measurement.counters, Timer::get_counters("bench_determinize"));
+            }
+        }
+    }
+
+    PeakMemoryTracker::Scope memory_scope;
+    Timer::Span span("bench_operation");
+    it->second.run(a, b);
+    const Timer::nanoseconds measured = span.stop();
+    memory_scope.stop();
+    measurement.operation_ns = get_operation_time(operation, measured);
+    measurement.operation_peak_kb = memory_scope.get_peak_increase_bytes() / 1024;
+    Counters::accumulate(measurement.counters, Timer::get_counters("bench_operation"));
+    measurement.result_states = a.num_of_states();
+    measurement.result_bytes = a.memory_footprint();
+
+    Timer::Span to_mata_span("bench_to_mata");
+    MataNfa result = a.to_mata(num_of_threads);
+    measurement.to_mata_ns = to_mata_span.stop();
+    Counters::accumulate(measurement.counters, Timer::get_counters("bench_to_mata"));
+
+    return measurement;
+}
+
+std::vector<Benchmark> read_manifest(const std::string& manifest_path) {
+    std::ifstream ifs(manifest_path);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Could not open manifest: " + manifest_path);
+    }
+
+    std::vector<Benchmark> benchmarks;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(line);
+        Benchmark benchmark;
+        if (!(iss >> benchmark.name) || benchmark.name[0] == '#') {
+            continue;
+        }
+        if (!(iss >> benchmark.path_a)) {
+            throw std::runtime_error("Missing automaton path for benchmark: " + benchmark.name);
+        }
+        if (!(iss >> benchmark.path_b)) {
+            benchmark.path_b = benchmark.path_a;
+        }
+        benchmarks.push_back(std::move(benchmark));
+    }
+    return benchmarks;
+}
+
+Options parse_options(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next_value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for option: " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--manifest") {
+            options.manifest = next_value();
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::stoul(next_value());
+        } else if (arg == "--warmup") {
+            options.warmup = std::stoul(next_value());
+        } else if (arg == "--operations") {
+            std::istringstream iss(next_value());
+            std::string operation;
+            while (std::getline(iss, operation, ',')) {
+                options.operations.push_back(operation);
+            }
+        } else if (arg == "--format") {
+            options.format = next_value();
+        } else if (arg == "--output") {
+            options.output = next_value();
+        } else if (arg == "--conversion-cache") {
+            options.conversion_cache_bytes = std::stoul(next_value());
+        } else if (arg == "--threads") {
+            options.num_of_threads = std::stoul(next_value());
+        } else if (arg == "--optimize-encoding") {
+            options.optimize_encoding = true;
+        } else if (arg == "--recycle-mona") {
+            options.recycle_mona = true;
+        } else if (arg == "--sweep") {
+            const std::string sweep = next_value();
+            const size_t family_end = sweep.find(':');
+            const size_t parameter_end = sweep.find('=', family_end);
+            if (family_end == std::string::npos || parameter_end == std::string::npos) {
+                throw std::runtime_error("Expected --sweep FAMILY:NAME=V1,V2,...: " + sweep);
+            }
+            options.sweep_family = sweep.substr(0, family_end);
+            options.sweep_parameter = sweep.substr(family_end + 1, parameter_end - family_end - 1);
+            std::istringstream iss(sweep.substr(parameter_end + 1));
+            std::string value;
+            while (std::getline(iss, value, ',')) {
+                options.sweep_values.push_back(value);
+            }
+        } else if (arg == "--family-parameters") {
+            mamonata::bench::set_family_parameters(options.family_parameters, next_value());
+        } else if (arg == "--curves") {
+            options.curves = next_value();
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+
+    if (options.manifest.empty() == options.sweep_family.empty()) {
+        throw std::runtime_error("Usage: mamonata-bench (--manifest FILE | --sweep FAMILY:NAME=V1,V2,...) [--repetitions N] [--warmup N] "
+                                 "[--operations op1,op2,...] [--format csv|json] [--output FILE] "
+                                 "[--conversion-cache BYTES] [--threads N] [--optimize-encoding] [--recycle-mona] "
+                                 "[--family-parameters name=value,...] [--curves FILE]");
+    }
+    if (options.format != "csv" && options.format != "json") {
+        throw std::runtime_error("Unknown output format: " + options.format);
+    }
+    return options;
+}
+
+// Makes one benchmark per value of the swept parameter.
+std::vector<Benchmark> make_sweep(const Options& options) {
+    std::vector<Benchmark> benchmarks;
+    for (const std::string& value : options.sweep_values) {
+        Benchmark benchmark;
+        benchmark.name = options.sweep_family + ":" + options.sweep_parameter + "=" + value;
+        benchmark.family = options.sweep_family;
+        benchmark.parameters = options.family_parameters;
+        mamonata::bench::set_family_parameter(benchmark.parameters, options.sweep_parameter, value);
+        benchmark.parameter = options.sweep_parameter;
+        benchmark.value = value;
+        benchmarks.push_back(std::move(benchmark));
+    }
+    return benchmarks;
+}
+
+// Loads or generates the operands of a benchmark.
+void prepare_operands(const Benchmark& benchmark, Operands& operands) {
+    if (benchmark.family.empty()) {
+        operands.a.load(benchmark.path_a);
+        operands.b.load(benchmark.path_b);
+        return;
+    }
+    mamonata::bench::FamilyParameters parameters = benchmark.parameters;
+    operands.a = mamonata::bench::generate_family(benchmark.family, parameters);
+    ++parameters.seed;
+    operands.b = mamonata::bench::generate_family(benchmark.family, parameters);
+}
+
+template<typename T>
+T get_median(std::vector<T> values) {
+    if (values.empty()) {
+        return T{};
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+// Writes one CSV point of the scaling curves per (value, operation, backend) of a sweep.
+class CurveWriter {
+    std::ostream& os;
+
+public:
+    explicit CurveWriter(std::ostream& os) : os(os) {
+        os << "family,parameter,value,operation,backend,input_states,input_transitions,repetitions,"
+              "median_operation_ns,median_total_ns,max_operation_peak_kb,max_result_bytes,result_states,peak_rss_kb\n";
+    }
+
+    void write(const Benchmark& benchmark, const Operands& operands, const std::vector<Measurement>& measurements) {
+        if (measurements.empty()) {
+            return;
+        }
+        std::vector<Timer::nanoseconds> operation_ns;
+        std::vector<Timer::nanoseconds> total_ns;
+        size_t max_operation_peak_kb = 0;
+        size_t max_result_bytes = 0;
+        for (const Measurement& m : measurements) {
+            operation_ns.push_back(m.operation_ns);
+            total_ns.push_back(m.from_mata_ns + m.determinize_ns + m.operation_ns + m.to_mata_ns);
+            max_operation_peak_kb = std::max(max_operation_peak_kb, m.operation_peak_kb);
+            max_result_bytes = std::max(max_result_bytes, m.result_bytes);
+        }
+        const Measurement& last = measurements.back();
+        os << benchmark.family << "," << benchmark.parameter << "," << benchmark.value << ","
+           << last.operation << "," << last.backend << "," << operands.a.num_of_states() << ","
+           << operands.a.num_of_transitions() << "," << measurements.size() << ","
+           << get_median(operation_ns) << "," << get_median(total_ns) << ","
+           << max_operation_peak_kb << "," << max_result_bytes << "," << last.result_states << "," << last.peak_rss_kb << "\n";
+        os.flush();
+    }
+};
+
+// Writes measurements as CSV or JSON rows, flushing after every row.
+class Writer {
+    std::ostream& os;
+    std::string format;
+    bool first = true;
+
+public:
+    Writer(std::ostream& os, std::string format) : os(os), format(std::move(format)) {
+        if (this->format == "csv") {
+            os << "benchmark,operation,backend,repetition,operation_ns,from_mata_ns,determinize_ns,to_mata_ns,result_states,result_bytes,operation_peak_kb,peak_rss_kb";
+            if constexpr (Counters::ENABLED) {
+                for (const std::string_view name : Counters::NAMES) {
+                    os << "," << name;
+                }
+            }
+            os << "\n";
+        } else {
+            os << "[";
+        }
+    }
+
+    ~Writer() {
+        if (format == "json") {
+            os << "\n]\n";
+        }
+    }
+
+    void write(const Measurement& m) {
+        if (format == "csv") {
+            os << m.benchmark << "," << m.operation << "," << m.backend << "," << m.repetition << ","
+               << m.operation_ns << "," << m.from_mata_ns << "," << m.determinize_ns << "," << m.to_mata_ns << ","
+               << m.result_states << "," << m.result_bytes << "," << m.operation_peak_kb << "," << m.peak_rss_kb;
+            if constexpr (Counters::ENABLED) {
+                for (const uint64_t count : m.counters) {
+                    os << "," << count;
+                }
+            }
+            os << "\n";
+        } else {
+            os << (first ? "\n" : ",\n");
+            os << "  {\"benchmark\": \"" << m.benchmark << "\", \"operation\": \"" << m.operation
+               << "\", \"backend\": \"" << m.backend << "\", \"repetition\": " << m.repetition
+               << ", \"operation_ns\": " << m.operation_ns << ", \"from_mata_ns\": " << m.from_mata_ns
+               << ", \"determinize_ns\": " << m.determinize_ns << ", \"to_mata_ns\": " << m.to_mata_ns
+               << ", \"result_states\": " << m.result_states << ", \"result_bytes\": " << m.result_bytes
+               << ", \"operation_peak_kb\": " << m.operation_peak_kb << ", \"peak_rss_kb\": " << m.peak_rss_kb;
+            if constexpr (Counters::ENABLED) {
+                for (size_t counter = 0; counter < Counters::NUM_OF_COUNTERS; ++counter) {
+                    os << ", \"" << Counters::NAMES[counter] << "\": " << m.counters[counter];
+                }
+            }
+            os << "}";
+        }
+        first = false;
+        os.flush();
+    }
+};
+
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        const Options options = parse_options(argc, argv);
+        const std::vector<Benchmark> benchmarks = options.sweep_family.empty() ? read_manifest(options.manifest) : make_sweep(options);
+
+        std::ofstream ofs;
+        if (!options.output.empty()) {
+            ofs.open(options.output);
+            if (!ofs.is_open()) {
+                throw std::runtime_error("Could not open output file: " + options.output);
+            }
+        }
+        Writer writer(options.output.empty() ? std::cout : ofs, options.format);
+        std::ofstream curves_ofs;
+        std::optional<CurveWriter> curve_writer;
+        if (!options.sweep_family.empty()) {
+            if (!options.curves.empty()) {
+                curves_ofs.open(options.curves);
+                if (!curves_ofs.is_open()) {
+                    throw std::runtime_error("Could not open curves file: " + options.curves);
+                }
+            }
+            curve_writer.emplace(options.curves.empty() ? std::cerr : curves_ofs);
+        }
+        mamonata::mona::nfa::ConversionCache::instance().set_capacity(options.conversion_cache_bytes);
+        std::optional<mamonata::mona::MonaRecyclingScope> recycling;
+        if (options.recycle_mona) {
+            recycling.emplace();
+        }
+
+        for (const Benchmark& benchmark : benchmarks) {
+            // Parse or generate operands once; this is not part of the measurements.
+            Operands operands;
+            prepare_operands(benchmark, operands);
+            std::set<mamonata::mata::nfa::Symbol> symbols;
+            for (const MataNfa* operand : { &operands.a, &operands.b }) {
+                for (const auto symbol : operand->get_used_symbols()) {
+                    symbols.insert(symbol);
+                }
+            }
+            operands.alphabet.assign(symbols.begin(), symbols.end());
+            operands.encoding = options.optimize_encoding
+                ? MonaNfa::optimize_alphabet_encoding({ &operands.a, &operands.b }, operands.alphabet)
+                : MonaNfa::make_alphabet_encoding(operands.alphabet);
+
+            for (const auto& [operation, backends] : OPERATIONS) {
+                if (!options.operations.empty() &&
+                    std::find(options.operations.begin(), options.operations.end(), operation) == options.operations.end()) {
+                    continue;
+                }
+
+                for (const std::string& backend : backends) {
+                    auto run = [&]() {
+                        return (backend == "mata") ? run_mata(operation, operands) : run_mona(operation, operands, options.num_of_threads);
+                    };
+
+                    for (size_t i = 0; i < options.warmup; ++i) {
+                        run();
+                    }
+                    std::vector<Measurement> measurements;
+                    for (size_t repetition = 0; repetition < options.repetitions; ++repetition) {
+                        std::optional<Measurement> measurement = run();
+                        if (!measurement.has_value()) {
+                            continue;
+                        }
+                        measurement->benchmark = benchmark.name;
+                        measurement->operation = operation;
+                        measurement->backend = backend;
+                        measurement->repetition = repetition;
+                        measurement->peak_rss_kb = get_peak_rss_kb();
+                        writer.write(*measurement);
+                        measurements.push_back(std::move(*measurement));
+                    }
+                    if (curve_writer.has_value()) {
+                        curve_writer->write(benchmark, operands, measurements);
+                    }
+                }
+            }
+        }
+
+        if (options.conversion_cache_bytes > 0) {
+            mamonata::mona::nfa::ConversionCache::instance().export_csv(std::cerr);
+        }
+        if (mamonata::mona::MonaAllocator::is_enabled()) {
+            mamonata::mona::MonaAllocator::instance().export_csv(std::cerr);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
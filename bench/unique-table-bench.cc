@@ -0,0 +1,269 @@
+/**
+ * @file unique-table-bench.cc
+ * @brief Micro-benchmark of the unique tables of MtRobdd and ArenaMtRobdd.
+ *
+ * Usage: unique-table-bench [--vars N] [--nodes-per-level N] [--terminals N] [--seed N]
+ *
+ * Builds the same random layered diagram by create_node() in both MTROBDD implementations
+ * (every level has the given number of nodes with children on the level below) and then
+ * creates every node again, so every call hits the unique table. One CSV row is written per
+ * table with the probe lengths of the stored nodes and the time per insertion and per hit.
+ *
+ * For comparison, the nodes of MtRobdd are also hashed by the former NodePtrHash (XOR of the
+ * field hashes shifted by 1-3 bits) into a linear-probing table of the same capacity and into
+ * std::unordered_set; for the chained sets, the probe length of a node is its position in its bucket.
+ */
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "arena-mtrobdd.hh"
+#include "mtrobdd.hh"
+
+using namespace mamonata::mtrobdd;
+
+namespace {
+
+struct Options {
+    size_t num_of_vars = 24;
+    size_t nodes_per_level = 4096;
+    size_t num_of_terminals = 16;
+    uint64_t seed = 1;
+};
+
+// Hash of MtRobdd nodes before the fields were mixed, kept for comparison.
+struct LegacyNodePtrHash {
+    size_t operator()(const MtBddNodePtr& node) const {
+        size_t h1 = std::hash<VarIndex>()(node->var_index);
+        size_t h2 = std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(node->low.get()));
+        size_t h3 = std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(node->high.get()));
+        size_t h4 = std::hash<NodeValue>()(node->value);
+        return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3);
+    }
+};
+
+// Node of the random diagram: variable and positions of the children on the level below.
+struct NodeSpec {
+    VarIndex var_index;
+    size_t low;
+    size_t high;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double nanoseconds_per_call(const Clock::time_point start, const Clock::time_point end, const size_t num_of_calls) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) /
+           static_cast<double>(std::max<size_t>(1, num_of_calls));
+}
+
+void write_row(const std::string& table, const std::string& hash, const ProbeStatistics& statistics,
+               const double insert_ns, const double lookup_ns) {
+    std::cout << table << "," << hash << "," << statistics.num_of_keys << "," << statistics.capacity << ","
+              << statistics.mean_probe_length << "," << statistics.max_probe_length << ","
+              << insert_ns << "," << lookup_ns << "\n";
+}
+
+// Inserts the hashes into a linear-probing table of the given capacity (a power of two) and returns the probe lengths.
+ProbeStatistics simulate_linear_probing(const std::vector<size_t>& hashes, const size_t capacity) {
+    ProbeStatistics statistics;
+    statistics.num_of_keys = hashes.size();
+    statistics.capacity = capacity;
+    std::vector<bool> occupied(capacity, false);
+    const size_t mask = capacity - 1;
+    size_t total = 0;
+    for (const size_t hash : hashes) {
+        size_t slot = hash & mask;
+        size_t length = 1;
+        while (occupied[slot]) {
+            slot = (slot + 1) & mask;
+            ++length;
+        }
+        occupied[slot] = true;
+        total += length;
+        statistics.max_probe_length = std::max(statistics.max_probe_length, length);
+    }
+    statistics.mean_probe_length = hashes.empty() ? 0 : static_cast<double>(total) / static_cast<double>(hashes.size());
+    return statistics;
+}
+
+// Returns the positions of the nodes in the bucket chains of a std::unordered_set.
+template<typename Set>
+ProbeStatistics get_chain_statistics(const Set& set) {
+    ProbeStatistics statistics;
+    statistics.num_of_keys = set.size();
+    statistics.capacity = set.bucket_count();
+    size_t total = 0;
+    for (size_t bucket = 0; bucket < set.bucket_count(); ++bucket) {
+        const size_t length = set.bucket_size(bucket);
+        total += length * (length + 1) / 2;
+        statistics.max_probe_length = std::max(statistics.max_probe_length, length);
+    }
+    statistics.mean_probe_length = set.empty() ? 0 : static_cast<double>(total) / static_cast<double>(set.size());
+    return statistics;
+}
+
+template<typename Hash>
+void bench_unordered_set(const std::string& hash_name, const std::vector<MtBddNodePtr>& nodes) {
+    std::unordered_set<MtBddNodePtr, Hash, NodePtrEqual> set;
+    const auto insert_start = Clock::now();
+    for (const MtBddNodePtr& node : nodes) {
+        set.insert(node);
+    }
+    const auto insert_end = Clock::now();
+    size_t found = 0;
+    for (const MtBddNodePtr& node : nodes) {
+        // Look up an equal copy, as create_node() does.
+        found += set.count(std::make_shared<MtBddNode>(*node));
+    }
+    const auto lookup_end = Clock::now();
+    if (found != nodes.size()) {
+        throw std::runtime_error("unordered_set lost nodes.");
+    }
+    write_row("unordered_set", hash_name, get_chain_statistics(set),
+              nanoseconds_per_call(insert_start, insert_end, nodes.size()),
+              nanoseconds_per_call(insert_end, lookup_end, nodes.size()));
+}
+
+Options parse_options(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next_value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for option: " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--vars") {
+            options.num_of_vars = std::stoul(next_value());
+        } else if (arg == "--nodes-per-level") {
+            options.nodes_per_level = std::stoul(next_value());
+        } else if (arg == "--terminals") {
+            options.num_of_terminals = std::stoul(next_value());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(next_value());
+        } else {
+            throw std::runtime_error("Usage: unique-table-bench [--vars N] [--nodes-per-level N] [--terminals N] [--seed N]");
+        }
+    }
+    if (options.num_of_vars == 0 || options.nodes_per_level == 0 || options.num_of_terminals < 2) {
+        throw std::runtime_error("The diagram needs at least one variable, one node per level and two terminals.");
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        const Options options = parse_options(argc, argv);
+
+        // Random layered diagram from the last variable up; level 0 holds the terminals.
+        std::mt19937_64 rng(options.seed);
+        std::vector<std::vector<NodeSpec>> levels(options.num_of_vars + 1);
+        for (size_t level = 1; level <= options.num_of_vars; ++level) {
+            const size_t below = (level == 1) ? options.num_of_terminals : options.nodes_per_level;
+            const VarIndex var_index = static_cast<VarIndex>(options.num_of_vars - level);
+            for (size_t i = 0; i < options.nodes_per_level; ++i) {
+                const size_t low = rng() % below;
+                size_t high = rng() % (below - 1);
+                high += (high >= low);
+                levels[level].push_back({ var_index, low, high });
+            }
+        }
+        size_t num_of_calls = options.num_of_terminals;
+        for (const std::vector<NodeSpec>& level : levels) {
+            num_of_calls += level.size();
+        }
+
+        std::cout << "table,hash,nodes,capacity,mean_probe_length,max_probe_length,insert_ns,lookup_ns\n";
+
+        // MtRobdd: nodes compared by their fields in the open-addressing NodeTable.
+        MtRobdd mtrobdd(options.num_of_vars);
+        std::vector<MtBddNodePtr> all_nodes;
+        auto build_mtrobdd = [&]() {
+            std::vector<MtBddNodePtr> below;
+            for (NodeValue value = 0; value < options.num_of_terminals; ++value) {
+                below.push_back(mtrobdd.create_node(TERMINAL_INDEX, nullptr, nullptr, value));
+            }
+            all_nodes = below;
+            for (size_t level = 1; level <= options.num_of_vars; ++level) {
+                std::vector<MtBddNodePtr> current;
+                current.reserve(levels[level].size());
+                for (const NodeSpec& spec : levels[level]) {
+                    current.push_back(mtrobdd.create_node(spec.var_index, below[spec.low], below[spec.high]));
+                }
+                all_nodes.insert(all_nodes.end(), current.begin(), current.end());
+                below = std::move(current);
+            }
+        };
+        const auto mtrobdd_start = Clock::now();
+        build_mtrobdd();
+        const auto mtrobdd_built = Clock::now();
+        const size_t mtrobdd_nodes = mtrobdd.get_num_of_nodes();
+        build_mtrobdd();
+        const auto mtrobdd_hit = Clock::now();
+        if (mtrobdd.get_num_of_nodes() != mtrobdd_nodes) {
+            throw std::runtime_error("MtRobdd created duplicate nodes.");
+        }
+        write_row("NodeTable", "mixed", mtrobdd.get_unique_table_statistics(),
+                  nanoseconds_per_call(mtrobdd_start, mtrobdd_built, num_of_calls),
+                  nanoseconds_per_call(mtrobdd_built, mtrobdd_hit, num_of_calls));
+
+        // ArenaMtRobdd: node ids in its open-addressing unique table.
+        ArenaMtRobdd arena(options.num_of_vars);
+        auto build_arena = [&]() {
+            std::vector<NodeId> below;
+            for (NodeValue value = 0; value < options.num_of_terminals; ++value) {
+                below.push_back(arena.create_terminal_node(value));
+            }
+            for (size_t level = 1; level <= options.num_of_vars; ++level) {
+                std::vector<NodeId> current;
+                current.reserve(levels[level].size());
+                for (const NodeSpec& spec : levels[level]) {
+                    current.push_back(arena.create_node(spec.var_index, below[spec.low], below[spec.high]));
+                }
+                below = std::move(current);
+            }
+        };
+        const auto arena_start = Clock::now();
+        build_arena();
+        const auto arena_built = Clock::now();
+        const size_t arena_nodes = arena.get_num_of_nodes();
+        build_arena();
+        const auto arena_hit = Clock::now();
+        if (arena.get_num_of_nodes() != arena_nodes) {
+            throw std::runtime_error("ArenaMtRobdd created duplicate nodes.");
+        }
+        write_row("ArenaMtRobdd", "mixed", arena.get_unique_table_statistics(),
+                  nanoseconds_per_call(arena_start, arena_built, num_of_calls),
+                  nanoseconds_per_call(arena_built, arena_hit, num_of_calls));
+
+        // The former hash in a linear-probing table of the same capacity as NodeTable.
+        std::vector<MtBddNodePtr> unique_nodes;
+        std::unordered_set<const MtBddNode*> seen;
+        for (const MtBddNodePtr& node : all_nodes) {
+            if (seen.insert(node.get()).second) {
+                unique_nodes.push_back(node);
+            }
+        }
+        std::vector<size_t> legacy_hashes;
+        legacy_hashes.reserve(unique_nodes.size());
+        for (const MtBddNodePtr& node : unique_nodes) {
+            legacy_hashes.push_back(LegacyNodePtrHash()(node));
+        }
+        write_row("linear_probing", "legacy",
+                  simulate_linear_probing(legacy_hashes, mtrobdd.get_unique_table_statistics().capacity), 0, 0);
+
+        bench_unordered_set<LegacyNodePtrHash>("legacy", unique_nodes);
+        bench_unordered_set<NodePtrHash>("mixed", unique_nodes);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
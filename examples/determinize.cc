@@ -19,6 +19,10 @@ int main(int argc, char *argv[]) {
     MataNfa mata_nfa;
     mata_nfa.load(argv[1]);
     MonaNfa mona_nfa(mata_nfa);
+#ifdef DEBUG
+    MonaNfa reduced_nfa = mona_nfa.clone();
+    MonaNfa residual_nfa = mona_nfa.clone();
+#endif
 
     std::cerr << "Mata;Mona" << std::endl;
 
@@ -33,5 +37,14 @@ int main(int argc, char *argv[]) {
     assert(mona_nfa.is_deterministic());
     assert(mona_nfa.to_mata().are_equivalent(mata_nfa));
 
+#ifdef DEBUG
+    // Reduction by simulation preserves the language.
+    reduced_nfa.reduce_simulation().determinize();
+    assert(reduced_nfa.is_deterministic());
+    assert(reduced_nfa.to_mata().are_equivalent(mata_nfa));
+    residual_nfa.reduce_residual();
+    assert(residual_nfa.to_mata().are_equivalent(mata_nfa));
+#endif
+
     return 0;
 }
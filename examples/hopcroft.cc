@@ -24,12 +24,21 @@ int main(int argc, char *argv[]) {
         mona_nfa.determinize();
     }
 
-    std::cerr << "Mata;Mona-Det;Mona" << std::endl;
+    // MONA's minimization and the partition refinement over the MTROBDD run on the same DFA.
+    MonaNfa mona_hopcroft_nfa = mona_nfa.clone();
+
+    std::cerr << "Mata;Mona-Det;Mona;Mona-Hopcroft;Mona-Atoms;Mona-Refinement;Mona-Rebuild" << std::endl;
     mata_nfa.minimize_hopcroft();
     std::cerr << Timer::get("minimize_hopcroft") << ";";
     std::cerr << det_time << ";";
     mona_nfa.minimize();
-    std::cerr << Timer::get("minimize") << std::endl;
+    std::cerr << Timer::get("minimize") << ";";
+    mona_hopcroft_nfa.minimize_hopcroft();
+    std::cerr << Timer::get("minimize_hopcroft") << ";";
+    // Phases in microseconds.
+    std::cerr << Timer::get_statistics("atoms").total / 1000 << ";";
+    std::cerr << Timer::get_statistics("refinement").total / 1000 << ";";
+    std::cerr << Timer::get_statistics("rebuild").total / 1000 << std::endl;
 
     mona_nfa.print();
 
@@ -39,6 +48,7 @@ int main(int argc, char *argv[]) {
     assert(converted_mata_nfa.are_equivalent(minimized_mata_nfa));
     assert(converted_mata_nfa.num_of_states() == minimized_mata_nfa.num_of_states());
     assert(converted_mata_nfa.num_of_states() == mona_nfa.num_of_states());
+    assert(mona_hopcroft_nfa.num_of_states() == mona_nfa.num_of_states());
 #endif
 
     return 0;
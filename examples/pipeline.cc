@@ -0,0 +1,79 @@
+/**
+ * @file pipeline.cc
+ * @brief Example running the conversion and intersection of two NFAs as a pipeline.
+ * This example loads NFAs in Mata format. Both operands are loaded, converted to MONA and
+ * determinized concurrently with each other and with the intersection in Mata.
+ */
+#include "mata-bridge/nfa.hh"
+#include "mona-bridge/nfa.hh"
+#include "pipeline.hh"
+#include "timer.hh"
+#include <set>
+
+#ifndef TIMING_ENABLED
+#error "This example requires timing to be enabled. Please enable TIMING_ENABLED in CMake configuration."
+#endif
+
+using MataNfa = mamonata::mata::nfa::Nfa;
+using MonaNfa = mamonata::mona::nfa::Nfa;
+using mamonata::Pipeline;
+
+
+int main(int argc, char *argv[]) {
+    Pipeline pipeline;
+
+    auto load = [](const std::string path) {
+        return [path]() {
+            MataNfa nfa;
+            nfa.load(path);
+            return nfa;
+        };
+    };
+    auto mata_a = pipeline.add("load_a", load(argv[1]));
+    auto mata_b = pipeline.add("load_b", load(argv[2]));
+
+    // Both MONA automata share the encoding of all symbols used by either automaton.
+    auto encoding = pipeline.add("make_alphabet_encoding", [](MataNfa a, MataNfa b) {
+        std::set<mamonata::mata::nfa::Symbol> symbols;
+        for (const MataNfa* mata_nfa : { &a, &b }) {
+            for (const auto symbol : mata_nfa->get_used_symbols()) {
+                symbols.insert(symbol);
+            }
+        }
+        return MonaNfa::make_alphabet_encoding(mamonata::mona::nfa::MataSymbolVector(symbols.begin(), symbols.end()));
+    }, mata_a, mata_b);
+
+    auto to_mona = [](MataNfa mata_nfa, mamonata::mona::nfa::AlphabetEncodingPtr encoding) {
+        MonaNfa mona_nfa(mata_nfa, encoding);
+        if (!mona_nfa.is_deterministic()) {
+            mona_nfa.determinize();
+        }
+        return mona_nfa;
+    };
+    auto mona_a = pipeline.add_serial("to_mona_a", to_mona, mata_a, encoding);
+    auto mona_b = pipeline.add_serial("to_mona_b", to_mona, mata_b, encoding);
+
+    auto mona_intersection = pipeline.add_serial("mona_intersection", [](MonaNfa a, MonaNfa b) {
+        a.intersection(b);
+        return a;
+    }, mona_a, mona_b);
+    auto mona_result = pipeline.add_serial("to_mata", [](MonaNfa nfa) { return nfa.to_mata(); }, mona_intersection);
+    auto mata_result = pipeline.add("mata_intersection", [](MataNfa a, MataNfa b) {
+        a.intersection(b);
+        return a;
+    }, mata_a, mata_b);
+
+    std::shared_future<MataNfa> mona_future = pipeline.get_future(mona_result);
+    std::shared_future<MataNfa> mata_future = pipeline.get_future(mata_result);
+    pipeline.run();
+    pipeline.wait();
+
+    std::cerr << "Mata;Mona-Conv-Det;Mona" << std::endl;
+    std::cerr << Timer::get("mata_intersection") << ";";
+    std::cerr << Timer::get("to_mona_a") + Timer::get("to_mona_b") << ";";
+    std::cerr << Timer::get("mona_intersection") << std::endl;
+
+    assert(mona_future.get().are_equivalent(mata_future.get()));
+
+    return 0;
+}
@@ -2,6 +2,8 @@
  * @file to_mona_dot.cc
  * @brief Example program that converts a Mata NFA to MONA DOT format.
  */
+#include <cassert>
+#include <filesystem>
 #include "mata-bridge/nfa.hh"
 #include "mona-bridge/nfa.hh"
 
@@ -15,5 +17,16 @@ int main(int argc, char *argv[]) {
     MonaNfa mona(mata);
     mona.print();
 
+#ifdef DEBUG
+    // The binary format round-trips the automaton.
+    const std::filesystem::path binary_path = std::filesystem::temp_directory_path() / "to_mona.bin";
+    mona.save_binary(binary_path);
+    MonaNfa loaded;
+    loaded.load_binary(binary_path);
+    std::filesystem::remove(binary_path);
+    assert(loaded.num_of_states() == mona.num_of_states());
+    assert(loaded.to_mata().are_equivalent(mata));
+#endif
+
     return 0;
 }
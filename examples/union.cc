@@ -6,6 +6,7 @@
 #include "mata-bridge/nfa.hh"
 #include "mona-bridge/nfa.hh"
 #include "timer.hh"
+#include <set>
 
 #ifndef TIMING_ENABLED
 #error "This example requires timing to be enabled. Please enable TIMING_ENABLED in CMake configuration."
@@ -18,16 +19,26 @@ using MonaNfa = mamonata::mona::nfa::Nfa;
 int main(int argc, char *argv[]) {
     MataNfa mata_a;
     mata_a.load(argv[1]);
-    MonaNfa mona_a(mata_a);
+    MataNfa mata_b;
+    mata_b.load(argv[2]);
+
+    // Both MONA automata share the encoding of all symbols used by either automaton.
+    std::set<mamonata::mata::nfa::Symbol> symbols;
+    for (const MataNfa* mata_nfa : { &mata_a, &mata_b }) {
+        for (const auto symbol : mata_nfa->get_used_symbols()) {
+            symbols.insert(symbol);
+        }
+    }
+    const auto encoding = MonaNfa::make_alphabet_encoding(mamonata::mona::nfa::MataSymbolVector(symbols.begin(), symbols.end()));
+
+    MonaNfa mona_a(mata_a, encoding);
     Timer::microseconds det_time = 0;
     if (!mona_a.is_deterministic()) {
         mona_a.determinize();
         det_time += Timer::get("determinize");
     }
 
-    MataNfa mata_b;
-    mata_b.load(argv[2]);
-    MonaNfa mona_b(mata_b);
+    MonaNfa mona_b(mata_b, encoding);
     if (!mona_b.is_deterministic()) {
         mona_b.determinize();
         det_time += Timer::get("determinize");
@@ -37,7 +48,7 @@ int main(int argc, char *argv[]) {
     MataNfa mata_nfa = mata_a.union_nondet(mata_b);
     std::cerr << Timer::get("union_nondet") << ";";
     std::cerr << det_time << ";";
-    MonaNfa mona_nfa = mona_a.union_det_complete(mona_b);
+    MonaNfa& mona_nfa = mona_a.union_det_complete(std::move(mona_b));
     std::cerr << Timer::get("union_det_complete") << std::endl;
 
     mona_nfa.print();
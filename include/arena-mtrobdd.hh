@@ -0,0 +1,661 @@
+#ifndef MAMONATA_ARENA_MTROBDD_HH_
+#define MAMONATA_ARENA_MTROBDD_HH_
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "mtrobdd.hh"
+
+/**
+ * Arena-backed variant of the MaMONAta MTROBDD.
+ *
+ * Nodes are stored in a contiguous arena as a structure of arrays and are addressed
+ * by 32-bit node ids instead of shared pointers. Unique nodes are hash-consed
+ * in an open-addressing table keyed on (var_index, low, high, value).
+ *
+ * An MTROBDD may have a virtual sink (set_virtual_sink()): missing children and roots (NULL_NODE)
+ * then denote the terminal with the value of the virtual sink, which is never stored in the arena.
+ * Traversals and operations treat NULL_NODE as this terminal, and to_mona() creates
+ * a MONA leaf for it only if some path actually leads to the sink.
+ */
+namespace mamonata::mtrobdd
+{
+
+using NodeId = uint32_t;
+using NameToNodeIdMap = std::unordered_map<NodeName, NodeId>;
+// Full assignment of all variables packed into an integer (first variable is the most significant bit)
+// paired with the terminal value it leads to.
+using Minterm = std::pair<uint64_t, NodeValue>;
+
+static constexpr NodeId NULL_NODE = std::numeric_limits<NodeId>::max();
+
+// Multi-Terminal Reduced Ordered Binary Decision Diagram (MTROBDD) stored in an arena.
+class ArenaMtRobdd
+{
+    size_t num_of_vars;                 // Number of variables in the MTROBDD.
+    std::vector<VarIndex> var_indices;  // Variable index of each node; TERMINAL_INDEX for terminal nodes.
+    std::vector<NodeId> lows;           // LOW child of each node; NULL_NODE if missing.
+    std::vector<NodeId> highs;          // HIGH child of each node; NULL_NODE if missing.
+    std::vector<NodeValue> values;      // Value of each terminal node; MAX_NODE_VALUE for inner nodes.
+    std::vector<NodeId> unique_table;   // Open-addressing table of node ids; NULL_NODE marks an empty slot.
+    NameToNodeIdMap root_nodes_map;     // Map from root names to root nodes.
+    NodeValue virtual_sink_value = MAX_NODE_VALUE;  // Value denoted by NULL_NODE; MAX_NODE_VALUE if there is no virtual sink.
+
+    /**
+     * Computes the hash of a node key.
+     *
+     * @param var_index Variable index of the node.
+     * @param low LOW child of the node.
+     * @param high HIGH child of the node.
+     * @param value Value of the node.
+     *
+     * @return Hash of the node key.
+     */
+    static size_t hash_node(VarIndex var_index, NodeId low, NodeId high, NodeValue value) {
+        // Node ids have 32 bits, so the variable and a child share a word without losing bits.
+        uint64_t h = mix_hash((static_cast<uint64_t>(static_cast<uint32_t>(var_index)) << 32) | low);
+        h = combine_hash(h, high);
+        return static_cast<size_t>(combine_hash(h, value));
+    }
+
+    /**
+     * Finds the slot of a node key in the unique table.
+     *
+     * @return Index of the slot holding the node, or of the empty slot where it belongs.
+     */
+    size_t find_slot(VarIndex var_index, NodeId low, NodeId high, NodeValue value) const;
+
+    // Rebuilds the unique table from the arena, resizing it to fit all nodes.
+    void rebuild_unique_table();
+
+    /**
+     * Collects nodes reachable from the root nodes in post-order,
+     * i.e., every node appears after both of its children.
+     *
+     * @return Vector of reachable node ids in post-order.
+     */
+    std::vector<NodeId> get_reachable_post_order() const;
+
+    // Removes all nodes and roots while keeping the number of variables.
+    void clear_nodes();
+
+    /**
+     * Recursively builds the MTROBDD for a range of sorted minterms sharing the same prefix.
+     *
+     * @param var_index Variable index to branch on.
+     * @param begin First minterm of the range.
+     * @param end One past the last minterm of the range.
+     * @param default_node Terminal node for assignments not covered by the range.
+     *
+     * @return Id of the node representing the range.
+     */
+    NodeId build_from_minterms(VarIndex var_index, const Minterm* begin, const Minterm* end, NodeId default_node);
+
+    /**
+     * Builds the MTROBDD for a set of minterms over N variables from a flat table of all 2^N assignments.
+     * Levels are reduced bottom-up in place: entries 2i and 2i+1 differ only in the last remaining
+     * variable and are merged into entry i, so there is neither recursion nor a search in the minterms.
+     *
+     * @param minterms Minterms over N variables; each assignment must be unique.
+     * @param default_node Node for assignments not covered by the minterms.
+     *
+     * @return Id of the root of the created MTROBDD.
+     */
+    template<size_t N>
+    NodeId build_from_table(const std::vector<Minterm>& minterms, const NodeId default_node) {
+        std::array<NodeId, size_t{1} << N> table;
+        table.fill(default_node);
+        for (const auto& [assignment, value] : minterms) {
+            table[assignment] = create_terminal_node(value);
+        }
+        for (size_t var_index = N; var_index-- > 0;) {
+            for (size_t i = 0; i < (size_t{1} << var_index); ++i) {
+                table[i] = create_reduced_node(static_cast<VarIndex>(var_index), table[2 * i], table[2 * i + 1]);
+            }
+        }
+        return table[0];
+    }
+
+    // Checks if a node is a terminal node or the virtual sink.
+    bool is_leaf(const NodeId node) const {
+        return node == NULL_NODE || is_terminal(node);
+    }
+
+    // Returns the value of a terminal node or of the virtual sink.
+    NodeValue get_leaf_value(const NodeId node) const {
+        assert(node != NULL_NODE || has_virtual_sink());
+        return (node == NULL_NODE) ? virtual_sink_value : values[node];
+    }
+
+    // Creates a terminal node with a given value; the virtual sink is not stored.
+    NodeId create_leaf(const NodeValue value) {
+        return (has_virtual_sink() && value == virtual_sink_value) ? NULL_NODE : create_terminal_node(value);
+    }
+
+    // Returns the cofactors of a node with respect to a variable tested at or above it.
+    std::pair<NodeId, NodeId> get_cofactors(const NodeId node, const VarIndex var_index) const {
+        if (!is_leaf(node) && var_indices[node] == var_index) {
+            return { lows[node], highs[node] };
+        }
+        return { node, node };
+    }
+
+    // Returns the topmost variable tested by any of the nodes.
+    template<typename... Nodes>
+    VarIndex get_top_var_index(const Nodes... nodes) const {
+        VarIndex top = std::numeric_limits<VarIndex>::max();
+        ((top = is_leaf(nodes) ? top : std::min(top, var_indices[nodes])), ...);
+        return top;
+    }
+
+    // Creates an inner node unless both children are the same.
+    NodeId create_reduced_node(const VarIndex var_index, const NodeId low, const NodeId high) {
+        return (low == high) ? low : create_node(var_index, low, high);
+    }
+
+    /**
+     * Converts the MTROBDD to DOT format for visualization.
+     *
+     * @param os Output stream to write the DOT representation to.
+     */
+    void _print_as_dot(std::ostream& os) const;
+
+public:
+    // Maximum number of variables of MTROBDDs built by create_from_minterms from a flat table of all assignments.
+    static constexpr size_t MAX_TABLE_VARS = 8;
+
+    // Computed table of apply operations, mapping pairs of operand nodes to results.
+    // A table may be shared by several calls only if they use the same operation.
+    using ApplyTable = std::unordered_map<uint64_t, NodeId>;
+    // Computed table of unary operations, mapping operand nodes to results.
+    using UnaryTable = std::unordered_map<NodeId, NodeId>;
+
+    ArenaMtRobdd() : num_of_vars(0) {}
+
+    /**
+     * Constructor.
+     *
+     * @param num_of_vars Number of variables in the MTROBDD.
+     */
+    explicit ArenaMtRobdd(size_t num_of_vars) : num_of_vars(num_of_vars) {}
+
+    /**
+     * Constructor from MONA BDD manager.
+     *
+     * @param num_of_vars Number of variables in the MTROBDD.
+     * @param bddm Pointer to the MONA BDD manager to convert from.
+     * @param root_behavior_ptrs Array of root node pointers.
+     *                           Note: The caller is responsible for allocating and freeing this array.
+     * @param num_of_roots Number of root nodes.
+     */
+    explicit ArenaMtRobdd(size_t num_of_vars, bdd_manager* bddm, bdd_ptr *root_behavior_ptrs, size_t num_of_roots)
+        : num_of_vars(0) {
+        from_mona(num_of_vars, bddm, root_behavior_ptrs, num_of_roots);
+    }
+
+    /**
+     * Converts from MONA BDD manager to MTROBDD.
+     *
+     * @param num_of_vars Number of variables in the MTROBDD.
+     * @param bddm Pointer to the MONA BDD manager to convert from.
+     * @param root_behavior_ptrs Array of root node pointers.
+     *                           Note: The caller is responsible for allocating and freeing this array.
+     * @param num_of_roots Number of root nodes.
+     *
+     * @return this
+     */
+    ArenaMtRobdd& from_mona(size_t num_of_vars, bdd_manager* bddm, bdd_ptr *root_behavior_ptrs, size_t num_of_roots);
+
+    /**
+     * Converts the MTROBDD to MONA BDD manager.
+     * The manager may be sized by reserve_mona_nodes(bddm, get_num_of_nodes() + 1) before
+     * (one more node for the leaf of the virtual sink).
+     *
+     * @param bddm Pointer to the MONA BDD manager to convert to.
+     * @param root_behavior_ptrs Array to store root node pointers.
+     *                           Note: The caller is responsible for allocating and freeing this array.
+     */
+    void to_mona(bdd_manager* bddm, bdd_ptr* root_behavior_ptrs) const;
+
+    // Returns number of variables.
+    size_t get_num_of_vars() const {
+        return num_of_vars;
+    }
+
+    // Returns number of nodes stored in the arena.
+    size_t get_num_of_nodes() const {
+        return var_indices.size();
+    }
+
+    // Returns number of root nodes.
+    size_t get_num_of_roots() const {
+        return root_nodes_map.size();
+    }
+
+    /**
+     * Sets the value of the virtual sink: missing children and roots (NULL_NODE) lead to
+     * a terminal with this value, which is not stored in the arena.
+     *
+     * @param value Value of the virtual sink; MAX_NODE_VALUE removes the virtual sink.
+     */
+    void set_virtual_sink(const NodeValue value) {
+        virtual_sink_value = value;
+    }
+
+    // Checks if missing children and roots denote the virtual sink.
+    bool has_virtual_sink() const {
+        return virtual_sink_value != MAX_NODE_VALUE;
+    }
+
+    // Returns the value of the virtual sink; MAX_NODE_VALUE if there is none.
+    NodeValue get_virtual_sink() const {
+        return virtual_sink_value;
+    }
+
+    /**
+     * Checks if some root or reachable node leads to the virtual sink, i.e.,
+     * if MONA needs a sink state for the exported diagram.
+     *
+     * @return true if a root or a child of a reachable node is NULL_NODE.
+     */
+    bool uses_virtual_sink() const;
+
+    // Returns estimated memory in bytes held by the node arrays, the unique table and the root map.
+    size_t memory_footprint() const {
+        return sizeof(ArenaMtRobdd) + mamonata::memory::vector_footprint(var_indices) +
+               mamonata::memory::vector_footprint(lows) + mamonata::memory::vector_footprint(highs) +
+               mamonata::memory::vector_footprint(values) + mamonata::memory::vector_footprint(unique_table) +
+               mamonata::memory::hash_container_footprint(root_nodes_map);
+    }
+
+    // Returns the probe lengths of the nodes in the unique table.
+    ProbeStatistics get_unique_table_statistics() const;
+
+    // Returns variable index of a node.
+    VarIndex get_var_index(NodeId node) const {
+        return var_indices[node];
+    }
+
+    // Returns LOW child of a node.
+    NodeId get_low(NodeId node) const {
+        return lows[node];
+    }
+
+    // Returns HIGH child of a node.
+    NodeId get_high(NodeId node) const {
+        return highs[node];
+    }
+
+    // Returns value of a node.
+    NodeValue get_value(NodeId node) const {
+        return values[node];
+    }
+
+    // Checks if the node is a terminal node.
+    bool is_terminal(NodeId node) const {
+        return var_indices[node] == TERMINAL_INDEX;
+    }
+
+    /**
+     * Creates MTROBDD node. If an identical node already exists, returns the existing one.
+     *
+     * @param var_index Variable index of the node.
+     * @param low LOW child node.
+     * @param high HIGH child node.
+     * @param value Value for terminal nodes.
+     *
+     * @return Id of the created or existing node.
+     */
+    NodeId create_node(VarIndex var_index, NodeId low = NULL_NODE, NodeId high = NULL_NODE, NodeValue value = MAX_NODE_VALUE);
+
+    /**
+     * Creates a root node with a given name.
+     *
+     * @param name Name of the root node.
+     *
+     * @return Id of the created root node.
+     */
+    NodeId create_root_node(NodeName name) {
+        assert(root_nodes_map.find(name) == root_nodes_map.end());
+        NodeId root_node = create_node(0);
+        root_nodes_map[name] = root_node;
+        return root_node;
+    }
+
+    /**
+     * Creates terminal node with a given value.
+     *
+     * @param value Value for the terminal node.
+     *
+     * @return Id of the created terminal node.
+     */
+    NodeId create_terminal_node(NodeValue value) {
+        return create_node(TERMINAL_INDEX, NULL_NODE, NULL_NODE, value);
+    }
+
+    /**
+     * Promotes a node to be a root node with the given name.
+     *
+     * @param node Id of the node to promote.
+     * @param name Name of the root node.
+     *
+     * @return true if a root with the same name already existed
+     *         and was replaced, false otherwise.
+     */
+    bool promote_to_root(NodeId node, NodeName name) {
+        const bool existed = root_nodes_map.contains(name);
+        root_nodes_map[name] = node;
+        return existed;
+    }
+
+    /**
+     * Gets the root node by its name.
+     *
+     * @param name Name of the root node.
+     *
+     * @return Id of the root node if found, NULL_NODE otherwise.
+     */
+    NodeId get_root_node(NodeName name) const {
+        auto it = root_nodes_map.find(name);
+        if (it != root_nodes_map.end()) {
+            return it->second;
+        }
+        return NULL_NODE;
+    }
+
+    /**
+     * Inserts a bit string into the MTROBDD starting from a given node.
+     *
+     * @param src_node Starting node, if NULL_NODE a new path is created.
+     * @param var_index Current variable index in the bit string.
+     * @param bit_string Bit string to insert.
+     * @param terminal_value Value for the terminal node.
+     *
+     * @return Id of the new src_node after insertion.
+     */
+    NodeId insert_bit_string(NodeId src_node, VarIndex var_index, const BitVector& bit_string, NodeValue terminal_value);
+
+    /**
+     * Inserts a bit string into the MTROBDD starting from a root node by its name.
+     *
+     * @param root_name Name of the root node to start from.
+     * @param bit_string Bit string to insert.
+     * @param terminal_value Value for the terminal node.
+     *
+     * @return Id of the new root node after insertion.
+     */
+    NodeId insert_bit_string_from_root(NodeName root_name, const BitVector& bit_string, NodeValue terminal_value) {
+        NodeId new_root = insert_bit_string(get_root_node(root_name), 0, bit_string, terminal_value);
+        root_nodes_map[root_name] = new_root;
+        return new_root;
+    }
+
+    /**
+     * Copies all nodes reachable from the roots of another MTROBDD over the same variables into this one.
+     * Nodes identical to existing ones are shared; roots themselves are not copied.
+     *
+     * @param other MTROBDD whose nodes are copied.
+     *
+     * @return Map from node ids of other to the corresponding node ids in this MTROBDD;
+     *         NULL_NODE for nodes that are not reachable.
+     */
+    std::vector<NodeId> import_nodes(const ArenaMtRobdd& other);
+
+    /**
+     * Creates a complete reduced MTROBDD for a set of minterms in a single bottom-up pass.
+     * Assignments that are not listed lead to the terminal node with the default value.
+     * If the default value is the value of the virtual sink, no terminal node is created for it.
+     * MTROBDDs over at most MAX_TABLE_VARS variables are built from a flat table of all assignments,
+     * larger ones by recursive splitting of the minterms; both yield the same reduced MTROBDD.
+     *
+     * @param minterms Minterms sorted by their assignments; each assignment must be unique.
+     * @param default_value Value of the terminal node for unlisted assignments.
+     *
+     * @return Id of the root of the created MTROBDD.
+     */
+    NodeId create_from_minterms(const std::vector<Minterm>& minterms, NodeValue default_value);
+
+    /**
+     * Gets all bit strings leading to terminal nodes from a given node.
+     *
+     * @param root_node Starting node.
+     *
+     * @return Vector of pairs of bit strings and their corresponding terminal values.
+     */
+    std::vector<std::pair<BitVector, NodeValue>> get_all_bit_strings_from_root_node(NodeId root_node) const;
+
+    /**
+     * Streams all paths from a given node to terminal nodes as cubes.
+     * Skipped variables are reported as don't-cares instead of being expanded,
+     * and no memory is allocated per path. Paths to the virtual sink are reported as well.
+     *
+     * @warning Supports at most 64 variables.
+     *
+     * @param root_node Starting node.
+     * @param callback Callable invoked as callback(const Cube&, NodeValue) for each path.
+     */
+    template<typename Callback>
+    void for_each_cube(NodeId root_node, Callback&& callback) const {
+        assert(num_of_vars <= 64);
+        auto visit = [&](auto& self, const NodeId node, Cube cube) -> void {
+            if (is_leaf(node)) {
+                callback(static_cast<const Cube&>(cube), get_leaf_value(node));
+                return;
+            }
+            const uint64_t var_bit = uint64_t{1} << (num_of_vars - 1 - var_indices[node]);
+            cube.care_mask |= var_bit;
+            if (lows[node] != NULL_NODE || has_virtual_sink()) {
+                self(self, lows[node], cube);
+            }
+            if (highs[node] != NULL_NODE || has_virtual_sink()) {
+                cube.values |= var_bit;
+                self(self, highs[node], cube);
+            }
+        };
+        visit(visit, root_node, Cube{});
+    }
+
+    /**
+     * Streams all paths of the product of two MTROBDDs of this arena as cubes
+     * without creating any node of the product.
+     * Both MTROBDDs must be complete, i.e., every inner node has both children, or have a virtual sink.
+     *
+     * @warning Supports at most 64 variables.
+     *
+     * @param f First operand.
+     * @param g Second operand.
+     * @param callback Callable invoked as callback(const Cube&, NodeValue, NodeValue) with the terminal
+     *                 values of both operands for each path.
+     */
+    template<typename Callback>
+    void for_each_product_cube(const NodeId f, const NodeId g, Callback&& callback) const {
+        assert(num_of_vars <= 64);
+        auto visit = [&](auto& self, const NodeId f_node, const NodeId g_node, Cube cube) -> void {
+            if (is_leaf(f_node) && is_leaf(g_node)) {
+                callback(static_cast<const Cube&>(cube), get_leaf_value(f_node), get_leaf_value(g_node));
+                return;
+            }
+            const VarIndex var_index = get_top_var_index(f_node, g_node);
+            const auto [f_low, f_high] = get_cofactors(f_node, var_index);
+            const auto [g_low, g_high] = get_cofactors(g_node, var_index);
+            assert(has_virtual_sink() || (f_low != NULL_NODE && f_high != NULL_NODE && g_low != NULL_NODE && g_high != NULL_NODE));
+            const uint64_t var_bit = uint64_t{1} << (num_of_vars - 1 - var_index);
+            cube.care_mask |= var_bit;
+            self(self, f_low, g_low, cube);
+            cube.values |= var_bit;
+            self(self, f_high, g_high, cube);
+        };
+        visit(visit, f, g, Cube{});
+    }
+
+    /**
+     * Combines two MTROBDDs of this arena by applying an operation on their terminal values.
+     * Both operands must be complete, i.e., every inner node has both children, or the arena has a virtual sink.
+     * Results equal to the value of the virtual sink lead to NULL_NODE.
+     *
+     * @param f First operand.
+     * @param g Second operand.
+     * @param op Callable invoked as op(NodeValue, NodeValue) returning the value of the resulting terminal.
+     * @param computed_table Results of previous calls with the same operation.
+     *
+     * @return Id of the root of the resulting MTROBDD.
+     */
+    template<typename Op>
+    NodeId apply(const NodeId f, const NodeId g, Op&& op, ApplyTable& computed_table) {
+        if (is_leaf(f) && is_leaf(g)) {
+            return create_leaf(op(get_leaf_value(f), get_leaf_value(g)));
+        }
+        const uint64_t key = (static_cast<uint64_t>(f) << 32) | g;
+        if (auto it = computed_table.find(key); it != computed_table.end()) {
+            return it->second;
+        }
+
+        const VarIndex top = get_top_var_index(f, g);
+        const auto [f_low, f_high] = get_cofactors(f, top);
+        const auto [g_low, g_high] = get_cofactors(g, top);
+        assert(has_virtual_sink() || (f_low != NULL_NODE && f_high != NULL_NODE && g_low != NULL_NODE && g_high != NULL_NODE));
+        const NodeId low = apply(f_low, g_low, op, computed_table);
+        const NodeId high = apply(f_high, g_high, op, computed_table);
+        const NodeId result = create_reduced_node(top, low, high);
+
+        computed_table[key] = result;
+        return result;
+    }
+
+    /**
+     * Combines two MTROBDDs of this arena by applying an operation on their terminal values.
+     *
+     * @param f First operand.
+     * @param g Second operand.
+     * @param op Callable invoked as op(NodeValue, NodeValue) returning the value of the resulting terminal.
+     *
+     * @return Id of the root of the resulting MTROBDD.
+     */
+    template<typename Op>
+    NodeId apply(const NodeId f, const NodeId g, Op&& op) {
+        ApplyTable computed_table;
+        return apply(f, g, op, computed_table);
+    }
+
+    /**
+     * Maps terminal values of an MTROBDD, e.g., to rename states or negate a Boolean function.
+     * Paths leading to terminals mapped to the same value are merged.
+     *
+     * @param f Operand.
+     * @param map Callable invoked as map(NodeValue) returning the new terminal value.
+     * @param computed_table Results of previous calls with the same map.
+     *
+     * @return Id of the root of the resulting MTROBDD.
+     */
+    template<typename Map>
+    NodeId map_terminals(const NodeId f, Map&& map, UnaryTable& computed_table) {
+        if (is_leaf(f)) {
+            return create_leaf(map(get_leaf_value(f)));
+        }
+        if (auto it = computed_table.find(f); it != computed_table.end()) {
+            return it->second;
+        }
+
+        const VarIndex var_index = var_indices[f];
+        const NodeId f_low = lows[f];
+        const NodeId f_high = highs[f];
+        assert(has_virtual_sink() || (f_low != NULL_NODE && f_high != NULL_NODE));
+        const NodeId low = map_terminals(f_low, map, computed_table);
+        const NodeId high = map_terminals(f_high, map, computed_table);
+        const NodeId result = create_reduced_node(var_index, low, high);
+
+        computed_table[f] = result;
+        return result;
+    }
+
+    /**
+     * Maps terminal values of an MTROBDD.
+     *
+     * @param f Operand.
+     * @param map Callable invoked as map(NodeValue) returning the new terminal value.
+     *
+     * @return Id of the root of the resulting MTROBDD.
+     */
+    template<typename Map>
+    NodeId map_terminals(const NodeId f, Map&& map) {
+        UnaryTable computed_table;
+        return map_terminals(f, map, computed_table);
+    }
+
+    /**
+     * Restricts a variable of an MTROBDD to a constant (computes its cofactor).
+     *
+     * @param f Operand.
+     * @param var_index Variable to be restricted.
+     * @param value Value of the variable.
+     *
+     * @return Id of the root of the resulting MTROBDD, which does not test the variable.
+     */
+    NodeId restrict(NodeId f, VarIndex var_index, Bit value);
+
+    /**
+     * If-then-else of MTROBDDs: for each assignment, the result leads to the terminal of g
+     * if the terminal of f is nonzero and to the terminal of h otherwise.
+     *
+     * @param f Condition.
+     * @param g Then branch.
+     * @param h Else branch.
+     *
+     * @return Id of the root of the resulting MTROBDD.
+     */
+    NodeId ite(NodeId f, NodeId g, NodeId h);
+
+    /**
+     * Trims the MTROBDD by removing nodes that are not reachable from any root node.
+     * The arena is compacted, therefore node ids obtained before the call are invalidated.
+     *
+     * @return this
+     */
+    ArenaMtRobdd& trim();
+
+    /**
+     * Removes redundant test nodes from the MTROBDD.
+     * Unreachable nodes are dropped and node ids obtained before the call are invalidated.
+     *
+     * @return this
+     */
+    ArenaMtRobdd& remove_redundant_tests();
+
+    /**
+     * Makes the MTROBDD complete by ensuring all nodes have both LOW and HIGH children.
+     * Missing children are connected to a sink terminal node with the specified value.
+     * A virtual sink is materialized instead: missing children and roots lead to a terminal node
+     * with its value (sink_value is ignored) and the MTROBDD has no virtual sink afterwards.
+     * Unreachable nodes are dropped and node ids obtained before the call are invalidated.
+     *
+     * @param sink_value Value for the sink terminal node.
+     * @param complete_terminal_nodes If true, also ensure terminal nodes are included as roots.
+     *
+     * @return this
+     */
+    ArenaMtRobdd& make_complete(NodeValue sink_value = SINK_VALUE, bool complete_terminal_nodes = true);
+
+    /**
+     * Saves the MTROBDD as a DOT file.
+     *
+     * @param file_path Path to the output DOT file.
+     */
+    void save_as_dot(const std::filesystem::path& file_path) const {
+        std::ofstream ofs(file_path);
+        _print_as_dot(ofs);
+        ofs.close();
+    }
+
+    /**
+     * Prints the MTROBDD as DOT format to standard output.
+     */
+    void print_as_dot() const {
+        _print_as_dot(std::cout);
+    }
+};
+
+} // namespace mamonata::mtrobdd
+
+#endif // MAMONATA_ARENA_MTROBDD_HH_
@@ -0,0 +1,27 @@
+#ifndef MAMONATA_CLONE_HH_
+#define MAMONATA_CLONE_HH_
+
+#include <type_traits>
+
+namespace mamonata {
+
+/**
+ * @brief Copies a value, e.g., an automaton of either bridge.
+ * Move-only types such as mona::nfa::Nfa are copied by their clone() member.
+ *
+ * @param value Value to be copied.
+ *
+ * @return Copy of the value.
+ */
+template<typename T>
+T clone(const T& value) {
+    if constexpr (std::is_copy_constructible_v<T>) {
+        return value;
+    } else {
+        return value.clone();
+    }
+}
+
+} // namespace mamonata
+
+#endif // MAMONATA_CLONE_HH_
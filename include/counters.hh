@@ -0,0 +1,104 @@
+#ifndef COUNTERS_HH_
+#define COUNTERS_HH_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Enable counting only if COUNTERS_ENABLED is defined
+#ifdef COUNTERS_ENABLED
+// Add an amount to a counter of the calling thread, e.g., COUNT(CREATE_NODE_CALLS, 1).
+#define COUNT(counter, amount) Counters::add(Counters::counter, amount)
+#else
+// No-op macro when counting is disabled; the amount is not evaluated
+#define COUNT(counter, amount) ((void)0)
+#endif
+
+/**
+ * @brief Hot-path counters of the MTROBDDs and the bridges.
+ *
+ * Every thread counts into its own array, so counting is a plain increment without synchronization.
+ * Counts are attributed to operations by the Timer: a timing session records the counts of its
+ * thread between its start and stop, including nested sessions (see Timer::get_counters()).
+ * Threads helping an operation hand their counts over to the thread running the operation
+ * by get_local() and merge().
+ */
+class Counters {
+public:
+    enum Counter : size_t {
+        CREATE_NODE_CALLS,          // Calls of create_node() of MtRobdd and ArenaMtRobdd.
+        UNIQUE_TABLE_HITS,          // Calls of create_node() returning an existing node.
+        BIT_STRINGS_INSERTED,       // Assignments inserted into MTROBDDs by from_mata.
+        BIT_STRINGS_ENUMERATED,     // Cubes enumerated from MTROBDDs by to_mata.
+        MONA_PRODUCT_STATES,        // States (reachable pairs) of MONA products.
+        MONA_BDD_NODES,             // BDD nodes of the MONA managers built by operations and conversions.
+        MATA_DETERMINIZE_STATES,    // States of Mata determinization results.
+        MATA_INTERSECTION_STATES,   // States of Mata intersection results.
+        MONA_ALLOCATIONS,           // Blocks allocated by MONA through MonaAllocator (with MAMONATA_MONA_ALLOCATOR).
+        HEAP_ALLOCATIONS,           // Calls of operator new counted by the benchmark harness.
+        NUM_OF_COUNTERS
+    };
+
+    using Values = std::array<uint64_t, NUM_OF_COUNTERS>;
+
+#ifdef COUNTERS_ENABLED
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    // Names of the counters used by the exports, indexed by Counter.
+    static constexpr std::array<std::string_view, NUM_OF_COUNTERS> NAMES = {
+        "create_node_calls",
+        "unique_table_hits",
+        "bit_strings_inserted",
+        "bit_strings_enumerated",
+        "mona_product_states",
+        "mona_bdd_nodes",
+        "mata_determinize_states",
+        "mata_intersection_states",
+        "mona_allocations",
+        "heap_allocations",
+    };
+
+private:
+    static Values& local_values() {
+        thread_local Values values{};
+        return values;
+    }
+
+public:
+    // Adds an amount to a counter of the calling thread.
+    static void add(const Counter counter, const uint64_t amount) {
+        local_values()[counter] += amount;
+    }
+
+    // Returns all counts of the calling thread since it started.
+    static Values get_local() {
+        return local_values();
+    }
+
+    // Adds counts to a sum of counts.
+    static void accumulate(Values& sum, const Values& values) {
+        for (size_t counter = 0; counter < NUM_OF_COUNTERS; ++counter) {
+            sum[counter] += values[counter];
+        }
+    }
+
+    // Adds counts, e.g., of a finished helper thread, to the calling thread.
+    static void merge(const Values& values) {
+        accumulate(local_values(), values);
+    }
+
+    // Returns the counts between two calls of get_local() on the same thread.
+    static Values difference(const Values& end, const Values& start) {
+        Values result{};
+        for (size_t counter = 0; counter < NUM_OF_COUNTERS; ++counter) {
+            result[counter] = end[counter] - start[counter];
+        }
+        return result;
+    }
+};
+
+#endif // COUNTERS_HH_
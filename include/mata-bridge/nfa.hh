@@ -1,13 +1,17 @@
 #ifndef MAMONATA_MATA_NFA_HH_
 #define MAMONATA_MATA_NFA_HH_
 
+#include <algorithm>
 #include <fstream>
 #include <vector>
 #include <numeric>
+#include <ranges>
+#include <span>
 #include "mata/nfa/nfa.hh"
 #include "mata/nfa/algorithms.hh"
 #include "mata/utils/ord-vector.hh"
 #include "mata/nfa/builder.hh"
+#include "product-tree.hh"
 #include "timer.hh"
 
 
@@ -26,6 +30,9 @@ using Symbol = mata::Symbol;
 using SymbolVector = std::vector<Symbol>;
 using Transition = mata::nfa::Transition;
 using TransitionVector = std::vector<Transition>;
+using SymbolPost = mata::nfa::SymbolPost;
+using StatePost = mata::nfa::StatePost;
+using ProductOptions = mamonata::ProductOptions;
 
 /**
  * Class exposing NFA functionality from Mata.
@@ -166,6 +173,37 @@ public:
         return { nfa_impl.final.begin(), nfa_impl.final.end() };
     }
 
+    /**
+     * @brief Views the initial states of the NFA without copying them.
+     *
+     * @warning The view is invalidated by any modification of the initial states.
+     *
+     * @return Span of initial states.
+     */
+    std::span<const State> view_initial_states() const {
+        return { nfa_impl.initial.begin(), nfa_impl.initial.end() };
+    }
+
+    /**
+     * @brief Views the final states of the NFA without copying them.
+     *
+     * @warning The view is invalidated by any modification of the final states.
+     *
+     * @return Span of final states.
+     */
+    std::span<const State> view_final_states() const {
+        return { nfa_impl.final.begin(), nfa_impl.final.end() };
+    }
+
+    /**
+     * @brief Views all states of the NFA, i.e., the range [0, ..., num_of_states - 1], without allocating it.
+     *
+     * @return Range of all states.
+     */
+    auto view_states() const {
+        return std::views::iota(State{ 0 }, static_cast<State>(nfa_impl.num_of_states()));
+    }
+
     /**
      * @brief Gets all states of the NFA.
      *
@@ -197,6 +235,16 @@ public:
         return nfa_impl.delta.num_of_transitions();
     }
 
+    /**
+     * @brief Estimates the memory held by the NFA.
+     *
+     * Covers the delta (state posts, symbol posts and their target sets) and the sparse sets
+     * of initial and final states. Container capacities beyond their sizes are not included.
+     *
+     * @return Estimated memory in bytes.
+     */
+    size_t memory_footprint() const;
+
     /**
      * @brief Gets all transitions of the NFA.
      *
@@ -206,6 +254,17 @@ public:
         return { nfa_impl.delta.transitions().begin(), nfa_impl.delta.transitions().end() };
     }
 
+    /**
+     * @brief Views all transitions of the NFA; they are enumerated from the delta on the fly.
+     *
+     * @warning The view is invalidated by any modification of the delta.
+     *
+     * @return Range of all transitions.
+     */
+    auto view_transitions() const {
+        return nfa_impl.delta.transitions();
+    }
+
     /**
      * @brief Gets all successors of a state.
      *
@@ -218,6 +277,31 @@ public:
         return { successors.begin(), successors.end() };
     }
 
+    /**
+     * @brief Gets the outgoing transitions of a state grouped by symbols.
+     *
+     * @param source Source state.
+     *
+     * @return Reference to the state post stored in the NFA delta.
+     */
+    const StatePost& get_state_post(const State source) const {
+        return nfa_impl.delta[source];
+    }
+
+    /**
+     * @brief Gets the mutable post of a state, i.e., all its outgoing transitions grouped by symbols.
+     *
+     * @warning Symbol posts must be kept ordered by symbols and their targets ordered.
+     *          Posts of distinct states may be modified concurrently only if all states already exist.
+     *
+     * @param source Source state.
+     *
+     * @return Reference to the state post stored in the NFA delta.
+     */
+    StatePost& get_mutable_state_post(const State source) {
+        return nfa_impl.delta.mutable_state_post(source);
+    }
+
     /**
      * @brief Gets the successors of a state on a given symbol.
      *
@@ -231,6 +315,29 @@ public:
         return { successors.begin(), successors.end() };
     }
 
+    /**
+     * @brief Views the successors of a state on a given symbol without copying them.
+     *
+     * @warning The view is invalidated by any modification of the post of the state.
+     *
+     * @param source Source state.
+     * @param symbol Transition symbol.
+     *
+     * @return Span of successor states ordered by their numbers; empty if there is no transition.
+     */
+    std::span<const State> view_successors(const State source, const Symbol symbol) const {
+        if (source >= nfa_impl.num_of_states()) {
+            return {};
+        }
+        const StatePost& state_post = nfa_impl.delta[source];
+        const auto symbol_post = std::lower_bound(state_post.begin(), state_post.end(), symbol,
+            [](const SymbolPost& post, const Symbol value) { return post.symbol < value; });
+        if (symbol_post == state_post.end() || symbol_post->symbol != symbol) {
+            return {};
+        }
+        return { symbol_post->targets.begin(), symbol_post->targets.end() };
+    }
+
     /**
      * @brief Gets the level of nondeterminism of the NFA.
      *
@@ -353,16 +460,40 @@ public:
         std::cout << nfa_impl.print_to_dot(decode_ascii_chars, use_intervals, max_label_length);
     }
 
+    /**
+     * @brief Checks if the language of the NFA is empty.
+     * Only the states reachable from the initial states are explored, and the search stops
+     * at the first reachable final state.
+     *
+     * @param witness If not null and the language is nonempty, set to an accepted word.
+     *
+     * @return true if the language is empty, false otherwise.
+     */
+    bool is_empty(SymbolVector* witness = nullptr) const;
+
+    /**
+     * @brief Checks if the language of this NFA is included in the language of another NFA.
+     * Uses the antichain-based algorithm, which explores the product with the determinized
+     * other NFA lazily and stops at the first counterexample.
+     *
+     * @param other NFA with the including language.
+     * @param witness If not null and the language is not included, set to a word accepted by this NFA
+     *                and rejected by the other one.
+     *
+     * @return true if the language is included, false otherwise.
+     */
+    bool is_included(const Nfa& other, SymbolVector* witness = nullptr) const;
+
     /**
      * @brief Checks if this NFA is equivalent to another NFA.
+     * Uses the antichain-based inclusion checks in both directions.
      *
      * @param other NFA to compare with.
+     * @param witness If not null and the languages differ, set to a word accepted by exactly one of the NFAs.
      *
      * @return true if the NFAs are equivalent, false otherwise.
      */
-    bool are_equivalent(const Nfa& other) const {
-        return mata::nfa::are_equivalent(nfa_impl, other.nfa_impl);
-    }
+    bool are_equivalent(const Nfa& other, SymbolVector* witness = nullptr) const;
 
     /**
      * @brief Trims the NFA by removing unreachable and non-coaccessible states.
@@ -460,6 +591,34 @@ public:
      */
     Nfa& intersection(const Nfa& aut, Symbol first_epsilon = mata::nfa::EPSILON);
 
+    /**
+     * @brief Computes the intersection of all given NFAs.
+     * Intermediate products are trimmed, the computation stops once a product is empty,
+     * and large intermediate products are reduced by simulation (see ProductOptions).
+     *
+     * @throws std::runtime_error If there are no operands.
+     *
+     * @param operands NFAs to intersect.
+     * @param options Shape of the product tree and reduction threshold.
+     *
+     * @return Intersection of the operands.
+     */
+    static Nfa intersection_all(std::span<const Nfa> operands, const ProductOptions& options = {});
+
+    /**
+     * @brief Computes the union of all given complete deterministic automata. Perserves determinism.
+     * Large intermediate products are trimmed, minimized by Hopcroft's algorithm and completed again
+     * over the symbols used by the operands (see ProductOptions).
+     *
+     * @throws std::runtime_error If there are no operands.
+     *
+     * @param operands Complete deterministic automata to union.
+     * @param options Shape of the product tree and reduction threshold.
+     *
+     * @return Union of the operands.
+     */
+    static Nfa union_all(std::span<const Nfa> operands, const ProductOptions& options = {});
+
     /**
      * @brief Complements the NFA by determinizing it, adding a sink state, and making the automaton complete.
      * Non-final states in the original automaton are converted to final states in the complemented automaton.
@@ -0,0 +1,171 @@
+#ifndef MEMORY_TRACKER_HH_
+#define MEMORY_TRACKER_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mamonata::memory {
+
+// Estimated heap memory of a std::vector in bytes (excluding the vector object itself).
+template<typename Vector>
+size_t vector_footprint(const Vector& vector) {
+    return vector.capacity() * sizeof(typename Vector::value_type);
+}
+
+// Estimated heap memory of a std::unordered_{set,map} in bytes (excluding the container object itself).
+// Every element lives in its own node holding the next pointer and the cached hash.
+template<typename HashContainer>
+size_t hash_container_footprint(const HashContainer& container) {
+    return container.bucket_count() * sizeof(void*) +
+           container.size() * (sizeof(typename HashContainer::value_type) + sizeof(void*) + sizeof(size_t));
+}
+
+} // namespace mamonata::memory
+
+/**
+ * @brief Tracks the peak resident set size (RSS) of the process within a scope.
+ *
+ * The peak is read from VmHWM in /proc/self/status. Before a scope starts, the peak of the
+ * process is reset by writing "5" to /proc/self/clear_refs (Linux), so the scope measures the
+ * peak reached while it runs rather than since the process started. Enclosing scopes keep
+ * the peaks observed before the reset, so scopes may be nested, e.g., around a TIME block:
+ *
+ *     PeakMemoryTracker::Scope scope;
+ *     TIME(aut.determinize());
+ *     const size_t peak = scope.stop();
+ *
+ * Since the reset also clears the peak of the process, which getrusage() reports as ru_maxrss, the
+ * tracker folds the peak seen before every reset into get_process_peak_rss_bytes(); use it instead
+ * of VmHWM or ru_maxrss for the peak since the process started.
+ *
+ * The RSS is shared by all threads of the process, so concurrent operations are measured together.
+ * When the peak cannot be reset, is_exact() is false and the peak since the process start is reported.
+ * Without /proc (non-Linux systems), all values are 0.
+ */
+class PeakMemoryTracker {
+public:
+    class Scope;
+
+private:
+    std::mutex mutex{};
+    std::vector<Scope*> active_scopes{};
+    size_t process_peak_bytes = 0;  // Peak of the process before the last reset.
+
+    PeakMemoryTracker() = default;
+    PeakMemoryTracker(const PeakMemoryTracker&) = delete;
+    PeakMemoryTracker& operator=(const PeakMemoryTracker&) = delete;
+
+    static PeakMemoryTracker& instance() {
+        static PeakMemoryTracker instance;
+        return instance;
+    }
+
+    // Reads a field of /proc/self/status given in kB and returns it in bytes (0 if missing).
+    static size_t read_status_bytes(const std::string& field) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() && line[field.size()] == ':') {
+                return std::stoul(line.substr(field.size() + 1)) * 1024;
+            }
+        }
+        return 0;
+    }
+
+    // Resets the peak RSS of the process; returns false if the kernel does not allow it.
+    static bool reset_peak() {
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+        clear_refs.flush();
+        return clear_refs.good();
+    }
+
+public:
+    // Returns the current RSS of the process in bytes.
+    static size_t get_current_rss_bytes() {
+        return read_status_bytes("VmRSS");
+    }
+
+    // Returns the peak RSS of the process since the last reset in bytes.
+    static size_t get_peak_rss_bytes() {
+        return read_status_bytes("VmHWM");
+    }
+
+    // Returns the peak RSS of the process since it started in bytes, including the peaks before resets.
+    static size_t get_process_peak_rss_bytes() {
+        PeakMemoryTracker& tracker = instance();
+        std::lock_guard<std::mutex> lock(tracker.mutex);
+        return std::max(tracker.process_peak_bytes, get_peak_rss_bytes());
+    }
+
+    /**
+     * @brief Measures the peak RSS from its construction until stop() or its destruction.
+     */
+    class Scope {
+        friend class PeakMemoryTracker;
+
+        size_t baseline_bytes = 0;  // RSS when the scope started.
+        size_t peak_bytes = 0;      // Peak observed before the peak was reset by nested scopes.
+        bool exact = false;
+        bool running = true;
+
+    public:
+        Scope() {
+            PeakMemoryTracker& tracker = instance();
+            std::lock_guard<std::mutex> lock(tracker.mutex);
+            const size_t peak = get_peak_rss_bytes();
+            for (Scope* scope : tracker.active_scopes) {
+                scope->peak_bytes = std::max(scope->peak_bytes, peak);
+            }
+            tracker.process_peak_bytes = std::max(tracker.process_peak_bytes, peak);
+            exact = reset_peak();
+            baseline_bytes = get_current_rss_bytes();
+            peak_bytes = baseline_bytes;
+            tracker.active_scopes.push_back(this);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            stop();
+        }
+
+        /**
+         * @brief Stops the scope; later calls return the same result.
+         *
+         * @return Peak RSS in bytes reached while the scope was running.
+         */
+        size_t stop() {
+            if (running) {
+                PeakMemoryTracker& tracker = instance();
+                std::lock_guard<std::mutex> lock(tracker.mutex);
+                peak_bytes = std::max(peak_bytes, get_peak_rss_bytes());
+                std::erase(tracker.active_scopes, this);
+                running = false;
+            }
+            return peak_bytes;
+        }
+
+        // Returns the RSS in bytes when the scope started.
+        size_t get_baseline_bytes() const {
+            return baseline_bytes;
+        }
+
+        // Returns the growth of the RSS peak over the baseline in bytes; valid after stop().
+        size_t get_peak_increase_bytes() const {
+            return peak_bytes - std::min(peak_bytes, baseline_bytes);
+        }
+
+        // Checks if the peak was reset when the scope started, i.e., it does not include earlier peaks.
+        bool is_exact() const {
+            return exact;
+        }
+    };
+};
+
+#endif // MEMORY_TRACKER_HH_
@@ -0,0 +1,172 @@
+#ifndef MAMONATA_MONA_ALLOCATOR_HH_
+#define MAMONATA_MONA_ALLOCATOR_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+
+namespace mamonata::mona {
+
+/**
+ * Pooling allocator serving all memory allocated by MONA.
+ *
+ * When MaMONAta is configured with MAMONATA_MONA_ALLOCATOR, the linker redirects MONA's
+ * mem_alloc, mem_free and mem_resize to this allocator (-Wl,--wrap). Blocks are rounded
+ * up to power-of-two size classes; blocks larger than the largest class go directly to malloc.
+ * Without the option, MONA uses its own allocator and the counters stay zero.
+ *
+ * While recycling is enabled, freed blocks are kept in per-thread free lists and reused
+ * by later allocations of the same class, so BDD managers and node tables of consecutive
+ * operations in a pipeline reuse the storage of the freed intermediate results.
+ * Cached blocks of a thread are bounded by the cache limit; they are returned to the
+ * system when recycling is disabled, on release_cached() and when the thread exits.
+ *
+ * All methods are thread-safe.
+ */
+class MonaAllocator {
+public:
+    // Counters of the allocator usage.
+    struct Statistics {
+        size_t allocations = 0;     // Allocated blocks (including the new blocks of resizes)
+        size_t frees = 0;           // Freed blocks (including the old blocks of resizes)
+        size_t resizes = 0;         // Resize requests
+        size_t pool_hits = 0;       // Allocations served from a free list
+        size_t bytes_allocated = 0; // Total size of the allocated blocks
+        size_t bytes_live = 0;      // Size of the blocks currently in use
+        size_t bytes_peak = 0;      // Maximum of bytes_live since the last reset
+        size_t bytes_cached = 0;    // Size of the blocks kept in free lists of all threads
+    };
+
+    // Blocks of the smallest size class; the class c has MIN_BLOCK_SIZE << c bytes.
+    static constexpr size_t MIN_BLOCK_SIZE = 16;
+    static constexpr size_t NUM_OF_SIZE_CLASSES = 21;  // Up to 16 MiB
+
+private:
+    std::atomic<bool> recycling = false;
+    std::atomic<size_t> cache_limit_bytes = size_t{64} << 20;
+
+    std::atomic<size_t> allocations = 0;
+    std::atomic<size_t> frees = 0;
+    std::atomic<size_t> resizes = 0;
+    std::atomic<size_t> pool_hits = 0;
+    std::atomic<size_t> bytes_allocated = 0;
+    std::atomic<size_t> bytes_live = 0;
+    std::atomic<size_t> bytes_peak = 0;
+    std::atomic<size_t> bytes_cached = 0;
+
+    MonaAllocator() = default;
+
+    // Updates the live and peak byte counters after allocating a block.
+    void record_allocation(size_t block_size);
+
+public:
+    MonaAllocator(const MonaAllocator&) = delete;
+    MonaAllocator& operator=(const MonaAllocator&) = delete;
+
+    // Returns the process-wide allocator used by MONA.
+    static MonaAllocator& instance();
+
+    // Checks if MONA allocations are routed to this allocator.
+    static constexpr bool is_enabled() {
+#ifdef MAMONATA_MONA_ALLOCATOR
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Allocates a block of at least the given size. Terminates the process when out of memory, as MONA does.
+     *
+     * @param size Requested size in bytes.
+     *
+     * @return Pointer to the block, aligned as by malloc.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * @brief Frees a block returned by allocate or reallocate.
+     *
+     * @param ptr Pointer to the block; may be null.
+     */
+    void deallocate(void* ptr);
+
+    /**
+     * @brief Resizes a block, keeping its content up to the smaller of both sizes.
+     *
+     * @param ptr Pointer to the block; if null, a new block is allocated.
+     * @param size Requested size in bytes.
+     *
+     * @return Pointer to the resized block.
+     */
+    void* reallocate(void* ptr, size_t size);
+
+    /**
+     * @brief Enables or disables keeping freed blocks for reuse.
+     * Disabling recycling releases the blocks cached by the calling thread.
+     *
+     * @param enabled If true, freed blocks are cached in per-thread free lists.
+     */
+    void set_recycling(bool enabled);
+
+    // Checks if freed blocks are cached for reuse.
+    bool is_recycling() const {
+        return recycling.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets the maximum size of the blocks cached by a single thread.
+     *
+     * @param bytes Limit in bytes; freed blocks which do not fit are returned to the system.
+     */
+    void set_cache_limit(const size_t bytes) {
+        cache_limit_bytes.store(bytes, std::memory_order_relaxed);
+    }
+
+    // Returns the cached blocks of the calling thread to the system.
+    void release_cached();
+
+    // Resets the counters except bytes_live and bytes_cached; bytes_peak restarts at bytes_live.
+    void reset_statistics();
+
+    // Returns the current counters of the allocator.
+    Statistics get_statistics() const;
+
+    /**
+     * @brief Writes the counters as a CSV header line followed by a single row.
+     *
+     * @param os Output stream.
+     */
+    void export_csv(std::ostream& os) const;
+
+    /**
+     * @brief Writes the counters as a JSON object.
+     *
+     * @param os Output stream.
+     */
+    void export_json(std::ostream& os) const;
+};
+
+/**
+ * RAII scope recycling MONA storage between consecutive operations, e.g., a chain of products.
+ * Restores the previous setting when it ends.
+ */
+class MonaRecyclingScope {
+    bool previous;
+
+public:
+    MonaRecyclingScope() : previous(MonaAllocator::instance().is_recycling()) {
+        MonaAllocator::instance().set_recycling(true);
+    }
+
+    MonaRecyclingScope(const MonaRecyclingScope&) = delete;
+    MonaRecyclingScope& operator=(const MonaRecyclingScope&) = delete;
+
+    ~MonaRecyclingScope() {
+        MonaAllocator::instance().set_recycling(previous);
+    }
+};
+
+} // namespace mamonata::mona
+
+#endif // MAMONATA_MONA_ALLOCATOR_HH_
@@ -0,0 +1,315 @@
+#ifndef MAMONATA_MONA_ALPHABET_ENCODING_HH_
+#define MAMONATA_MONA_ALPHABET_ENCODING_HH_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "mtrobdd.hh"
+
+namespace mamonata::mona::nfa {
+
+using Symbol = size_t;
+// Binary code of a symbol packed into a machine word (first variable is the most significant bit).
+using Code = uint64_t;
+
+/**
+ * Binary encoding of alphabet symbols.
+ *
+ * Codes are packed into machine words. Decoding is a lookup in a flat table
+ * indexed by the code; the table has 2^num_of_vars entries, which is less than
+ * twice the number of symbols for a minimal encoding. If the symbols form a dense
+ * range in the order of their codes, encoding is arithmetic; otherwise it uses
+ * a dictionary from symbols to codes (an open-addressing table of mixed symbol hashes).
+ *
+ * Automata share their encoding through AlphabetEncodingPtr; a shared encoding is never modified.
+ */
+class AlphabetEncoding {
+public:
+    static constexpr Symbol NO_SYMBOL = std::numeric_limits<Symbol>::max();
+    static constexpr Code NO_CODE = std::numeric_limits<Code>::max();
+
+private:
+    size_t num_of_vars = 0;                     // Number of variables of a code
+    size_t num_of_symbols = 0;                  // Number of encoded symbols
+    bool is_dense = true;                       // Code of each symbol is symbol - first_symbol
+    Symbol first_symbol = 0;                    // Symbol with code 0 for dense alphabets
+    Code end_code = 0;                          // One past the largest used code
+    std::vector<Symbol> decode_table;           // Symbol of each code; NO_SYMBOL for unused codes
+    // Codes of symbols with linear probing, at most half full; NO_SYMBOL marks an empty slot.
+    // Used only for sparse alphabets.
+    std::vector<std::pair<Symbol, Code>> encode_table;
+
+    // Returns the slot of a symbol in the dictionary, or the empty slot where it belongs.
+    size_t find_encode_slot(const Symbol symbol) const {
+        const size_t mask = encode_table.size() - 1;
+        size_t slot = mamonata::mtrobdd::mix_hash(symbol) & mask;
+        while (encode_table[slot].first != NO_SYMBOL && encode_table[slot].first != symbol) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    // Rebuilds the dictionary from the decode table with room for the given number of symbols.
+    void rebuild_encode_table(const size_t num_of_entries) {
+        size_t capacity = 16;
+        while (capacity < 2 * num_of_entries) {
+            capacity <<= 1;
+        }
+        encode_table.assign(capacity, { NO_SYMBOL, NO_CODE });
+        for (Code code = 0; code < decode_table.size(); ++code) {
+            if (decode_table[code] != NO_SYMBOL) {
+                encode_table[find_encode_slot(decode_table[code])] = { decode_table[code], code };
+            }
+        }
+    }
+
+    // Switches to the dictionary encoding, keeping all existing codes.
+    void make_sparse() {
+        if (!is_dense) {
+            return;
+        }
+        rebuild_encode_table(num_of_symbols);
+        is_dense = false;
+    }
+
+public:
+    AlphabetEncoding() = default;
+
+    /**
+     * @brief Constructor of an encoding without symbols.
+     *
+     * @param num_of_vars Number of variables of a code.
+     */
+    explicit AlphabetEncoding(const size_t num_of_vars)
+        : num_of_vars(num_of_vars), decode_table(size_t{1} << num_of_vars, NO_SYMBOL) {
+        assert(num_of_vars < 64);
+    }
+
+    /**
+     * @brief Constructor encoding the i-th symbol as i.
+     *
+     * @param symbols Symbols in the order of their codes; each symbol must be unique.
+     * @param num_of_vars Number of variables of a code; 2^num_of_vars must be at least symbols.size().
+     */
+    AlphabetEncoding(const std::vector<Symbol>& symbols, const size_t num_of_vars)
+        : AlphabetEncoding(num_of_vars) {
+        assert(symbols.size() <= decode_table.size());
+        num_of_symbols = symbols.size();
+        first_symbol = symbols.empty() ? 0 : symbols.front();
+        end_code = symbols.size();
+        for (Code code = 0; code < symbols.size(); ++code) {
+            decode_table[code] = symbols[code];
+            is_dense &= (symbols[code] == first_symbol + code);
+        }
+        if (!is_dense) {
+            is_dense = true;
+            make_sparse();
+        }
+    }
+
+    /**
+     * @brief Creates the encoding of symbols 0, ..., size-1 with codes equal to the symbols.
+     *
+     * @param size Number of symbols.
+     * @param num_of_vars Number of variables of a code.
+     *
+     * @return Dense encoding.
+     */
+    static AlphabetEncoding identity(const size_t size, const size_t num_of_vars) {
+        AlphabetEncoding encoding(num_of_vars);
+        assert(size <= encoding.decode_table.size());
+        for (Code code = 0; code < size; ++code) {
+            encoding.decode_table[code] = static_cast<Symbol>(code);
+        }
+        encoding.num_of_symbols = size;
+        encoding.end_code = size;
+        return encoding;
+    }
+
+    // Returns number of variables of a code.
+    size_t get_num_of_vars() const {
+        return num_of_vars;
+    }
+
+    // Returns number of encoded symbols.
+    size_t size() const {
+        return num_of_symbols;
+    }
+
+    // Checks if encoding of symbols is arithmetic.
+    bool is_dense_range() const {
+        return is_dense;
+    }
+
+    /**
+     * @brief Encodes a symbol.
+     *
+     * @param symbol Symbol to be encoded.
+     *
+     * @return Code of the symbol, or NO_CODE if the symbol is not encoded.
+     */
+    Code encode(const Symbol symbol) const {
+        if (is_dense) {
+            const Code code = static_cast<Code>(symbol - first_symbol);
+            return (symbol >= first_symbol && code < decode_table.size() && decode_table[code] == symbol) ? code : NO_CODE;
+        }
+        const std::pair<Symbol, Code>& entry = encode_table[find_encode_slot(symbol)];
+        return (entry.first == NO_SYMBOL) ? NO_CODE : entry.second;
+    }
+
+    /**
+     * @brief Decodes a code.
+     *
+     * @param code Code to be decoded; must be less than 2^num_of_vars.
+     *
+     * @return Symbol with the code, or NO_SYMBOL if the code is unused.
+     */
+    Symbol decode(const Code code) const {
+        assert(code < decode_table.size());
+        return decode_table[code];
+    }
+
+    /**
+     * @brief Adds a symbol with the given code. The code must be unused and the symbol not yet encoded.
+     *
+     * @param symbol Symbol to be added.
+     * @param code Code of the symbol; must be less than 2^num_of_vars.
+     */
+    void add(const Symbol symbol, const Code code) {
+        assert(code < decode_table.size());
+        assert(decode_table[code] == NO_SYMBOL);
+        assert(encode(symbol) == NO_CODE);
+        if (is_dense) {
+            if (num_of_symbols == 0 && symbol >= code) {
+                first_symbol = symbol - code;
+            }
+            if (symbol < first_symbol || symbol - first_symbol != code) {
+                make_sparse();
+            }
+        }
+        decode_table[code] = symbol;
+        if (!is_dense) {
+            if (2 * (num_of_symbols + 1) > encode_table.size()) {
+                rebuild_encode_table(num_of_symbols + 1);
+            } else {
+                encode_table[find_encode_slot(symbol)] = { symbol, code };
+            }
+        }
+        ++num_of_symbols;
+        end_code = std::max(end_code, code + 1);
+    }
+
+    /**
+     * @brief Checks if symbols increase with their codes, i.e., visiting codes in order yields sorted symbols.
+     * Linear in the number of codes unless the encoding is dense.
+     */
+    bool is_order_preserving() const {
+        if (is_dense) {
+            return true;
+        }
+        Symbol previous = NO_SYMBOL;
+        for (Code code = 0; code < end_code; ++code) {
+            if (decode_table[code] != NO_SYMBOL) {
+                if (previous != NO_SYMBOL && decode_table[code] < previous) {
+                    return false;
+                }
+                previous = decode_table[code];
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Visits the maximal runs of consecutive symbols whose codes lie in a range, in the order of codes.
+     * A run ends at an unused code or where the symbol of the next code is not the successor of the previous one.
+     * Dense encodings without unused codes visit the whole range at once.
+     *
+     * @param first_code First code of the range.
+     * @param last_code Last code of the range (inclusive); must be less than 2^num_of_vars.
+     * @param callback Callable invoked as callback(first_symbol, last_symbol) for every run.
+     */
+    template<typename Callback>
+    void for_each_symbol_run(const Code first_code, Code last_code, Callback&& callback) const {
+        last_code = std::min(last_code, end_code - 1);
+        if (end_code == 0 || first_code > last_code) {
+            return;
+        }
+        if (is_dense && end_code == num_of_symbols) {
+            callback(first_symbol + first_code, first_symbol + last_code);
+            return;
+        }
+        Symbol run_first = NO_SYMBOL;
+        Symbol run_last = NO_SYMBOL;
+        for (Code code = first_code; code <= last_code; ++code) {
+            const Symbol symbol = decode_table[code];
+            if (run_first != NO_SYMBOL && (symbol == NO_SYMBOL || symbol != run_last + 1)) {
+                callback(run_first, run_last);
+                run_first = NO_SYMBOL;
+            }
+            if (symbol != NO_SYMBOL) {
+                if (run_first == NO_SYMBOL) {
+                    run_first = symbol;
+                }
+                run_last = symbol;
+            }
+        }
+        if (run_first != NO_SYMBOL) {
+            callback(run_first, run_last);
+        }
+    }
+
+    /**
+     * @brief Converts a code into a BitVector.
+     *
+     * @param code Packed code.
+     *
+     * @return Bits of the code, first variable first.
+     */
+    mamonata::mtrobdd::BitVector to_bit_vector(const Code code) const {
+        mamonata::mtrobdd::BitVector bits(num_of_vars, mamonata::mtrobdd::LO);
+        for (size_t i = 0; i < num_of_vars; ++i) {
+            if ((code >> (num_of_vars - 1 - i)) & 1) {
+                bits[i] = mamonata::mtrobdd::HI;
+            }
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Visits all encoded symbols in the order of their codes.
+     *
+     * @param callback Callable invoked as callback(Symbol, Code).
+     */
+    template<typename Callback>
+    void for_each(Callback&& callback) const {
+        for (Code code = 0; code < decode_table.size(); ++code) {
+            if (decode_table[code] != NO_SYMBOL) {
+                callback(decode_table[code], code);
+            }
+        }
+    }
+
+    // Checks if both encodings assign the same codes to the same symbols.
+    bool operator==(const AlphabetEncoding& other) const {
+        return num_of_vars == other.num_of_vars && num_of_symbols == other.num_of_symbols &&
+               decode_table == other.decode_table;
+    }
+
+    // Returns estimated memory held by the encoding in bytes.
+    size_t memory_footprint() const {
+        return sizeof(AlphabetEncoding) + decode_table.capacity() * sizeof(Symbol) +
+               encode_table.capacity() * sizeof(std::pair<Symbol, Code>);
+    }
+};
+
+// Immutable encoding shared by automata over the same alphabet.
+using AlphabetEncodingPtr = std::shared_ptr<const AlphabetEncoding>;
+
+} // namespace mamonata::mona::nfa
+
+#endif // MAMONATA_MONA_ALPHABET_ENCODING_HH_
@@ -0,0 +1,266 @@
+#ifndef MAMONATA_MONA_CONVERSION_CACHE_HH_
+#define MAMONATA_MONA_CONVERSION_CACHE_HH_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <unordered_map>
+#include <variant>
+#include "clone.hh"
+#include "mona-bridge/nfa.hh"
+
+namespace mamonata::mona::nfa {
+
+/**
+ * Opt-in cache of conversions between Mata and MONA representations.
+ *
+ * Nfa::from_mata and Nfa::to_mata consult the cache when it is enabled, i.e.,
+ * when its capacity is nonzero. Entries are keyed by a structural fingerprint
+ * of the converted automaton (plus the alphabet encoding for from_mata) and store
+ * a copy of the conversion result. The cache is bounded by an estimate of the
+ * memory held by the stored automata; the least recently used entries are evicted first.
+ *
+ * Fingerprints are 128-bit hashes, collisions are assumed not to happen.
+ * All methods are thread-safe.
+ */
+class ConversionCache {
+public:
+    // Structural fingerprint of an automaton.
+    struct Key {
+        uint64_t first = 0;
+        uint64_t second = 0;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    // Incrementally computes a Key from a sequence of integers.
+    class Fingerprint {
+        uint64_t first;
+        uint64_t second;
+
+        static uint64_t mix(uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xFF51AFD7ED558CCDull;
+            value ^= value >> 33;
+            value *= 0xC4CEB9FE1A85EC53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+    public:
+        // Distinct seeds keep fingerprints of different kinds of automata apart.
+        explicit Fingerprint(const uint64_t seed) : first(mix(seed)), second(mix(~seed)) {}
+
+        void add(const uint64_t value) {
+            first = mix(first ^ value) + 0x9E3779B97F4A7C15ull;
+            second = (second ^ mix(value + 0x632BE59BD9B4E019ull)) * 0x100000001B3ull;
+        }
+
+        Key get_key() const {
+            return { mix(first), mix(second ^ first) };
+        }
+    };
+
+    // Counters of the cache usage.
+    struct Statistics {
+        size_t hits = 0;            // Lookups that found an entry
+        size_t misses = 0;          // Lookups that did not find an entry
+        size_t insertions = 0;      // Stored entries
+        size_t evictions = 0;       // Entries evicted to fit the capacity
+        size_t entries = 0;         // Currently stored entries
+        size_t bytes = 0;           // Estimated memory held by the stored entries
+        size_t capacity_bytes = 0;  // Capacity of the cache; 0 when disabled
+    };
+
+private:
+    using Value = std::variant<Nfa, mamonata::mata::nfa::Nfa>;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>(key.first);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        Value value;
+        size_t bytes;
+    };
+
+    mutable std::mutex mutex;
+    size_t capacity_bytes = 0;
+    std::list<Entry> lru_list;  // Most recently used entries first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+    Statistics statistics;
+
+    ConversionCache() = default;
+
+    // Evicts least recently used entries until the stored entries fit the capacity.
+    void evict_to_capacity() {
+        while (statistics.bytes > capacity_bytes && !lru_list.empty()) {
+            statistics.bytes -= lru_list.back().bytes;
+            entries.erase(lru_list.back().key);
+            lru_list.pop_back();
+            ++statistics.evictions;
+        }
+    }
+
+    template<typename T>
+    std::optional<T> find(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end() || !std::holds_alternative<T>(it->second->value)) {
+            ++statistics.misses;
+            return std::nullopt;
+        }
+        ++statistics.hits;
+        lru_list.splice(lru_list.begin(), lru_list, it->second);
+        return mamonata::clone(std::get<T>(it->second->value));
+    }
+
+    template<typename T>
+    void insert(const Key& key, const T& value, const size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (capacity_bytes == 0 || bytes > capacity_bytes) {
+            return;
+        }
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            statistics.bytes -= it->second->bytes;
+            lru_list.erase(it->second);
+            entries.erase(it);
+        }
+        lru_list.push_front(Entry{ key, Value(std::in_place_type<T>, mamonata::clone(value)), bytes });
+        entries[key] = lru_list.begin();
+        statistics.bytes += bytes;
+        ++statistics.insertions;
+        evict_to_capacity();
+    }
+
+public:
+    ConversionCache(const ConversionCache&) = delete;
+    ConversionCache& operator=(const ConversionCache&) = delete;
+
+    // Returns the process-wide cache used by the conversions.
+    static ConversionCache& instance() {
+        static ConversionCache instance;
+        return instance;
+    }
+
+    /**
+     * @brief Sets the capacity of the cache. Entries which do not fit are evicted.
+     *
+     * @param bytes Estimated memory the stored automata may hold; 0 disables the cache.
+     */
+    void set_capacity(const size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        capacity_bytes = bytes;
+        statistics.capacity_bytes = bytes;
+        evict_to_capacity();
+    }
+
+    // Checks if the conversions use the cache.
+    bool is_enabled() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return capacity_bytes > 0;
+    }
+
+    /**
+     * @brief Finds a MONA automaton converted from a Mata automaton with the given fingerprint.
+     *
+     * @return Copy of the stored automaton, or std::nullopt if not present.
+     */
+    std::optional<Nfa> find_mona(const Key& key) {
+        return find<Nfa>(key);
+    }
+
+    /**
+     * @brief Finds a Mata automaton converted from a MONA automaton with the given fingerprint.
+     *
+     * @return Copy of the stored automaton, or std::nullopt if not present.
+     */
+    std::optional<mamonata::mata::nfa::Nfa> find_mata(const Key& key) {
+        return find<mamonata::mata::nfa::Nfa>(key);
+    }
+
+    /**
+     * @brief Stores a copy of a MONA automaton converted from a Mata automaton.
+     *
+     * @param key Fingerprint of the converted Mata automaton.
+     * @param nfa Result of the conversion.
+     * @param bytes Estimated memory held by the automaton.
+     */
+    void insert_mona(const Key& key, const Nfa& nfa, const size_t bytes) {
+        insert<Nfa>(key, nfa, bytes);
+    }
+
+    /**
+     * @brief Stores a copy of a Mata automaton converted from a MONA automaton.
+     *
+     * @param key Fingerprint of the converted MONA automaton.
+     * @param nfa Result of the conversion.
+     * @param bytes Estimated memory held by the automaton.
+     */
+    void insert_mata(const Key& key, const mamonata::mata::nfa::Nfa& nfa, const size_t bytes) {
+        insert<mamonata::mata::nfa::Nfa>(key, nfa, bytes);
+    }
+
+    // Removes all entries while keeping the capacity and the counters.
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        lru_list.clear();
+        entries.clear();
+        statistics.bytes = 0;
+    }
+
+    // Resets the hit, miss, insertion and eviction counters.
+    void reset_statistics() {
+        std::lock_guard<std::mutex> lock(mutex);
+        statistics.hits = 0;
+        statistics.misses = 0;
+        statistics.insertions = 0;
+        statistics.evictions = 0;
+    }
+
+    // Returns the current counters of the cache.
+    Statistics get_statistics() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        Statistics result = statistics;
+        result.entries = lru_list.size();
+        return result;
+    }
+
+    /**
+     * @brief Writes the counters as a CSV header line followed by a single row.
+     *
+     * @param os Output stream.
+     */
+    void export_csv(std::ostream& os) const {
+        const Statistics stats = get_statistics();
+        os << "hits,misses,insertions,evictions,entries,bytes,capacity_bytes\n";
+        os << stats.hits << ',' << stats.misses << ',' << stats.insertions << ',' << stats.evictions << ','
+           << stats.entries << ',' << stats.bytes << ',' << stats.capacity_bytes << '\n';
+    }
+
+    /**
+     * @brief Writes the counters as a JSON object.
+     *
+     * @param os Output stream.
+     */
+    void export_json(std::ostream& os) const {
+        const Statistics stats = get_statistics();
+        os << "{\"hits\":" << stats.hits
+           << ",\"misses\":" << stats.misses
+           << ",\"insertions\":" << stats.insertions
+           << ",\"evictions\":" << stats.evictions
+           << ",\"entries\":" << stats.entries
+           << ",\"bytes\":" << stats.bytes
+           << ",\"capacity_bytes\":" << stats.capacity_bytes << "}\n";
+    }
+};
+
+} // namespace mamonata::mona::nfa
+
+#endif // MAMONATA_MONA_CONVERSION_CACHE_HH_
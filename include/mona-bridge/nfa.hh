@@ -7,7 +7,12 @@
 #include <charconv>
 #include <limits>
 #include <optional>
+#include <span>
+#include <vector>
 #include "mtrobdd.hh"
+#include "arena-mtrobdd.hh"
+#include "mona-bridge/alphabet-encoding.hh"
+#include "product-tree.hh"
 #include "timer.hh"
 
 // Avoid macro collisions with TRUE/FALSE from MONA headers
@@ -29,10 +34,31 @@ namespace mamonata::mona::nfa {
 
 using State = mamonata::mtrobdd::NodeValue;
 using StateVector = std::vector<State>;
-using Symbol = size_t;
 using MataSymbolVector = std::vector<mamonata::mata::nfa::Symbol>;
-using EncodeDict = std::unordered_map<Symbol, mamonata::mtrobdd::BitVector>;
-using DecodeDict = std::unordered_map<mamonata::mtrobdd::BitVector, Symbol, mamonata::mtrobdd::BitVectorHash>;
+using ProductOptions = mamonata::ProductOptions;
+
+/**
+ * Transitions from a source to a target over the consecutive symbols first, first + 1, ..., last.
+ */
+struct SymbolInterval {
+    State source;
+    mamonata::mata::nfa::Symbol first;
+    mamonata::mata::nfa::Symbol last;
+    State target;
+
+    bool operator==(const SymbolInterval& other) const = default;
+};
+
+/**
+ * Options of the alphabet encoding optimizer (see Nfa::optimize_alphabet_encoding).
+ */
+struct EncodingOptimizerOptions {
+    bool group_by_signature = true; // Start from codes grouping symbols with equal targets
+    bool sift_variables = true;     // Try moving each alphabet variable to every position of the order
+    size_t window_size = 3;         // Size of windows of consecutive codes permuted exhaustively; 0 or 1 disables
+    size_t max_passes = 4;          // Maximum number of improving passes
+    size_t max_evaluations = 1000;  // Maximum number of evaluated candidate encodings
+};
 
 /**
  * Class exposing NFA functionality from MONA.
@@ -46,6 +72,11 @@ using DecodeDict = std::unordered_map<mamonata::mtrobdd::BitVector, Symbol, mamo
  * Obviously, we cannot operate on such pseudo-nondeterministic automata in MONA directly.
  * We allways convert them to deterministic automata first by projecting out the nondeterminism bits.
  *
+ * MONA's DFA package keeps global state and is not reentrant, so at most one thread may work with
+ * MONA automata at a time, including their conversions, copies and destruction. Callers running
+ * in parallel serialize their MONA work: balanced products (intersection_all(), union_all()) stay
+ * on one thread, Pipeline runs MONA nodes by add_serial() and mamonata-batch holds a lock.
+ *
  * Example of mona format:
  * TODO: add example
  *
@@ -59,31 +90,29 @@ private:
     size_t num_of_alphabet_vars;        // Number of variables for alphabet encoding
     size_t num_of_nondet_vars;          // Number of variables for nondeterminism encoding
     size_t nondeterminism_level;        // Level of nondeterminism (1 for deterministic automata)
-    size_t alphabet_size;               // Size of the alphabet
-    EncodeDict alphabet_encode_dict;    // Mapping from symbols to binary codes
-    DecodeDict alphabet_decode_dict;    // Mapping from binary codes to symbols
+    AlphabetEncodingPtr alphabet_encoding; // Shared mapping between symbols and binary codes
 
     /**
      * @brief Encodes a symbol into its binary representation.
      *
      * @param symbol Symbol to be encoded.
      *
-     * @return BitVector Binary representation of the symbol.
+     * @return Code Packed binary representation of the symbol.
      */
-    mamonata::mtrobdd::BitVector encode_symbol(const Symbol symbol) const {
-        assert(alphabet_encode_dict.contains(symbol));
-        return alphabet_encode_dict.at(symbol);
+    Code encode_symbol(const Symbol symbol) const {
+        assert(alphabet_encoding->encode(symbol) != AlphabetEncoding::NO_CODE);
+        return alphabet_encoding->encode(symbol);
     }
 
     /**
      * @brief Decodes a binary representation into its symbol.
      *
-     * @param code BitVector to be decoded.
+     * @param code Packed code to be decoded.
      *
-     * @return Symbol Decoded symbol.
+     * @return Symbol Decoded symbol, or AlphabetEncoding::NO_SYMBOL if the code is unused.
      */
-    Symbol decode_symbol(const mamonata::mtrobdd::BitVector& code) const {
-        return alphabet_decode_dict.at(code);
+    Symbol decode_symbol(const Code code) const {
+        return alphabet_encoding->decode(code);
     }
 
     /**
@@ -94,48 +123,136 @@ private:
      */
     void _print(const std::string &file_path = "") const;
 
+    /**
+     * @brief Builds the complete reduced MTROBDDs of the states in the range [begin, end).
+     *
+     * Minterms consist of alphabet bits followed by nondeterminism bits. Each target of the same
+     * symbol gets its own nondeterminism code. Assignments without a transition lead to the sink
+     * state input.num_of_states(), which is the virtual sink of the manager, so no node is stored for it
+     * (a state without transitions has the root NULL_NODE). The MTROBDD of each state is promoted
+     * to a root named by the state.
+     *
+     * @param input Mata NFA with a single initial state.
+     * @param encoding Alphabet encoding; symbols without a code are ignored.
+     * @param num_of_nondet_vars Number of nondeterminism variables.
+     * @param manager Arena with encoding.get_num_of_vars() + num_of_nondet_vars variables.
+     * @param begin First state to be built.
+     * @param end State after the last state to be built.
+     *
+     * @return true if some assignment leads to the sink state, false otherwise.
+     */
+    static bool build_state_mtrobdds(const mamonata::mata::nfa::Nfa& input, const AlphabetEncoding& encoding,
+                                     size_t num_of_nondet_vars, mamonata::mtrobdd::ArenaMtRobdd& manager,
+                                     State begin, State end);
+
+    /**
+     * @brief Ensures that an operand of a binary operation uses the same alphabet encoding.
+     * If the encodings are equal but not shared, this automaton starts sharing the encoding of the operand,
+     * so later operations compare only the pointers.
+     *
+     * @throws std::runtime_error If the encodings differ.
+     *
+     * @param other Second operand.
+     */
+    void check_alphabet_encoding(const Nfa& other);
+
+    /**
+     * @brief Searches the product of this automaton and another one for a reachable pair of states
+     * satisfying a condition on their finality. The product is explored breadth-first, directly
+     * on the MTROBDDs of both automata, without constructing it; codes that do not encode
+     * any symbol are skipped. Automata with nondeterminism variables are determinized first.
+     *
+     * @throws std::runtime_error If the automata use different alphabet encodings.
+     *
+     * @param other Second automaton of the product; may be this automaton.
+     * @param is_target Condition is_target(lhs_final, rhs_final) on the searched pair.
+     * @param witness If not null and a pair is found, set to a shortest word leading to the pair.
+     *
+     * @return true if a pair satisfying the condition is reachable, false otherwise.
+     */
+    bool find_product_witness(const Nfa& other, bool (*is_target)(bool, bool), MataSymbolVector* witness) const;
+
+    /**
+     * @brief Intersects the operands of intersection_all(), given as a span of copied automata
+     * or as a vector of automata taken over.
+     */
+    template<typename Operands>
+    static Nfa combine_intersection(Operands&& operands, const ProductOptions& options);
+
+    /**
+     * @brief Unites the operands of union_all(), given as a span of copied automata
+     * or as a vector of automata taken over.
+     */
+    template<typename Operands>
+    static Nfa combine_union(Operands&& operands, const ProductOptions& options);
+
 public:
+    /**
+     * @brief Computes the number of variables encoding the nondeterministic choices.
+     *
+     * @param nondeterminism_level Maximum number of targets of a state under a single symbol.
+     *
+     * @return Number of nondeterminism variables.
+     */
+    static size_t get_num_of_nondet_vars(const size_t nondeterminism_level) {
+        if (nondeterminism_level <= 1) {
+            return 0;
+        }
+        return static_cast<size_t>(std::ceil(std::log2(static_cast<double>(nondeterminism_level))));
+    }
+
     Nfa()
         : nfa_impl(nullptr),
           num_of_vars(0),
           num_of_alphabet_vars(0),
           num_of_nondet_vars(0),
           nondeterminism_level(0),
-          alphabet_size(0),
-          alphabet_encode_dict(),
-          alphabet_decode_dict() {}
+          alphabet_encoding() {}
 
     /**
      * @brief Constructs a new Nfa object from a Mata NFA.
      *
      * @param mata_nfa Mata NFA to be converted.
      * @param alphabet_order Optional order of symbols in the alphabet.
+     * @param num_of_threads Number of threads used by the conversion.
      *
      * @return Nfa Newly constructed Nfa object.
      */
-    explicit Nfa(const mata::nfa::Nfa& mata_nfa, const std::optional<MataSymbolVector>& alphabet_order = std::nullopt)
+    explicit Nfa(const mata::nfa::Nfa& mata_nfa, const std::optional<MataSymbolVector>& alphabet_order = std::nullopt,
+                 const size_t num_of_threads = 1)
         : nfa_impl(nullptr),
           num_of_vars(0),
           num_of_alphabet_vars(0),
           num_of_nondet_vars(0),
           nondeterminism_level(0),
-          alphabet_size(0),
-          alphabet_encode_dict(),
-          alphabet_decode_dict()
+          alphabet_encoding()
     {
-        from_mata(mata_nfa, alphabet_order);
+        from_mata(mata_nfa, alphabet_order, num_of_threads);
     }
 
-    // Copy constructor
-    Nfa(const Nfa& other)
-        : nfa_impl(dfaCopy(other.nfa_impl)),
-          num_of_vars(other.num_of_vars),
-          num_of_alphabet_vars(other.num_of_alphabet_vars),
-          num_of_nondet_vars(other.num_of_nondet_vars),
-          nondeterminism_level(other.nondeterminism_level),
-          alphabet_size(other.alphabet_size),
-          alphabet_encode_dict(other.alphabet_encode_dict),
-          alphabet_decode_dict(other.alphabet_decode_dict) {}
+    /**
+     * @brief Constructs a new Nfa object from a Mata NFA using a given alphabet encoding.
+     *
+     * @param mata_nfa Mata NFA to be converted.
+     * @param encoding Alphabet encoding shared with other operands.
+     * @param num_of_threads Number of threads used by the conversion.
+     *
+     * @return Nfa Newly constructed Nfa object.
+     */
+    Nfa(const mata::nfa::Nfa& mata_nfa, const AlphabetEncodingPtr& encoding, const size_t num_of_threads = 1)
+        : nfa_impl(nullptr),
+          num_of_vars(0),
+          num_of_alphabet_vars(0),
+          num_of_nondet_vars(0),
+          nondeterminism_level(0),
+          alphabet_encoding()
+    {
+        from_mata(mata_nfa, encoding, num_of_threads);
+    }
+
+    // Copies deep-copy the MONA DFA, so they are explicit (see clone()).
+    Nfa(const Nfa& other) = delete;
+    Nfa& operator=(const Nfa& other) = delete;
 
     // Move constructor
     Nfa(Nfa&& other) noexcept
@@ -144,9 +261,7 @@ public:
           num_of_alphabet_vars(other.num_of_alphabet_vars),
           num_of_nondet_vars(other.num_of_nondet_vars),
           nondeterminism_level(other.nondeterminism_level),
-          alphabet_size(other.alphabet_size),
-          alphabet_encode_dict(std::move(other.alphabet_encode_dict)),
-          alphabet_decode_dict(std::move(other.alphabet_decode_dict))
+          alphabet_encoding(std::move(other.alphabet_encoding))
     {
         other.nfa_impl = nullptr;
         other.nfa_impl = nullptr;
@@ -154,28 +269,6 @@ public:
         other.num_of_alphabet_vars = 0;
         other.num_of_nondet_vars = 0;
         other.nondeterminism_level = 0;
-        other.alphabet_size = 0;
-    }
-
-    // Copy assignment operator
-    Nfa& operator=(const Nfa& other) {
-        if (this == &other) {
-            return *this;
-        }
-
-        if (nfa_impl != nullptr) {
-            dfaFree(nfa_impl);
-        }
-        nfa_impl = dfaCopy(other.nfa_impl);
-        num_of_vars = other.num_of_vars;
-        num_of_alphabet_vars = other.num_of_alphabet_vars;
-        num_of_nondet_vars = other.num_of_nondet_vars;
-        nondeterminism_level = other.nondeterminism_level;
-        alphabet_size = other.alphabet_size;
-        alphabet_encode_dict = other.alphabet_encode_dict;
-        alphabet_decode_dict = other.alphabet_decode_dict;
-
-        return *this;
     }
 
     // Move assignment operator
@@ -192,16 +285,13 @@ public:
         num_of_alphabet_vars = other.num_of_alphabet_vars;
         num_of_nondet_vars = other.num_of_nondet_vars;
         nondeterminism_level = other.nondeterminism_level;
-        alphabet_size = other.alphabet_size;
-        alphabet_encode_dict = std::move(other.alphabet_encode_dict);
-        alphabet_decode_dict = std::move(other.alphabet_decode_dict);
+        alphabet_encoding = std::move(other.alphabet_encoding);
 
         other.nfa_impl = nullptr;
         other.num_of_vars = 0;
         other.num_of_alphabet_vars = 0;
         other.num_of_nondet_vars = 0;
         other.nondeterminism_level = 0;
-        other.alphabet_size = 0;
 
         return *this;
     }
@@ -215,6 +305,24 @@ public:
         }
     }
 
+    /**
+     * @brief Copies the automaton. The MONA DFA is deep-copied, the alphabet encoding stays shared.
+     *
+     * @return Copy of this automaton.
+     */
+    Nfa clone() const {
+        Nfa copy;
+        if (nfa_impl != nullptr) {
+            copy.nfa_impl = dfaCopy(nfa_impl);
+        }
+        copy.num_of_vars = num_of_vars;
+        copy.num_of_alphabet_vars = num_of_alphabet_vars;
+        copy.num_of_nondet_vars = num_of_nondet_vars;
+        copy.nondeterminism_level = nondeterminism_level;
+        copy.alphabet_encoding = alphabet_encoding;
+        return copy;
+    }
+
     /**
      * @brief Generates the alphabet symbols and their encodings.
      *
@@ -224,7 +332,8 @@ public:
 
     /**
      * @brief Updates the alphabet decoding to include codes from another NFA.
-     * Encodings that already exist are preserved (no updated).
+     * Encodings that already exist are preserved (no updated). The shared encoding is not modified;
+     * if codes are added, this NFA gets its own updated copy.
      *
      * @warning User must ensure that there are no conflicting encodings between the two NFAs.
      *
@@ -241,24 +350,121 @@ public:
      */
     Nfa& load(const std::string& file_path);
 
+    /**
+     * @brief Loads a MONA NFA from a file in the MaMONAta binary format (see save_binary).
+     * The file is memory-mapped and the BDD nodes are created directly from the stored node table,
+     * so no text is tokenized. A Mata NFA is obtained by calling to_mata() on the result.
+     *
+     * @throws std::runtime_error If the file cannot be mapped or is not a valid binary automaton.
+     *
+     * @param file_path Input file path.
+     *
+     * @return this
+     */
+    Nfa& load_binary(const std::filesystem::path& file_path);
+
     /**
      * @brief Initializes the MONA NFA by converting from a Mata NFA.
      *
      * @param input Mata NFA to be converted.
      * @param alphabet_order Optional order of symbols in the alphabet.
+     * @param num_of_threads Number of threads building the per-state MTROBDDs.
      *
      * @return this
      */
-    Nfa& from_mata(const mamonata::mata::nfa::Nfa& input, const std::optional<MataSymbolVector>& alphabet_order = std::nullopt);
+    Nfa& from_mata(const mamonata::mata::nfa::Nfa& input, const std::optional<MataSymbolVector>& alphabet_order = std::nullopt,
+                   size_t num_of_threads = 1);
+
+    /**
+     * @brief Initializes the MONA NFA by converting from a Mata NFA using a given alphabet encoding.
+     *
+     * Operands of binary operations must use the same encoding; see make_alphabet_encoding
+     * and optimize_alphabet_encoding. The encoding is shared, not copied.
+     *
+     * @param input Mata NFA to be converted.
+     * @param encoding Alphabet encoding; must not be null. Transitions over symbols without a code are ignored.
+     * @param num_of_threads Number of threads building the per-state MTROBDDs.
+     *
+     * @return this
+     */
+    Nfa& from_mata(const mamonata::mata::nfa::Nfa& input, const AlphabetEncodingPtr& encoding, size_t num_of_threads = 1);
+
+    /**
+     * @brief Searches for an alphabet encoding minimizing the MTROBDD nodes of the given automata.
+     *
+     * The number of shared MTROBDD nodes depends on which symbols get adjacent codes: symbols
+     * leading to the same targets should differ only in variables that can be skipped. The search
+     * starts from codes grouping symbols by their targets in all operands and improves them by
+     * sifting the alphabet variables (a variable order is a permutation of the code bits) and by
+     * permuting windows of consecutive codes. Nondeterminism variables always stay last.
+     * Each candidate is evaluated by building the MTROBDDs of all operands.
+     *
+     * @param operands Mata NFAs converted using the resulting encoding.
+     * @param alphabet Symbols to be encoded. If not given, the symbols used by the operands.
+     * @param options Limits of the search.
+     *
+     * @return Encoding with the minimum number of bits found with the fewest total nodes.
+     */
+    static AlphabetEncodingPtr optimize_alphabet_encoding(const std::vector<const mamonata::mata::nfa::Nfa*>& operands,
+                                                          const std::optional<MataSymbolVector>& alphabet = std::nullopt,
+                                                          const EncodingOptimizerOptions& options = {});
+
+    /**
+     * @brief Creates the encoding of the i-th symbol of the alphabet as i with the minimum number of bits.
+     *
+     * @param alphabet Symbols in the order of their codes.
+     *
+     * @return Encoding to be shared by automata over the alphabet.
+     */
+    static AlphabetEncodingPtr make_alphabet_encoding(const MataSymbolVector& alphabet);
+
+    // Returns the shared mapping between symbols and binary codes.
+    const AlphabetEncodingPtr& get_alphabet_encoding() const {
+        return alphabet_encoding;
+    }
+
+    /**
+     * @brief Checks if another automaton uses the same alphabet encoding.
+     * Shared encodings are recognized by a pointer comparison; others are compared entry by entry.
+     *
+     * @param other Automaton to be compared.
+     *
+     * @return true if symbols have the same codes in both automata, false otherwise.
+     */
+    bool has_same_alphabet_encoding(const Nfa& other) const {
+        if (alphabet_encoding == other.alphabet_encoding) {
+            return true;
+        }
+        return alphabet_encoding != nullptr && other.alphabet_encoding != nullptr &&
+               *alphabet_encoding == *other.alphabet_encoding;
+    }
 
     /**
      * @brief Converts the MONA NFA to a Mata NFA. With predefined encoding/decoding dictionaries.
      *
      * @warning All transitions with symbols that are not present in the decoding dictionary will be ignored.
      *
+     * @param num_of_threads Number of threads enumerating the transitions of states.
+     *
      * @return Mata NFA equivalent to this MONA NFA.
      */
-    mamonata::mata::nfa::Nfa to_mata() const;
+    mamonata::mata::nfa::Nfa to_mata(size_t num_of_threads = 1) const;
+
+    /**
+     * @brief Gets the transitions as maximal intervals of consecutive symbols.
+     *
+     * Symbols are grouped as by Mata's print_to_dot with use_intervals: one interval per maximal run
+     * of consecutive symbols leading from the same source to the same target. The work depends on
+     * the number of BDD paths and intervals, not on the size of the alphabet, whenever the encoding
+     * is dense (see AlphabetEncoding::for_each_symbol_run).
+     *
+     * @warning All transitions with symbols that are not present in the decoding dictionary will be ignored.
+     *
+     * @param num_of_threads Number of threads enumerating the transitions of states.
+     *
+     * @return Intervals sorted by their source, first symbol and target.
+     */
+    std::vector<SymbolInterval> get_symbol_intervals(size_t num_of_threads = 1) const;
 
     /**
      * @brief Saves the MONA NFA to a file
@@ -269,6 +475,21 @@ public:
         _print(file_path);
     }
 
+    /**
+     * @brief Saves the MONA NFA to a file in the MaMONAta binary format.
+     *
+     * The file consists of a versioned header followed by 8-byte aligned sections:
+     * the shared BDD node table in topological order (children precede parents),
+     * per-state root nodes, final flags and the alphabet encoding dictionary.
+     * All values are stored in native byte order; loading on a machine
+     * with a different byte order is rejected.
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     *
+     * @param file_path Output file path.
+     */
+    void save_binary(const std::filesystem::path& file_path) const;
+
     /**
      * @brief Saves the MONA representation of the NFA as a DOT file.
      *
@@ -320,6 +541,25 @@ public:
         mtrobdd_manager.print_as_dot();
     }
 
+    /**
+     * @brief Gets the number of states of the MONA DFA, including the sink state if present.
+     *
+     * @return Number of states.
+     */
+    size_t num_of_states() const {
+        return (nfa_impl == nullptr) ? 0 : static_cast<size_t>(nfa_impl->ns);
+    }
+
+    /**
+     * @brief Estimates the memory held by the NFA.
+     *
+     * Covers the DFA arrays (behaviours and final flags), the node table of the BDD manager
+     * and the alphabet encoding. An encoding shared with other automata is counted in full.
+     *
+     * @return Estimated memory in bytes.
+     */
+    size_t memory_footprint() const;
+
     /**
      * @brief Checks if the NFA is deterministic.
      *
@@ -336,9 +576,44 @@ public:
     /**
      * @brief Determinizes the NFA by projecting out nondeterminism bits.
      *
+     * All nondeterminism bits are quantified out in a single subset construction
+     * over the shared MTROBDD, instead of one MONA projection (with its own subset
+     * construction and minimization) per bit.
+     *
+     * @param minimize_result If true, the projected DFA is minimized as MONA's projection does.
+     *                        If false, the result of the subset construction is kept as is,
+     *                        which is comparable to Mata's determinization.
+     *
+     * @return Reference to this.
+     */
+    Nfa& determinize(bool minimize_result = true);
+
+    /**
+     * @brief Reduces the NFA by its maximal forward simulation.
+     *
+     * The simulation is refined over the MTROBDD behaviours of the states, i.e., over the atoms of the
+     * paths of the alphabet variables on which every behaviour is constant, without enumerating symbols.
+     * A worklist revisits only the pairs of states affected by a removal from the relation.
+     * Mutually similar states are merged and successors simulated by another successor on the same
+     * symbol are dropped, so the result usually needs fewer nondeterminism bits before determinize().
+     *
+     * @return Reference to this.
+     */
+    Nfa& reduce_simulation();
+
+    /**
+     * @brief Reduces the NFA to its canonical residual automaton.
+     *
+     * The NFA is determinized and minimized first; inclusion of the residual languages is the
+     * simulation of the minimal DFA, computed over the MTROBDD behaviours as in reduce_simulation().
+     * States whose language is the union of the languages strictly included in it are dropped and
+     * transitions to them are redirected to the maximal remaining states included in them. The initial
+     * state and the state with the empty language are kept, since MONA has a single initial state and
+     * a complete transition function. This corresponds to Mata's reduce_residual in the forward direction.
+     *
      * @return Reference to this.
      */
-    Nfa& determinize();
+    Nfa& reduce_residual();
 
     /**
      * @brief Minimizes the automaton using MONA's DFA minimization.
@@ -347,11 +622,25 @@ public:
      */
     Nfa& minimize();
 
+    /**
+     * @brief Minimizes the automaton by Hopcroft's partition refinement over its MTROBDD behaviours.
+     *
+     * Unlike minimize(), the algorithm runs on the shared MTROBDD transition function as Mata's
+     * minimize_hopcroft() runs on its transition relation. The transitions are grouped into atoms,
+     * the sets of symbols on which every state has a single successor, and only the blocks with
+     * predecessors in a queued splitter (a block and an atom) are split; of a split block, only the
+     * smaller half is queued. Besides the whole operation, the sessions `atoms`, `refinement` and
+     * `rebuild` are timed, recorded under the paths `minimize_hopcroft/atoms` and so on.
+     *
+     * @return Reference to this.
+     */
+    Nfa& minimize_hopcroft();
+
     /**
      * @brief Computes the union of this automaton with another automaton.
      * Uses MONA's DFA product construction with OR operation.
      *
-     * @warning User must ensure that both automata have the same alphabet encoding.
+     * @throws std::runtime_error If the automata use different alphabet encodings.
      *
      * @param aut Automaton to union with.
      *
@@ -359,11 +648,18 @@ public:
      */
     Nfa& union_det_complete(const Nfa& aut);
 
+    /**
+     * @brief Computes the union like union_det_complete(const Nfa&) and frees the DFA of the operand
+     * right after the product, so the operand is left empty. The operand is not copied, but it is
+     * freed only once the product has been built, so the peak memory is the same as with the const overload.
+     */
+    Nfa& union_det_complete(Nfa&& aut);
+
     /**
      * @brief Computes the intersection of this automaton with another automaton.
      * Uses MONA's DFA product construction with AND operation.
      *
-     * @warning User must ensure that both automata have the same alphabet encoding.
+     * @throws std::runtime_error If the automata use different alphabet encodings.
      *
      * @param aut Automaton to intersect with.
      *
@@ -371,6 +667,94 @@ public:
      */
     Nfa& intersection(const Nfa& aut);
 
+    /**
+     * @brief Computes the intersection like intersection(const Nfa&) and frees the DFA of the operand
+     * right after the product, so the operand is left empty. The operand is not copied, but it is
+     * freed only once the product has been built, so the peak memory is the same as with the const overload.
+     */
+    Nfa& intersection(Nfa&& aut);
+
+    /**
+     * @brief Computes the intersection of all given automata using MONA's product construction.
+     * The computation stops once a product is empty and large intermediate products are minimized
+     * (see ProductOptions). A balanced product tree is evaluated on a single thread regardless
+     * of options.num_of_threads (see the class documentation).
+     *
+     * @warning All operands must be deterministic (see determinize).
+     *
+     * @throws std::runtime_error If there are no operands or they use different alphabet encodings.
+     *
+     * @param operands Automata to intersect.
+     * @param options Shape of the product tree and minimization threshold.
+     *
+     * @return Intersection of the operands.
+     */
+    static Nfa intersection_all(std::span<const Nfa> operands, const ProductOptions& options = {});
+
+    /**
+     * @brief Computes the intersection of all given automata like intersection_all(std::span<const Nfa>, const ProductOptions&),
+     * but takes over the operands instead of copying them. Each operand is freed after the product using it.
+     */
+    static Nfa intersection_all(std::vector<Nfa>&& operands, const ProductOptions& options = {});
+
+    /**
+     * @brief Computes the union of all given automata using MONA's product construction.
+     * The computation stops once a product accepts every word and large intermediate products
+     * are minimized (see ProductOptions). A balanced product tree is evaluated on a single thread.
+     *
+     * @warning All operands must be deterministic (see determinize).
+     *
+     * @throws std::runtime_error If there are no operands or they use different alphabet encodings.
+     *
+     * @param operands Automata to union.
+     * @param options Shape of the product tree and minimization threshold.
+     *
+     * @return Union of the operands.
+     */
+    static Nfa union_all(std::span<const Nfa> operands, const ProductOptions& options = {});
+
+    /**
+     * @brief Computes the union of all given automata like union_all(std::span<const Nfa>, const ProductOptions&),
+     * but takes over the operands instead of copying them. Each operand is freed after the product using it.
+     */
+    static Nfa union_all(std::vector<Nfa>&& operands, const ProductOptions& options = {});
+
+    /**
+     * @brief Checks if the language of the automaton is empty.
+     *
+     * @param witness If not null and the language is nonempty, set to a shortest accepted word.
+     *
+     * @return true if the language is empty, false otherwise.
+     */
+    bool is_empty(MataSymbolVector* witness = nullptr) const;
+
+    /**
+     * @brief Checks if the language of this automaton is included in the language of another one.
+     * The product is explored on the fly and the search stops at the first counterexample.
+     *
+     * @throws std::runtime_error If the automata use different alphabet encodings.
+     *
+     * @param other Automaton with the including language.
+     * @param witness If not null and the language is not included, set to a shortest word
+     *                accepted by this automaton and rejected by the other one.
+     *
+     * @return true if the language is included, false otherwise.
+     */
+    bool is_included(const Nfa& other, MataSymbolVector* witness = nullptr) const;
+
+    /**
+     * @brief Checks if this automaton and another one accept the same language.
+     * The product is explored on the fly and the search stops at the first counterexample.
+     *
+     * @throws std::runtime_error If the automata use different alphabet encodings.
+     *
+     * @param other Automaton to compare with.
+     * @param witness If not null and the languages differ, set to a shortest word accepted by exactly one of them.
+     *
+     * @return true if the automata are equivalent, false otherwise.
+     */
+    bool are_equivalent(const Nfa& other, MataSymbolVector* witness = nullptr) const;
+
     /**
      * @brief Computes the complement of this automaton.
      *
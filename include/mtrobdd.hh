@@ -5,6 +5,7 @@
 #include <assert.h>
 #include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <unordered_set>
 #include <fstream>
@@ -12,6 +13,9 @@
 #include <iostream>
 #include <stack>
 #include <algorithm>
+#include <utility>
+#include "counters.hh"
+#include "memory-tracker.hh"
 
 
 extern "C" {
@@ -43,14 +47,46 @@ static constexpr VarIndex TERMINAL_INDEX = -1;
 static constexpr Bit HI = true;
 static constexpr Bit LO = false;
 
+/**
+ * Partial assignment of variables represented as a cube.
+ * Bit (num_of_vars - 1 - i) corresponds to variable i, i.e., the first variable
+ * is the most significant bit. Variables not set in care_mask are don't-cares
+ * and their bits in values are zero.
+ */
+struct Cube {
+    uint64_t values = 0;     // Assigned values of the cared variables.
+    uint64_t care_mask = 0;  // Variables tested on the path.
+};
+
+// Finalizer of SplitMix64: every input bit affects every output bit (avalanche).
+inline uint64_t mix_hash(uint64_t hash) {
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBull;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+// Combines a hash with the next value; the result depends on the order of the values.
+inline uint64_t combine_hash(const uint64_t hash, const uint64_t value) {
+    return mix_hash(hash * 0x9E3779B97F4A7C15ull + value);
+}
+
 // Implements a hash function for BitVector
 struct BitVectorHash {
     size_t operator()(const BitVector& bv) const {
-        size_t hash = 0;
-        for (const auto& bit : bv) {
-            hash = (hash << 1) ^ std::hash<Bit>()(bit);
+        // Eight bits are packed into a word before mixing, so no bit is shifted out.
+        uint64_t hash = mix_hash(bv.size());
+        uint64_t word = 0;
+        for (size_t i = 0; i < bv.size(); ++i) {
+            word = (word << 8) | bv[i];
+            if (i % 8 == 7) {
+                hash = combine_hash(hash, word);
+                word = 0;
+            }
         }
-        return hash;
+        return static_cast<size_t>(combine_hash(hash, word));
     }
 };
 
@@ -107,13 +143,17 @@ struct MtBddNode {
 };
 
 // Implements a hash function for MtBddNodePtr.
+// Children are aligned pointers, so their low bits are always zero; mixing spreads the other bits.
 struct NodePtrHash {
+    size_t operator()(const MtBddNode& node) const {
+        uint64_t hash = mix_hash(static_cast<uint32_t>(node.var_index));
+        hash = combine_hash(hash, reinterpret_cast<uintptr_t>(node.low.get()));
+        hash = combine_hash(hash, reinterpret_cast<uintptr_t>(node.high.get()));
+        return static_cast<size_t>(combine_hash(hash, node.value));
+    }
+
     size_t operator()(const MtBddNodePtr& node) const {
-        size_t h1 = std::hash<VarIndex>()(node->var_index);
-        size_t h2 = std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(node->low.get()));
-        size_t h3 = std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(node->high.get()));
-        size_t h4 = std::hash<NodeValue>()(node->value);
-        return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3);
+        return (*this)(*node);
     }
 };
 
@@ -126,11 +166,172 @@ struct NodePtrEqual {
     }
 };
 
-using NodeSet = std::unordered_set<MtBddNodePtr, NodePtrHash, NodePtrEqual>;
+// Lengths of the probe sequences of the keys stored in an open-addressing table.
+struct ProbeStatistics {
+    size_t num_of_keys = 0;         // Number of stored keys.
+    size_t capacity = 0;            // Number of slots.
+    double mean_probe_length = 0;   // Average number of slots visited to find a stored key (1 = home slot).
+    size_t max_probe_length = 0;    // Longest probe sequence of a stored key.
+};
+
+/**
+ * Unique table of MtRobdd: an open-addressing hash set of nodes compared by their fields.
+ *
+ * Nodes are stored in a power-of-two array of slots with linear probing, kept at most half full.
+ * Erasing a node shifts the following nodes of its probe sequence back, so no tombstones are left.
+ * Inserting and erasing invalidate iterators.
+ */
+class NodeTable {
+    std::vector<MtBddNodePtr> slots;    // nullptr marks an empty slot.
+    size_t num_of_nodes = 0;
+
+    // Returns the slot holding a node equal to the given one, or the empty slot where it belongs.
+    size_t find_slot(const MtBddNode& node) const;
+
+    // Moves all nodes into a new array of the given number of slots (a power of two).
+    void rehash(size_t capacity);
+
+    // Empties a slot and shifts the following nodes of the probe sequence back.
+    void erase_slot(size_t slot);
+
+public:
+    class const_iterator {
+        friend class NodeTable;
+        const MtBddNodePtr* slot = nullptr;
+        const MtBddNodePtr* end = nullptr;
+
+        const_iterator(const MtBddNodePtr* slot, const MtBddNodePtr* end) : slot(slot), end(end) {
+            skip_empty();
+        }
+
+        void skip_empty() {
+            while (slot != end && *slot == nullptr) {
+                ++slot;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = MtBddNodePtr;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const MtBddNodePtr*;
+        using reference = const MtBddNodePtr&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return *slot;
+        }
+
+        pointer operator->() const {
+            return slot;
+        }
+
+        const_iterator& operator++() {
+            ++slot;
+            skip_empty();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return slot == other.slot;
+        }
+    };
+    using iterator = const_iterator;
+
+    NodeTable() = default;
+    NodeTable(const NodeTable&) = default;
+    NodeTable& operator=(const NodeTable&) = default;
+
+    NodeTable(NodeTable&& other) noexcept
+        : slots(std::move(other.slots)), num_of_nodes(std::exchange(other.num_of_nodes, 0)) {
+        other.slots.clear();
+    }
+
+    NodeTable& operator=(NodeTable&& other) noexcept {
+        slots = std::move(other.slots);
+        num_of_nodes = std::exchange(other.num_of_nodes, 0);
+        other.slots.clear();
+        return *this;
+    }
+
+    const_iterator begin() const {
+        return const_iterator(slots.data(), slots.data() + slots.size());
+    }
+
+    const_iterator end() const {
+        return const_iterator(slots.data() + slots.size(), slots.data() + slots.size());
+    }
+
+    size_t size() const {
+        return num_of_nodes;
+    }
+
+    bool empty() const {
+        return num_of_nodes == 0;
+    }
+
+    void clear() {
+        slots.clear();
+        num_of_nodes = 0;
+    }
+
+    // Finds a node equal to the given one.
+    const_iterator find(const MtBddNodePtr& node) const;
+
+    // Checks if a node equal to the given one is stored.
+    bool contains(const MtBddNodePtr& node) const {
+        return find(node) != end();
+    }
+
+    /**
+     * Inserts a node unless an equal node is stored.
+     *
+     * @return Iterator to the stored node and true if the given node was inserted.
+     */
+    std::pair<const_iterator, bool> insert(MtBddNodePtr node);
+
+    // Erases the node at the iterator.
+    void erase(const_iterator it);
+
+    // Erases the node equal to the given one; returns the number of erased nodes.
+    size_t erase(const MtBddNodePtr& node);
+
+    // Returns the probe lengths of all stored nodes.
+    ProbeStatistics get_probe_statistics() const;
+
+    // Returns estimated memory in bytes held by the slots (excluding the nodes).
+    size_t memory_footprint() const {
+        return mamonata::memory::vector_footprint(slots);
+    }
+};
+
+using NodeSet = NodeTable;
 using NameToNodeMap = std::unordered_map<NodeName, MtBddNodePtr>;
 using NameToMonaNodeMap = std::unordered_map<NodeName, bdd_ptr>;
 using NodeToNameMap = std::unordered_map<MtBddNodePtr, NodeName, NodePtrHash, NodePtrEqual>;
 
+/**
+ * Replaces an empty MONA BDD manager, e.g., of a DFA created by dfaMake, by one whose tables
+ * fit the given number of nodes, so exporting an MTROBDD never grows and rehashes them.
+ * dfaMake sizes the manager by the number of states only.
+ *
+ * @param bddm Manager without nodes; replaced by the new manager.
+ * @param num_of_nodes Number of nodes (including leaves) to be created.
+ */
+inline void reserve_mona_nodes(bdd_manager*& bddm, const size_t num_of_nodes) {
+    bdd_kill_manager(bddm);
+    // Twice the number of nodes keeps the load of the unique table at most 1/2.
+    const unsigned size = static_cast<unsigned>(std::max<size_t>(2 * num_of_nodes, 16));
+    bddm = bdd_new_manager(size, ((size / 4 + 3) / 4) * 4);
+}
+
 // Multi-Terminal Reduced Ordered Binary Decision Diagram (MTROBDD).
 class MtRobdd
 {
@@ -145,6 +346,50 @@ class MtRobdd
      */
     void _print_as_dot(std::ostream& os) const;
 
+    /**
+     * Creates a node in reduced form: a test with equal children is skipped.
+     *
+     * @param var_index Variable index of the node.
+     * @param low Pointer to LOW child node.
+     * @param high Pointer to HIGH child node.
+     *
+     * @return Pointer to the created or existing node, or to the child if both children are equal.
+     */
+    MtBddNodePtr create_reduced_node(const VarIndex var_index, const MtBddNodePtr& low, const MtBddNodePtr& high) {
+        if (low == high) {
+            return low;
+        }
+        return create_node(var_index, low, high);
+    }
+
+    /**
+     * Redirects the path of a full assignment below a node to a terminal node.
+     *
+     * @param node Node representing the function of the variables from var_index on; nullptr if undefined.
+     * @param var_index Current variable index in the bit string.
+     * @param bit_string Full assignment of all variables.
+     * @param terminal Terminal node reached by the assignment; nullptr removes the assignment.
+     *
+     * @return Node representing the updated function in reduced form.
+     */
+    MtBddNodePtr update_bit_string(const MtBddNodePtr& node, VarIndex var_index, const BitVector& bit_string, const MtBddNodePtr& terminal);
+
+    /**
+     * Replaces the node of a root and releases the nodes no longer referenced.
+     *
+     * @param name Name of the root node.
+     * @param node New node of the root; nullptr removes the root.
+     */
+    void replace_root(NodeName name, MtBddNodePtr node);
+
+    /**
+     * Removes a node from the unique table if nothing but the table refers to it, and continues
+     * with its children. References held outside of the MTROBDD keep a node alive.
+     *
+     * @param node Node to be released.
+     */
+    void release_node(MtBddNodePtr node);
+
 public:
     MtRobdd() : num_of_vars(0), nodes(), root_nodes_map() {}
 
@@ -184,6 +429,11 @@ public:
     /**
      * Converts the MTROBDD to MONA BDD manager.
      *
+     * Nodes reachable from the roots are numbered bottom-up by levels (terminals first, then the
+     * variables from the last one), so the MONA nodes are created sequentially, children before
+     * their parents, without recursion. Positions depend only on the diagram, not on the hash order.
+     * The manager may be sized by reserve_mona_nodes(bddm, get_num_of_nodes()) before.
+     *
      * @param bddm Pointer to the MONA BDD manager to convert to.
      * @param root_behavior_ptrs Array to store root node pointers.
      *                           Note: The caller is responsible for allocating and freeing this array.
@@ -205,6 +455,19 @@ public:
         return root_nodes_map.size();
     }
 
+    // Returns estimated memory in bytes held by the nodes (allocated by make_shared), the unique table and the root map.
+    size_t memory_footprint() const {
+        // make_shared stores the node next to a control block of two reference counters.
+        constexpr size_t node_bytes = sizeof(MtBddNode) + 2 * sizeof(long);
+        return sizeof(MtRobdd) + nodes.size() * node_bytes + nodes.memory_footprint() +
+               mamonata::memory::hash_container_footprint(root_nodes_map);
+    }
+
+    // Returns the probe lengths of the nodes in the unique table.
+    ProbeStatistics get_unique_table_statistics() const {
+        return nodes.get_probe_statistics();
+    }
+
     /**
      * Creates MTROBDD node. If an identical node already exists, returns the existing one.
      *
@@ -216,9 +479,11 @@ public:
      * @return Pointer to the created or existing MtBddNode.
      */
     MtBddNodePtr create_node(VarIndex var_index, const MtBddNodePtr low = nullptr, const MtBddNodePtr high = nullptr, NodeValue value = MAX_NODE_VALUE) {
+        COUNT(CREATE_NODE_CALLS, 1);
         MtBddNodePtr new_node = std::make_shared<MtBddNode>(var_index, low, high, value);
         auto it = nodes.find(new_node);
         if (it != nodes.end()) {
+            COUNT(UNIQUE_TABLE_HITS, 1);
             return *it;
         }
         nodes.insert(new_node);
@@ -323,6 +588,42 @@ public:
         return new_root;
     }
 
+    /**
+     * Sets the terminal reached by a full assignment in the behaviour of a root, e.g., adds a transition.
+     *
+     * Only the path of the assignment is rebuilt. The diagram stays reduced (tests with equal
+     * children are skipped) and nodes no longer reachable are released by reference counting,
+     * so no trim() is needed. The diagram must be reduced before, e.g., built by this method,
+     * converted from MONA or processed by remove_redundant_tests().
+     *
+     * @param root_name Name of the root node; a missing root is created.
+     * @param bit_string Full assignment of all variables.
+     * @param terminal_value Value for the terminal node.
+     *
+     * @return Pointer to the new root node.
+     */
+    MtBddNodePtr set_bit_string(NodeName root_name, const BitVector& bit_string, NodeValue terminal_value);
+
+    /**
+     * Removes a full assignment from the behaviour of a root, e.g., removes a transition.
+     * The root is removed when no assignment is left. See set_bit_string() for the incremental mode.
+     *
+     * @param root_name Name of the root node.
+     * @param bit_string Full assignment of all variables.
+     *
+     * @return Pointer to the new root node, or nullptr if the root was removed.
+     */
+    MtBddNodePtr remove_bit_string(NodeName root_name, const BitVector& bit_string);
+
+    /**
+     * Removes a root and releases the nodes reachable only from it.
+     *
+     * @param root_name Name of the root node.
+     */
+    void remove_root(const NodeName root_name) {
+        replace_root(root_name, nullptr);
+    }
+
     /**
      * Gets all bit strings leading to terminal nodes from a given node.
      *
@@ -332,6 +633,37 @@ public:
      */
     std::vector<std::pair<BitVector, NodeValue>> get_all_bit_strings_from_root_node(const MtBddNodePtr node) const;
 
+    /**
+     * Streams all paths from a given node to terminal nodes as cubes.
+     * Skipped variables are reported as don't-cares instead of being expanded,
+     * and no memory is allocated per path.
+     *
+     * @warning Supports at most 64 variables.
+     *
+     * @param node Pointer to the starting MtBddNode.
+     * @param callback Callable invoked as callback(const Cube&, NodeValue) for each path.
+     */
+    template<typename Callback>
+    void for_each_cube(const MtBddNodePtr& node, Callback&& callback) const {
+        assert(num_of_vars <= 64);
+        auto visit = [&](auto& self, const MtBddNode* current, Cube cube) -> void {
+            if (current->is_terminal()) {
+                callback(static_cast<const Cube&>(cube), current->value);
+                return;
+            }
+            const uint64_t var_bit = uint64_t{1} << (num_of_vars - 1 - current->var_index);
+            cube.care_mask |= var_bit;
+            if (current->low != nullptr) {
+                self(self, current->low.get(), cube);
+            }
+            if (current->high != nullptr) {
+                cube.values |= var_bit;
+                self(self, current->high.get(), cube);
+            }
+        };
+        visit(visit, node.get(), Cube{});
+    }
+
     /**
      * Trims the MTROBDD by removing nodes that are not reachable from any root node.
      *
@@ -349,6 +681,7 @@ public:
     /**
      * Makes the MTROBDD complete by ensuring all nodes have both LOW and HIGH children.
      * Missing children are connected to a sink terminal node with the specified value.
+     * Completed nodes are created anew, so nodes equal after completion are merged.
      *
      * @param sink_value Value for the sink terminal node.
      * @param complete_terminal_nodes If true, also ensure terminal nodes are included as roots.
@@ -0,0 +1,63 @@
+#ifndef MAMONATA_PARALLEL_HH_
+#define MAMONATA_PARALLEL_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "counters.hh"
+
+namespace mamonata {
+
+/**
+ * @brief Splits [0, size) into contiguous ranges and processes each range by its own thread.
+ * With a single worker, the task runs on the calling thread. Exceptions thrown by any
+ * worker are rethrown after all workers have finished. Counts of the workers are added
+ * to the calling thread, so they belong to its running timing session.
+ *
+ * @param size Number of items.
+ * @param num_of_workers Number of workers; at most size workers are used.
+ * @param task Callable invoked as task(begin, end, worker_index).
+ */
+template<typename Task>
+void run_in_parallel(const size_t size, size_t num_of_workers, Task&& task) {
+    num_of_workers = std::max<size_t>(1, std::min(num_of_workers, size));
+    if (num_of_workers == 1) {
+        task(size_t{0}, size, size_t{0});
+        return;
+    }
+
+    std::vector<std::exception_ptr> exceptions(num_of_workers);
+    std::vector<Counters::Values> worker_counters(num_of_workers);
+    std::vector<std::thread> workers;
+    workers.reserve(num_of_workers);
+    for (size_t worker = 0; worker < num_of_workers; ++worker) {
+        const size_t begin = size * worker / num_of_workers;
+        const size_t end = size * (worker + 1) / num_of_workers;
+        workers.emplace_back([&, begin, end, worker]() {
+            const Counters::Values start_counters = Counters::get_local();
+            try {
+                task(begin, end, worker);
+            } catch (...) {
+                exceptions[worker] = std::current_exception();
+            }
+            worker_counters[worker] = Counters::difference(Counters::get_local(), start_counters);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const Counters::Values& counters : worker_counters) {
+        Counters::merge(counters);
+    }
+    for (const std::exception_ptr& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+} // namespace mamonata
+
+#endif // MAMONATA_PARALLEL_HH_
@@ -0,0 +1,318 @@
+#ifndef MAMONATA_PIPELINE_HH_
+#define MAMONATA_PIPELINE_HH_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "clone.hh"
+#include "timer.hh"
+#include "work-stealing-pool.hh"
+
+namespace mamonata {
+
+/**
+ * @brief DAG of operations, e.g., of both bridges, running on a work-stealing pool.
+ *
+ * Every node computes a value from the values of its input nodes and runs as soon as all inputs
+ * are computed, so independent steps (parsing, conversions and determinization of different
+ * operands) overlap. Every run is timed by a Timer::Span labelled by the node.
+ *
+ * Functions receive the values of their inputs by value. The last node using a value gets it moved
+ * and the value is released by its producer, so an intermediate is freed as soon as no later node
+ * needs it; earlier users get copies (by clone() for move-only automata). Values of outputs
+ * (see get_future()) are kept and copied.
+ *
+ * Nodes calling MONA are added by add_serial() (see mona::nfa::Nfa on threads): serial nodes
+ * run one at a time, concurrently with the other nodes. Ready serial nodes wait in a queue instead
+ * of occupying workers; the next one is submitted when the running one finishes. Nodes taking or producing MONA automata
+ * should be serial, since the automata are copied and freed by MONA as well.
+ *
+ * An exception thrown by a node fails all nodes depending on it without running them;
+ * futures of failed nodes rethrow the exception.
+ *
+ *     Pipeline pipeline(4);
+ *     auto a = pipeline.add("load_a", [&]() { MataNfa nfa; nfa.load(path_a); return nfa; });
+ *     auto mona_a = pipeline.add_serial("from_mata_a", [&](MataNfa nfa) { return MonaNfa(nfa, encoding); }, a);
+ *     std::shared_future<MonaNfa> result = pipeline.get_future(mona_a);
+ *     pipeline.run();
+ *     result.get();
+ */
+class Pipeline {
+    struct NodeBase {
+        std::string label;
+        bool is_serial = false;
+        bool is_output = false;
+        std::vector<NodeBase*> dependents;              // Nodes using the value, once per use.
+        std::atomic<size_t> num_of_pending_inputs = 0;  // Uses of inputs not yet computed.
+        std::mutex mutex;                               // Guards the value and the number of pending uses.
+        size_t num_of_pending_uses = 0;                 // Uses of the value by nodes not yet started.
+        std::exception_ptr error;                       // Exception of the node or of one of its inputs.
+        std::function<void()> run;                      // Computes the value or records the error.
+
+        virtual ~NodeBase() = default;
+        virtual void release_value() = 0;
+    };
+
+    template<typename T>
+    struct NodeState : NodeBase {
+        std::optional<T> value;  // Value for later uses; outputs keep it in the future instead.
+        std::promise<T> promise;
+        std::shared_future<T> future;
+
+        void release_value() override {
+            value.reset();
+        }
+    };
+
+public:
+    // Handle of a node producing a value of type T.
+    template<typename T>
+    class Node {
+        friend class Pipeline;
+        std::shared_ptr<NodeState<T>> state;
+
+        explicit Node(std::shared_ptr<NodeState<T>> state) : state(std::move(state)) {}
+
+    public:
+        Node() = default;
+
+        const std::string& get_label() const {
+            return state->label;
+        }
+    };
+
+private:
+    std::vector<std::shared_ptr<NodeBase>> nodes;
+    std::mutex serial_mutex;                // Guards the serial queue and is_serial_running.
+    std::deque<NodeBase*> serial_queue;     // Ready serial nodes waiting for the running one.
+    bool is_serial_running = false;
+    bool is_running = false;
+    // Declared last, so its workers finish before the nodes are destroyed.
+    WorkStealingPool pool;
+
+    // Gets the value of an input for a starting node; the last use takes the value and releases it.
+    template<typename T>
+    static T take_input(NodeState<T>& input) {
+        std::lock_guard<std::mutex> lock(input.mutex);
+        --input.num_of_pending_uses;
+        if (input.is_output) {
+            return clone(input.future.get());
+        }
+        assert(input.value.has_value());
+        if (input.num_of_pending_uses == 0) {
+            T value = std::move(*input.value);
+            input.value.reset();
+            return value;
+        }
+        return clone(*input.value);
+    }
+
+    // Drops a use of an input by a node that does not run.
+    static void release_input(NodeBase& input) {
+        std::lock_guard<std::mutex> lock(input.mutex);
+        if (--input.num_of_pending_uses == 0) {
+            input.release_value();
+        }
+    }
+
+    template<typename T>
+    static void store(NodeState<T>& node, T&& value) {
+        std::lock_guard<std::mutex> lock(node.mutex);
+        if (node.is_output) {
+            node.promise.set_value(std::move(value));
+        } else if (node.num_of_pending_uses > 0) {
+            node.value.emplace(std::move(value));
+        }
+    }
+
+    template<typename T>
+    static void fail(NodeState<T>& node, const std::exception_ptr& error) {
+        std::lock_guard<std::mutex> lock(node.mutex);
+        node.error = error;
+        if (node.is_output) {
+            node.promise.set_exception(error);
+        }
+    }
+
+    void schedule(NodeBase& node) {
+        if (node.is_serial) {
+            std::lock_guard<std::mutex> lock(serial_mutex);
+            if (is_serial_running) {
+                serial_queue.push_back(&node);
+                return;
+            }
+            is_serial_running = true;
+        }
+        submit(node);
+    }
+
+    void submit(NodeBase& node) {
+        pool.submit([this, &node]() {
+            node.run();
+            if (node.is_serial) {
+                // Hand the turn over to the next ready serial node, if any.
+                NodeBase* next = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(serial_mutex);
+                    if (serial_queue.empty()) {
+                        is_serial_running = false;
+                    } else {
+                        next = serial_queue.front();
+                        serial_queue.pop_front();
+                    }
+                }
+                if (next != nullptr) {
+                    submit(*next);
+                }
+            }
+            for (NodeBase* dependent : node.dependents) {
+                if (--dependent->num_of_pending_inputs == 0) {
+                    schedule(*dependent);
+                }
+            }
+        });
+    }
+
+    template<typename F, typename... Inputs>
+    auto add_node(std::string label, const bool is_serial, F&& function, const Node<Inputs>&... inputs)
+        -> Node<std::invoke_result_t<std::decay_t<F>&, Inputs...>> {
+        using T = std::invoke_result_t<std::decay_t<F>&, Inputs...>;
+        static_assert(!std::is_void_v<T>, "Nodes of a pipeline must produce a value.");
+        if (is_running) {
+            throw std::runtime_error("Nodes cannot be added to a running pipeline.");
+        }
+
+        auto state = std::make_shared<NodeState<T>>();
+        state->label = std::move(label);
+        state->is_serial = is_serial;
+        state->future = state->promise.get_future().share();
+        state->num_of_pending_inputs = sizeof...(Inputs);
+        NodeState<T>* node = state.get();
+        ([&](NodeBase& input) {
+            input.dependents.push_back(node);
+            ++input.num_of_pending_uses;
+        }(*inputs.state), ...);
+
+        state->run = [this, node, function = std::forward<F>(function), inputs = std::make_tuple(inputs.state...)]() mutable {
+            // Serial nodes also copy and release their inputs in their turn, as they may hold MONA automata.
+            std::exception_ptr input_error;
+            std::apply([&](const auto&... input) { ((input_error = input_error ? input_error : input->error), ...); }, inputs);
+            if (input_error) {
+                std::apply([](const auto&... input) { (release_input(*input), ...); }, inputs);
+                fail(*node, input_error);
+                return;
+            }
+            try {
+                Timer::Span span(node->label);
+                T value = std::apply([&](const auto&... input) { return function(take_input(*input)...); }, inputs);
+                span.stop();
+                store(*node, std::move(value));
+            } catch (...) {
+                fail(*node, std::current_exception());
+            }
+        };
+        nodes.push_back(state);
+        return Node<T>(std::move(state));
+    }
+
+public:
+    /**
+     * @brief Creates an empty pipeline.
+     *
+     * @param num_of_threads Number of worker threads; 0 uses the number of hardware threads.
+     */
+    explicit Pipeline(const size_t num_of_threads = 0) : pool(num_of_threads) {}
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // Finishes all started nodes.
+    ~Pipeline() = default;
+
+    /**
+     * @brief Adds a node computing function(input values...).
+     *
+     * @param label Label of the node, used as the label of its timing session.
+     * @param function Callable receiving the values of the inputs by value.
+     * @param inputs Nodes of this pipeline; a node may be used several times.
+     *
+     * @throws std::runtime_error If the pipeline is running.
+     *
+     * @return Handle of the new node.
+     */
+    template<typename F, typename... Inputs>
+    auto add(std::string label, F&& function, const Node<Inputs>&... inputs) {
+        return add_node(std::move(label), false, std::forward<F>(function), inputs...);
+    }
+
+    /**
+     * @brief Adds a node like add() that runs only when no other serial node runs, e.g., a MONA operation.
+     */
+    template<typename F, typename... Inputs>
+    auto add_serial(std::string label, F&& function, const Node<Inputs>&... inputs) {
+        return add_node(std::move(label), true, std::forward<F>(function), inputs...);
+    }
+
+    /**
+     * @brief Makes a node an output of the pipeline; its value is kept until the pipeline is destroyed.
+     *
+     * @throws std::runtime_error If the pipeline is running.
+     *
+     * @return Future of the value of the node.
+     */
+    template<typename T>
+    std::shared_future<T> get_future(const Node<T>& node) {
+        if (is_running) {
+            throw std::runtime_error("Outputs cannot be added to a running pipeline.");
+        }
+        node.state->is_output = true;
+        return node.state->future;
+    }
+
+    /**
+     * @brief Starts all nodes without inputs; the other nodes start when their inputs are computed.
+     * Returns without waiting; see wait() and the futures of the outputs.
+     *
+     * @throws std::runtime_error If the pipeline was already started.
+     */
+    void run() {
+        if (is_running) {
+            throw std::runtime_error("The pipeline is already running.");
+        }
+        is_running = true;
+        // Collect the sources first; finished sources already schedule their dependents.
+        std::vector<NodeBase*> sources;
+        for (const std::shared_ptr<NodeBase>& node : nodes) {
+            if (node->num_of_pending_inputs == 0) {
+                sources.push_back(node.get());
+            }
+        }
+        for (NodeBase* source : sources) {
+            schedule(*source);
+        }
+    }
+
+    /**
+     * @brief Blocks until all nodes have finished. Exceptions of nodes are rethrown by the futures only.
+     */
+    void wait() {
+        pool.wait();
+    }
+};
+
+} // namespace mamonata
+
+#endif // MAMONATA_PIPELINE_HH_
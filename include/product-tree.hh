@@ -0,0 +1,145 @@
+#ifndef MAMONATA_PRODUCT_TREE_HH_
+#define MAMONATA_PRODUCT_TREE_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "clone.hh"
+#include "parallel.hh"
+
+namespace mamonata {
+
+/**
+ * Options of n-ary products (intersection_all and union_all) of both bridges.
+ */
+struct ProductOptions {
+    // Intermediate results with more states are reduced (minimized); 0 reduces all of them.
+    size_t reduce_threshold = 256;
+    // If true, operands are combined in a balanced tree instead of a left fold.
+    bool balanced = false;
+    // Number of threads combining independent pairs of a balanced tree.
+    size_t num_of_threads = 1;
+};
+
+/**
+ * @brief Combines automata by an associative and commutative product.
+ *
+ * Operands are ordered by their number of states, so the smallest automata are combined first.
+ * An intermediate result larger than the reduce threshold is reduced before it is combined
+ * further; the final result is not reduced. The computation stops as soon as a result is
+ * absorbing, i.e., combining it with any other automaton would not change its language
+ * (for example, an empty intersection).
+ *
+ * @throws std::runtime_error If there are no operands.
+ *
+ * @param order Automata to be combined; constant automata are copied, the others are moved from.
+ * @param options Shape of the product and reduction threshold.
+ * @param get_size Callable returning the number of states of an automaton.
+ * @param combine Callable combine(Nfa& lhs, const Nfa& rhs) storing the product into lhs.
+ * @param reduce Callable reducing an intermediate result in place.
+ * @param is_absorbing Callable checking whether a result is absorbing.
+ * @param allow_parallel Whether the callables may run concurrently on distinct automata.
+ *
+ * @return Product of all operands.
+ */
+template<typename Nfa, typename Operand, typename GetSize, typename Combine, typename Reduce, typename IsAbsorbing>
+Nfa combine_operands(std::vector<Operand*> order, const ProductOptions& options, GetSize&& get_size,
+                     Combine&& combine, Reduce&& reduce, IsAbsorbing&& is_absorbing, const bool allow_parallel) {
+    if (order.empty()) {
+        throw std::runtime_error("Product of no automata");
+    }
+
+    auto take = [](Operand* operand) -> Nfa {
+        if constexpr (std::is_const_v<Operand>) {
+            return clone(*operand);
+        } else {
+            return std::move(*operand);
+        }
+    };
+
+    std::stable_sort(order.begin(), order.end(), [&](const Operand* lhs, const Operand* rhs) {
+        return get_size(*lhs) < get_size(*rhs);
+    });
+
+    auto combine_intermediate = [&](Nfa& lhs, const Nfa& rhs, const bool is_last) {
+        combine(lhs, rhs);
+        if (!is_last && get_size(lhs) > options.reduce_threshold) {
+            reduce(lhs);
+        }
+    };
+
+    if (!options.balanced) {
+        Nfa result = take(order.front());
+        for (size_t i = 1; i < order.size() && !is_absorbing(result); ++i) {
+            combine_intermediate(result, *order[i], i + 1 == order.size());
+        }
+        return result;
+    }
+
+    // Balanced tree: neighbours in the size order are combined pairwise, level by level.
+    std::vector<Nfa> level;
+    level.reserve(order.size());
+    for (Operand* operand : order) {
+        level.push_back(take(operand));
+    }
+    while (level.size() > 1) {
+        const size_t num_of_pairs = level.size() / 2;
+        const bool is_last = (level.size() == 2);
+        // Counts of the workers are added to the calling thread.
+        run_in_parallel(num_of_pairs, allow_parallel ? options.num_of_threads : 1, [&](const size_t begin, const size_t end, size_t) {
+            for (size_t pair = begin; pair < end; ++pair) {
+                combine_intermediate(level[2 * pair], level[2 * pair + 1], is_last);
+            }
+        });
+
+        std::vector<Nfa> next_level;
+        next_level.reserve(num_of_pairs + 1);
+        for (size_t pair = 0; pair < num_of_pairs; ++pair) {
+            if (is_absorbing(level[2 * pair])) {
+                return std::move(level[2 * pair]);
+            }
+            next_level.push_back(std::move(level[2 * pair]));
+        }
+        if (level.size() % 2 == 1) {
+            next_level.push_back(std::move(level.back()));
+        }
+        level = std::move(next_level);
+    }
+    return std::move(level.front());
+}
+
+/**
+ * @brief Combines copies of the operands; see combine_operands() for the parameters.
+ */
+template<typename Nfa, typename GetSize, typename Combine, typename Reduce, typename IsAbsorbing>
+Nfa combine_all(const std::span<const Nfa> operands, const ProductOptions& options, GetSize&& get_size,
+                Combine&& combine, Reduce&& reduce, IsAbsorbing&& is_absorbing, const bool allow_parallel) {
+    std::vector<const Nfa*> order;
+    order.reserve(operands.size());
+    for (const Nfa& operand : operands) {
+        order.push_back(&operand);
+    }
+    return combine_operands<Nfa>(std::move(order), options, get_size, combine, reduce, is_absorbing, allow_parallel);
+}
+
+/**
+ * @brief Combines the operands without copying them; the operands are left moved from.
+ * See combine_operands() for the parameters.
+ */
+template<typename Nfa, typename GetSize, typename Combine, typename Reduce, typename IsAbsorbing>
+Nfa combine_all(std::vector<Nfa>&& operands, const ProductOptions& options, GetSize&& get_size,
+                Combine&& combine, Reduce&& reduce, IsAbsorbing&& is_absorbing, const bool allow_parallel) {
+    std::vector<Nfa*> order;
+    order.reserve(operands.size());
+    for (Nfa& operand : operands) {
+        order.push_back(&operand);
+    }
+    return combine_operands<Nfa>(std::move(order), options, get_size, combine, reduce, is_absorbing, allow_parallel);
+}
+
+} // namespace mamonata
+
+#endif // MAMONATA_PRODUCT_TREE_HH_
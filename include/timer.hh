@@ -1,43 +1,203 @@
 #ifndef TIMER_HH_
 #define TIMER_HH_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+#include "counters.hh"
 
+#define TIMER_CONCAT_IMPL(a, b) a##b
+#define TIMER_CONCAT(a, b) TIMER_CONCAT_IMPL(a, b)
+#define TIMER_SPAN_NAME TIMER_CONCAT(timer_span_, __LINE__)
 
 // Enable timing only if TIMING_ENABLED is defined
 #ifdef TIMING_ENABLED
 // Measure execution time of a code line.
 // Distinguish different timing sessions by function name.
+// Variables declared by the code line stay visible after the macro.
 #define TIME(code_line) \
-    Timer::start(__func__); \
+    Timer::Span TIMER_SPAN_NAME(__func__); \
     code_line; \
-    Timer::stop(__func__);
+    TIMER_SPAN_NAME.stop();
 #else
 // No-op macro when timing is disabled
 #define TIME(code_line) code_line;
 #endif
 
 /**
- * @brief A simple timer utility for measuring code execution time.
+ * @brief A thread-safe timer utility for measuring code execution time.
  *
- * This class provides static methods to start and stop timing sessions
- * identified by string labels. It records durations in microseconds.
+ * Timing sessions are identified by string labels. Sessions started while another
+ * session is running on the same thread are nested, e.g., `determinize` measured inside
+ * `from_mata` is recorded under the path `from_mata/determinize`.
+ * Every thread records into its own buffer; the buffers are merged when statistics are read.
+ * Durations are measured by a steady clock with nanosecond resolution.
+ * Every measurement also records the counts of its thread (see Counters), which are zero
+ * unless built with COUNTERS_ENABLED.
+ *
+ * Labels and paths are interned to ids, cached per thread, so a session takes no lock once
+ * its path was seen by the thread and usually allocates nothing. Durations of a path are kept in a histogram
+ * of log-scale buckets, so the memory does not grow with the number of measurements;
+ * percentiles are approximated by the buckets with a relative error of at most 1/16.
  */
 class Timer {
 public:
     using microseconds = std::chrono::microseconds::rep;
+    using nanoseconds = std::chrono::nanoseconds::rep;
+
+    // Aggregated statistics of all measurements recorded under one path.
+    struct Statistics {
+        std::string label;          // Label of the innermost timing session.
+        std::string path;           // Labels of all enclosing sessions separated by '/'.
+        size_t count = 0;           // Number of measurements.
+        nanoseconds total = 0;      // Sum of all durations.
+        nanoseconds min = 0;        // Shortest duration.
+        nanoseconds max = 0;        // Longest duration.
+        nanoseconds mean = 0;       // Average duration.
+        nanoseconds p50 = 0;        // Median duration (approximate).
+        nanoseconds p90 = 0;        // 90th percentile of durations (approximate).
+        nanoseconds p99 = 0;        // 99th percentile of durations (approximate).
+        Counters::Values counters{};  // Sums of the counts of all measurements.
+    };
+
 private:
+    using clock_t = std::chrono::steady_clock;
+    using LabelId = uint32_t;
+    using PathId = uint32_t;
+    static constexpr PathId NO_PATH = std::numeric_limits<PathId>::max();
+
+    // Durations below SUB_BUCKETS nanoseconds have their own buckets; every larger power of two
+    // is split into SUB_BUCKETS buckets of equal width.
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t NUM_OF_BUCKETS = SUB_BUCKETS * 61;
+    using Buckets = std::array<uint64_t, NUM_OF_BUCKETS>;
+
+    static size_t get_bucket(const nanoseconds duration) {
+        const uint64_t value = (duration < 0) ? 0 : static_cast<uint64_t>(duration);
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        const size_t exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+        return (exponent - 2) * SUB_BUCKETS + static_cast<size_t>((value >> (exponent - 3)) & (SUB_BUCKETS - 1));
+    }
+
+    static uint64_t get_bucket_lower_bound(const size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const size_t exponent = bucket / SUB_BUCKETS + 2;
+        return static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 3);
+    }
+
+    // Values written only by the owning thread of a buffer and read by any thread.
+    using Value = std::atomic<uint64_t>;
+
+    static void add(Value& value, const uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Measurements of one path by one thread.
+    struct PathRecord {
+        PathId path = NO_PATH;
+        LabelId label = 0;
+        Value count{ 0 };
+        Value total{ 0 };
+        Value min{ std::numeric_limits<uint64_t>::max() };
+        Value max{ 0 };
+        std::array<Value, NUM_OF_BUCKETS> buckets{};
+        std::array<Value, Counters::NUM_OF_COUNTERS> counters{};
+    };
+
+    // Last measurement of a label by one thread.
+    struct LabelRecord {
+        LabelId label = 0;
+        std::atomic<bool> is_valid{ false };
+        std::atomic<nanoseconds> duration{ 0 };
+        std::atomic<clock_t::rep> end_time{ 0 };
+        std::array<Value, Counters::NUM_OF_COUNTERS> counters{};
+    };
+
+    // Last measurement of a label.
+    struct LastMeasurement {
+        nanoseconds duration = 0;
+        clock_t::time_point end_time{};
+        Counters::Values counters{};
+    };
+
+    // Session started by start() and not yet stopped.
+    struct ManualSession {
+        PathId path;
+        clock_t::time_point start_time;
+        Counters::Values start_counters;
+    };
+
+    // Hash of strings accepting string views, so interned labels are found without allocation.
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(const std::string_view str) const {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+    using LabelIndex = std::unordered_map<std::string, LabelId, StringHash, std::equal_to<>>;
+
+    // Entry of the per-thread cache of paths by their parent and the address of the label.
+    struct PathCacheEntry {
+        PathId parent = NO_PATH;
+        const char* data = nullptr;
+        std::string label;  // Compared as well, since a label string may be reused with another text.
+        PathId path = NO_PATH;
+    };
+    static constexpr size_t PATH_CACHE_SIZE = 64;
+
+    // Measurements of one thread.
+    struct ThreadBuffer {
+        // Guards the lists of records, not their values: the owning thread locks it only to add
+        // a record and readers to traverse the records. Records are never moved or removed.
+        std::mutex mutex;
+        std::deque<PathRecord> path_records;
+        std::deque<LabelRecord> label_records;
+        // Accessed only by the owning thread.
+        std::vector<PathRecord*> record_of_path;    // Indexed by path ids.
+        std::vector<LabelRecord*> record_of_label;  // Indexed by label ids.
+        LabelIndex label_ids;                       // Labels interned by this thread.
+        std::unordered_map<uint64_t, PathId> child_paths;  // Paths by their parent and label.
+        std::array<PathCacheEntry, PATH_CACHE_SIZE> path_cache;  // Skips both lookups for recent labels.
+        std::vector<PathId> active_paths;           // Paths of the currently running sessions.
+        std::unordered_map<std::string, ManualSession> manual_sessions;
+    };
+
+    // Interned path.
+    struct PathInfo {
+        std::string path;
+        LabelId label;
+    };
+
     Timer() = default;
     Timer(const Timer&) = delete; // prevent copy
     Timer& operator=(const Timer&) = delete;  // prevent assignment
 
-    using clock_t = std::chrono::high_resolution_clock;
-
-    std::unordered_map<std::string, clock_t::time_point> start_times{};
-    std::unordered_map<std::string, microseconds> durations{};
+    // Guards the registered buffers and the interned labels and paths.
+    std::mutex registry_mutex{};
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers{};
+    std::vector<std::string> labels{};
+    LabelIndex label_index{};
+    std::vector<PathInfo> paths{};
+    std::unordered_map<uint64_t, PathId> path_index{};
 
     // Get the singleton instance
     static Timer& instance() {
@@ -45,17 +205,349 @@ private:
         return instance;
     }
 
+    // Get the buffer of the calling thread, registering it on first use.
+    static ThreadBuffer& local_buffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+            auto new_buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(instance().registry_mutex);
+            instance().buffers.push_back(new_buffer);
+            return new_buffer;
+        }();
+        return *buffer;
+    }
+
+    // Get a snapshot of all registered buffers.
+    static std::vector<std::shared_ptr<ThreadBuffer>> all_buffers() {
+        std::lock_guard<std::mutex> lock(instance().registry_mutex);
+        return instance().buffers;
+    }
+
+    // Get the id of a label, interning it on its first use by the calling thread.
+    static LabelId intern_label(ThreadBuffer& buffer, const std::string_view label) {
+        auto it = buffer.label_ids.find(label);
+        if (it != buffer.label_ids.end()) {
+            return it->second;
+        }
+        LabelId id;
+        {
+            Timer& timer = instance();
+            std::lock_guard<std::mutex> lock(timer.registry_mutex);
+            auto [index_it, inserted] = timer.label_index.try_emplace(std::string(label), static_cast<LabelId>(timer.labels.size()));
+            if (inserted) {
+                timer.labels.emplace_back(label);
+            }
+            id = index_it->second;
+        }
+        buffer.label_ids.emplace(std::string(label), id);
+        return id;
+    }
+
+    // Get the id of the path of a session with a label nested in a parent path (or NO_PATH).
+    static PathId intern_path(ThreadBuffer& buffer, const PathId parent, const LabelId label) {
+        const uint64_t key = (static_cast<uint64_t>(static_cast<PathId>(parent + 1)) << 32) | label;
+        auto it = buffer.child_paths.find(key);
+        if (it != buffer.child_paths.end()) {
+            return it->second;
+        }
+        PathId id;
+        {
+            Timer& timer = instance();
+            std::lock_guard<std::mutex> lock(timer.registry_mutex);
+            auto [index_it, inserted] = timer.path_index.try_emplace(key, static_cast<PathId>(timer.paths.size()));
+            if (inserted) {
+                std::string path = (parent == NO_PATH) ? timer.labels[label] : timer.paths[parent].path + "/" + timer.labels[label];
+                timer.paths.push_back({ std::move(path), label });
+            }
+            id = index_it->second;
+        }
+        buffer.child_paths.emplace(key, id);
+        return id;
+    }
+
+    // Find the id of an interned label.
+    static std::optional<LabelId> find_label(const std::string_view label) {
+        Timer& timer = instance();
+        std::lock_guard<std::mutex> lock(timer.registry_mutex);
+        auto it = timer.label_index.find(label);
+        if (it == timer.label_index.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    static PathRecord& get_path_record(ThreadBuffer& buffer, const PathId path) {
+        if (path >= buffer.record_of_path.size()) {
+            buffer.record_of_path.resize(path + 1, nullptr);
+        }
+        PathRecord*& record = buffer.record_of_path[path];
+        if (record == nullptr) {
+            LabelId label;
+            {
+                Timer& timer = instance();
+                std::lock_guard<std::mutex> lock(timer.registry_mutex);
+                label = timer.paths[path].label;
+            }
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            record = &buffer.path_records.emplace_back();
+            record->path = path;
+            record->label = label;
+        }
+        return *record;
+    }
+
+    static LabelRecord& get_label_record(ThreadBuffer& buffer, const LabelId label) {
+        if (label >= buffer.record_of_label.size()) {
+            buffer.record_of_label.resize(label + 1, nullptr);
+        }
+        LabelRecord*& record = buffer.record_of_label[label];
+        if (record == nullptr) {
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            record = &buffer.label_records.emplace_back();
+            record->label = label;
+        }
+        return *record;
+    }
+
+    // Open a session nested in the innermost running session of the calling thread.
+    static PathId open_session(ThreadBuffer& buffer, const std::string_view label) {
+        const PathId parent = buffer.active_paths.empty() ? NO_PATH : buffer.active_paths.back();
+        const size_t slot = ((reinterpret_cast<uintptr_t>(label.data()) >> 3) ^ (parent * 0x9E3779B1u)) % PATH_CACHE_SIZE;
+        PathCacheEntry& entry = buffer.path_cache[slot];
+        if (entry.parent != parent || entry.data != label.data() || entry.label != label) {
+            entry.parent = parent;
+            entry.data = label.data();
+            entry.label = label;
+            entry.path = intern_path(buffer, parent, intern_label(buffer, label));
+        }
+        buffer.active_paths.push_back(entry.path);
+        return entry.path;
+    }
+
+    // Close a running session and record its duration and counts.
+    static void close_session(ThreadBuffer& buffer, const PathId path, const nanoseconds duration, const clock_t::time_point end_time,
+                              const Counters::Values& counters) {
+        const uint64_t value = (duration < 0) ? 0 : static_cast<uint64_t>(duration);
+        PathRecord& record = get_path_record(buffer, path);
+        add(record.count, 1);
+        add(record.total, value);
+        if (value < record.min.load(std::memory_order_relaxed)) {
+            record.min.store(value, std::memory_order_relaxed);
+        }
+        if (value > record.max.load(std::memory_order_relaxed)) {
+            record.max.store(value, std::memory_order_relaxed);
+        }
+        add(record.buckets[get_bucket(duration)], 1);
+
+        LabelRecord& last = get_label_record(buffer, record.label);
+        last.duration.store(duration, std::memory_order_relaxed);
+        last.end_time.store(end_time.time_since_epoch().count(), std::memory_order_relaxed);
+        if constexpr (Counters::ENABLED) {
+            for (size_t counter = 0; counter < Counters::NUM_OF_COUNTERS; ++counter) {
+                add(record.counters[counter], counters[counter]);
+                last.counters[counter].store(counters[counter], std::memory_order_relaxed);
+            }
+        }
+        last.is_valid.store(true, std::memory_order_release);
+
+        // Sessions are usually closed in reverse order; search from the innermost one.
+        auto it = std::find(buffer.active_paths.rbegin(), buffer.active_paths.rend(), path);
+        if (it != buffer.active_paths.rend()) {
+            buffer.active_paths.erase(std::next(it).base());
+        }
+    }
+
+    static LastMeasurement read(const LabelRecord& record) {
+        LastMeasurement measurement;
+        measurement.duration = record.duration.load(std::memory_order_relaxed);
+        measurement.end_time = clock_t::time_point(clock_t::duration(record.end_time.load(std::memory_order_relaxed)));
+        for (size_t counter = 0; counter < Counters::NUM_OF_COUNTERS; ++counter) {
+            measurement.counters[counter] = record.counters[counter].load(std::memory_order_relaxed);
+        }
+        return measurement;
+    }
+
+    // Find the last measurement of a label, preferring the calling thread.
+    static LastMeasurement find_last(const std::string& label) {
+        const std::optional<LabelId> id = find_label(label);
+        if (id.has_value()) {
+            ThreadBuffer& buffer = local_buffer();
+            if (*id < buffer.record_of_label.size() && buffer.record_of_label[*id] != nullptr &&
+                buffer.record_of_label[*id]->is_valid.load(std::memory_order_acquire)) {
+                return read(*buffer.record_of_label[*id]);
+            }
+
+            bool found = false;
+            LastMeasurement latest{};
+            for (const auto& other : all_buffers()) {
+                std::lock_guard<std::mutex> lock(other->mutex);
+                for (const LabelRecord& record : other->label_records) {
+                    if (record.label != *id || !record.is_valid.load(std::memory_order_acquire)) {
+                        continue;
+                    }
+                    const LastMeasurement measurement = read(record);
+                    if (!found || measurement.end_time > latest.end_time) {
+                        latest = measurement;
+                        found = true;
+                    }
+                }
+            }
+            if (found) {
+                return latest;
+            }
+        }
+        throw std::runtime_error("No recorded duration for label '" + label + "'.");
+    }
+
+    // Measurements of a path merged over threads.
+    struct MergedRecord {
+        uint64_t count = 0;
+        uint64_t total = 0;
+        uint64_t min = std::numeric_limits<uint64_t>::max();
+        uint64_t max = 0;
+        Buckets buckets{};
+        Counters::Values counters{};
+    };
+
+    static void merge(MergedRecord& merged, const PathRecord& record) {
+        const uint64_t count = record.count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            return;
+        }
+        merged.count += count;
+        merged.total += record.total.load(std::memory_order_relaxed);
+        merged.min = std::min(merged.min, record.min.load(std::memory_order_relaxed));
+        merged.max = std::max(merged.max, record.max.load(std::memory_order_relaxed));
+        for (size_t bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket) {
+            merged.buckets[bucket] += record.buckets[bucket].load(std::memory_order_relaxed);
+        }
+        for (size_t counter = 0; counter < Counters::NUM_OF_COUNTERS; ++counter) {
+            merged.counters[counter] += record.counters[counter].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Compute aggregated statistics from the merged histogram of a path.
+    static Statistics make_statistics(const std::string& path, const MergedRecord& merged) {
+        Statistics stats;
+        stats.path = path;
+        stats.counters = merged.counters;
+        const size_t separator = path.rfind('/');
+        stats.label = (separator == std::string::npos) ? path : path.substr(separator + 1);
+        stats.count = static_cast<size_t>(merged.count);
+        if (merged.count == 0) {
+            return stats;
+        }
+
+        stats.total = static_cast<nanoseconds>(merged.total);
+        stats.min = static_cast<nanoseconds>(merged.min);
+        stats.max = static_cast<nanoseconds>(merged.max);
+        stats.mean = stats.total / static_cast<nanoseconds>(merged.count);
+        // Nearest-rank percentiles taken as the middle of their bucket, within the observed range.
+        auto percentile = [&merged](const uint64_t p) {
+            const uint64_t rank = std::max<uint64_t>((p * merged.count + 99) / 100, 1);
+            uint64_t cumulative = 0;
+            size_t bucket = 0;
+            while (bucket + 1 < NUM_OF_BUCKETS && cumulative + merged.buckets[bucket] < rank) {
+                cumulative += merged.buckets[bucket];
+                ++bucket;
+            }
+            const uint64_t lower = get_bucket_lower_bound(bucket);
+            const uint64_t upper = (bucket + 1 < NUM_OF_BUCKETS) ? get_bucket_lower_bound(bucket + 1) - 1 : lower;
+            return static_cast<nanoseconds>(std::clamp(lower + (upper - lower) / 2, merged.min, merged.max));
+        };
+        stats.p50 = percentile(50);
+        stats.p90 = percentile(90);
+        stats.p99 = percentile(99);
+        return stats;
+    }
+
+    // Get the strings of all interned paths.
+    static std::vector<std::string> get_paths() {
+        Timer& timer = instance();
+        std::lock_guard<std::mutex> lock(timer.registry_mutex);
+        std::vector<std::string> result;
+        result.reserve(timer.paths.size());
+        for (const PathInfo& info : timer.paths) {
+            result.push_back(info.path);
+        }
+        return result;
+    }
+
+    // Escape a string for JSON output.
+    static std::string escape_json(const std::string& str) {
+        std::string escaped;
+        escaped.reserve(str.size());
+        for (const char c : str) {
+            if (c == '"' || c == '\\') {
+                escaped.push_back('\\');
+            }
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
 public:
     ~Timer() = default;
 
+    /**
+     * @brief RAII timing session.
+     *
+     * The session starts on construction and stops on destruction
+     * or on the first call of stop(), whichever comes first.
+     */
+    class Span {
+        ThreadBuffer* buffer;
+        PathId path;
+        clock_t::time_point start_time;
+        Counters::Values start_counters;
+        bool running;
+
+    public:
+        /**
+         * Start timing for a given label.
+         *
+         * @param label Identifier for the timing session.
+         */
+        explicit Span(std::string_view label)
+            : buffer(&Timer::local_buffer()), path(Timer::open_session(*buffer, label)), start_time(),
+              start_counters(Counters::get_local()), running(true) {
+            // Read the clock last to not measure the bookkeeping.
+            start_time = clock_t::now();
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        ~Span() {
+            stop();
+        }
+
+        /**
+         * Stop timing and record the duration. Subsequent calls have no effect.
+         *
+         * @return Duration in nanoseconds, 0 if the session was already stopped.
+         */
+        nanoseconds stop() {
+            if (!running) {
+                return 0;
+            }
+            const auto end_time = clock_t::now();
+            running = false;
+            const nanoseconds duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+            Timer::close_session(*buffer, path, duration, end_time, Counters::difference(Counters::get_local(), start_counters));
+            return duration;
+        }
+    };
+
     /**
      * Start timing for a given label.
      *
      * @param label Identifier for the timing session.
      */
     static void start(const std::string& label) {
-        instance().durations.erase(label); // clear previous duration
-        instance().start_times[label] = std::chrono::high_resolution_clock::now();
+        ThreadBuffer& buffer = local_buffer();
+        const PathId path = open_session(buffer, label);
+        Counters::Values start_counters = Counters::get_local();
+        buffer.manual_sessions[label] = { path, clock_t::now(), start_counters };
     }
 
     /**
@@ -65,29 +557,182 @@ public:
      * @return Duration in microseconds.
      */
     static microseconds stop(const std::string& label) {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto start_it = instance().start_times.find(label);
-        if (start_it == instance().start_times.end()) {
+        const auto end_time = clock_t::now();
+        ThreadBuffer& buffer = local_buffer();
+        auto session_it = buffer.manual_sessions.find(label);
+        if (session_it == buffer.manual_sessions.end()) {
             throw std::runtime_error("Timer for label '" + label + "' was not started.");
         }
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_it->second).count();
-        instance().durations[label] = duration;
-        instance().start_times.erase(start_it);
-        return duration;
+        const ManualSession& session = session_it->second;
+        const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - session.start_time);
+        close_session(buffer, session.path, duration.count(), end_time,
+                      Counters::difference(Counters::get_local(), session.start_counters));
+        buffer.manual_sessions.erase(session_it);
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
     }
 
     /**
-     * Get the recorded duration for a given label.
+     * Get the last recorded duration for a given label in nanoseconds.
+     * Measurements of the calling thread take precedence; otherwise the most
+     * recently finished measurement of any thread is returned.
+     *
+     * @param label Identifier for the timing session.
+     * @return Duration in nanoseconds.
+     */
+    static nanoseconds get_nanoseconds(const std::string& label) {
+        return find_last(label).duration;
+    }
+
+    /**
+     * Get the counts of the last measurement for a given label, e.g.,
+     * `Timer::get_counters("intersection")[Counters::MONA_PRODUCT_STATES]`.
+     * The measurement is chosen as by get_nanoseconds().
+     *
+     * @param label Identifier for the timing session.
+     * @return Counts recorded during the measurement (zero without COUNTERS_ENABLED).
+     */
+    static Counters::Values get_counters(const std::string& label) {
+        return find_last(label).counters;
+    }
+
+    /**
+     * Get the last recorded duration for a given label.
      *
      * @param label Identifier for the timing session.
      * @return Duration in microseconds.
      */
     static microseconds get(const std::string& label) {
-        auto it = instance().durations.find(label);
-        if (it == instance().durations.end()) {
-            throw std::runtime_error("No recorded duration for label '" + label + "'.");
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(get_nanoseconds(label))).count();
+    }
+
+    /**
+     * Get statistics of all recorded measurements merged over all threads.
+     *
+     * @return Statistics for each path, ordered by path.
+     */
+    static std::vector<Statistics> get_statistics() {
+        std::unordered_map<PathId, MergedRecord> merged;
+        for (const auto& buffer : all_buffers()) {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            for (const PathRecord& record : buffer->path_records) {
+                merge(merged[record.path], record);
+            }
+        }
+
+        const std::vector<std::string> path_names = get_paths();
+        std::vector<Statistics> result;
+        result.reserve(merged.size());
+        for (const auto& [path, record] : merged) {
+            if (record.count > 0) {
+                result.push_back(make_statistics(path_names[path], record));
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const Statistics& lhs, const Statistics& rhs) {
+            return lhs.path < rhs.path;
+        });
+        return result;
+    }
+
+    /**
+     * Get statistics of all measurements of a given label regardless of the enclosing sessions.
+     *
+     * @param label Identifier for the timing session.
+     * @return Statistics of the label; its path equals the label.
+     */
+    static Statistics get_statistics(const std::string& label) {
+        MergedRecord merged;
+        const std::optional<LabelId> id = find_label(label);
+        if (id.has_value()) {
+            for (const auto& buffer : all_buffers()) {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                for (const PathRecord& record : buffer->path_records) {
+                    if (record.label == *id) {
+                        merge(merged, record);
+                    }
+                }
+            }
+        }
+        return make_statistics(label, merged);
+    }
+
+    /**
+     * Export statistics of all recorded measurements in CSV format.
+     * With COUNTERS_ENABLED, one column per counter follows the durations.
+     *
+     * @param os Output stream to write to.
+     */
+    static void export_csv(std::ostream& os) {
+        os << "label,path,count,total_ns,min_ns,max_ns,mean_ns,p50_ns,p90_ns,p99_ns";
+        if constexpr (Counters::ENABLED) {
+            for (const std::string_view name : Counters::NAMES) {
+                os << "," << name;
+            }
+        }
+        os << "\n";
+        for (const Statistics& stats : get_statistics()) {
+            os << stats.label << "," << stats.path << "," << stats.count << ","
+               << stats.total << "," << stats.min << "," << stats.max << "," << stats.mean << ","
+               << stats.p50 << "," << stats.p90 << "," << stats.p99;
+            if constexpr (Counters::ENABLED) {
+                for (const uint64_t count : stats.counters) {
+                    os << "," << count;
+                }
+            }
+            os << "\n";
+        }
+    }
+
+    /**
+     * Export statistics of all recorded measurements in JSON format.
+     * With COUNTERS_ENABLED, every entry has a "counters" object.
+     *
+     * @param os Output stream to write to.
+     */
+    static void export_json(std::ostream& os) {
+        os << "[";
+        bool first = true;
+        for (const Statistics& stats : get_statistics()) {
+            os << (first ? "\n" : ",\n");
+            first = false;
+            os << "  {\"label\": \"" << escape_json(stats.label) << "\", \"path\": \"" << escape_json(stats.path) << "\""
+               << ", \"count\": " << stats.count << ", \"total_ns\": " << stats.total
+               << ", \"min_ns\": " << stats.min << ", \"max_ns\": " << stats.max << ", \"mean_ns\": " << stats.mean
+               << ", \"p50_ns\": " << stats.p50 << ", \"p90_ns\": " << stats.p90 << ", \"p99_ns\": " << stats.p99;
+            if constexpr (Counters::ENABLED) {
+                os << ", \"counters\": {";
+                for (size_t counter = 0; counter < Counters::NUM_OF_COUNTERS; ++counter) {
+                    os << (counter == 0 ? "" : ", ") << "\"" << Counters::NAMES[counter] << "\": " << stats.counters[counter];
+                }
+                os << "}";
+            }
+            os << "}";
+        }
+        os << "\n]\n";
+    }
+
+    /**
+     * Remove all recorded measurements of all threads.
+     * Running sessions are not affected; a measurement finishing during the reset may be kept in part.
+     */
+    static void reset() {
+        for (const auto& buffer : all_buffers()) {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            for (PathRecord& record : buffer->path_records) {
+                record.count.store(0, std::memory_order_relaxed);
+                record.total.store(0, std::memory_order_relaxed);
+                record.min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+                record.max.store(0, std::memory_order_relaxed);
+                for (Value& bucket : record.buckets) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                for (Value& counter : record.counters) {
+                    counter.store(0, std::memory_order_relaxed);
+                }
+            }
+            for (LabelRecord& record : buffer->label_records) {
+                record.is_valid.store(false, std::memory_order_relaxed);
+            }
         }
-        return it->second;
     }
 };
 
@@ -0,0 +1,206 @@
+#ifndef MAMONATA_WORK_STEALING_POOL_HH_
+#define MAMONATA_WORK_STEALING_POOL_HH_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mamonata {
+
+/**
+ * @brief Fixed-size thread pool with one task queue per worker.
+ *
+ * A worker takes the most recently queued task of its own queue first (LIFO, keeping related
+ * work local) and, once its queue is empty, steals the oldest task of another worker (FIFO).
+ * Tasks submitted from outside are distributed to the queues round-robin; tasks submitted by
+ * a worker go to its own queue. Tasks may submit further tasks.
+ *
+ * The first exception thrown by a task is rethrown by wait(); later tasks still run.
+ */
+class WorkStealingPool {
+public:
+    static constexpr size_t NO_WORKER = std::numeric_limits<size_t>::max();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> next_queue = 0;  // Queue receiving the next task submitted from outside.
+    std::atomic<size_t> num_of_queued = 0;  // Tasks waiting in queues.
+
+    std::mutex mutex;                    // Guards the fields below and the waits on the conditions.
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    size_t num_of_unfinished = 0;        // Tasks submitted and not yet finished.
+    bool stopping = false;
+    std::exception_ptr first_exception;
+
+    // Index of the worker running on the calling thread and the pool it belongs to.
+    static size_t& local_worker_index() {
+        thread_local size_t index = NO_WORKER;
+        return index;
+    }
+
+    static const WorkStealingPool*& local_pool() {
+        thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+
+    // Takes the newest task of the worker's own queue or the oldest task of another queue.
+    bool take_task(const size_t worker, std::function<void()>& task) {
+        {
+            Queue& own = *queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                --num_of_queued;
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            Queue& victim = *queues[(worker + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                --num_of_queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run_worker(const size_t worker) {
+        local_worker_index() = worker;
+        local_pool() = this;
+        std::function<void()> task;
+        while (true) {
+            if (take_task(worker, task)) {
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!first_exception) {
+                        first_exception = std::current_exception();
+                    }
+                }
+                task = nullptr;
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--num_of_unfinished == 0) {
+                    all_done.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            work_available.wait(lock, [&]() { return stopping || num_of_queued > 0; });
+            if (stopping && num_of_queued == 0) {
+                return;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Starts the workers.
+     *
+     * @param num_of_threads Number of worker threads; 0 uses the number of hardware threads.
+     */
+    explicit WorkStealingPool(size_t num_of_threads) {
+        if (num_of_threads == 0) {
+            num_of_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        queues.reserve(num_of_threads);
+        for (size_t i = 0; i < num_of_threads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        threads.reserve(num_of_threads);
+        for (size_t i = 0; i < num_of_threads; ++i) {
+            threads.emplace_back([this, i]() { run_worker(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Finishes all submitted tasks and stops the workers.
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_available.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Returns the number of worker threads.
+    size_t get_num_of_threads() const {
+        return threads.size();
+    }
+
+    // Returns the index of the worker of this pool running on the calling thread, or NO_WORKER.
+    size_t get_worker_index() const {
+        return (local_pool() == this) ? local_worker_index() : NO_WORKER;
+    }
+
+    /**
+     * @brief Queues a task.
+     *
+     * @param task Callable run by one of the workers.
+     */
+    void submit(std::function<void()> task) {
+        const size_t worker = get_worker_index();
+        const size_t queue = (worker != NO_WORKER) ? worker : next_queue++ % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++num_of_unfinished;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+            queues[queue]->tasks.push_back(std::move(task));
+            ++num_of_queued;
+        }
+        // Taking the lock orders the notification after a worker checking the queues went to sleep.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        work_available.notify_one();
+    }
+
+    /**
+     * @brief Blocks until all submitted tasks (including tasks they submitted) have finished.
+     * Must not be called from a worker.
+     *
+     * @throws Rethrows the first exception thrown by a task since the last wait().
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        all_done.wait(lock, [&]() { return num_of_unfinished == 0; });
+        if (first_exception) {
+            std::exception_ptr exception = std::exchange(first_exception, nullptr);
+            lock.unlock();
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+} // namespace mamonata
+
+#endif // MAMONATA_WORK_STEALING_POOL_HH_
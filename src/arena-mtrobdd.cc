@@ -0,0 +1,663 @@
+#include "arena-mtrobdd.hh"
+
+namespace mamonata::mtrobdd
+{
+
+size_t ArenaMtRobdd::find_slot(const VarIndex var_index, const NodeId low, const NodeId high, const NodeValue value) const {
+    assert(!unique_table.empty());
+    const size_t mask = unique_table.size() - 1;
+    size_t slot = hash_node(var_index, low, high, value) & mask;
+    while (true) {
+        const NodeId node = unique_table[slot];
+        if (node == NULL_NODE) {
+            return slot;
+        }
+        if (var_indices[node] == var_index && lows[node] == low && highs[node] == high && values[node] == value) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void ArenaMtRobdd::rebuild_unique_table() {
+    // Keep the load factor at most 1/2 to have short probe sequences.
+    size_t capacity = 16;
+    while (capacity < 2 * (var_indices.size() + 1)) {
+        capacity <<= 1;
+    }
+    unique_table.assign(capacity, NULL_NODE);
+    for (NodeId node = 0; node < var_indices.size(); ++node) {
+        const size_t slot = find_slot(var_indices[node], lows[node], highs[node], values[node]);
+        assert(unique_table[slot] == NULL_NODE);
+        unique_table[slot] = node;
+    }
+}
+
+ProbeStatistics ArenaMtRobdd::get_unique_table_statistics() const {
+    ProbeStatistics statistics;
+    statistics.num_of_keys = var_indices.size();
+    statistics.capacity = unique_table.size();
+    if (var_indices.empty()) {
+        return statistics;
+    }
+    const size_t mask = unique_table.size() - 1;
+    size_t total = 0;
+    for (size_t slot = 0; slot < unique_table.size(); ++slot) {
+        const NodeId node = unique_table[slot];
+        if (node != NULL_NODE) {
+            const size_t home = hash_node(var_indices[node], lows[node], highs[node], values[node]) & mask;
+            const size_t length = ((slot - home) & mask) + 1;
+            total += length;
+            statistics.max_probe_length = std::max(statistics.max_probe_length, length);
+        }
+    }
+    statistics.mean_probe_length = static_cast<double>(total) / static_cast<double>(var_indices.size());
+    return statistics;
+}
+
+NodeId ArenaMtRobdd::create_node(const VarIndex var_index, const NodeId low, const NodeId high, const NodeValue value) {
+    COUNT(CREATE_NODE_CALLS, 1);
+    if (2 * (var_indices.size() + 1) > unique_table.size()) {
+        rebuild_unique_table();
+    }
+
+    const size_t slot = find_slot(var_index, low, high, value);
+    if (unique_table[slot] != NULL_NODE) {
+        COUNT(UNIQUE_TABLE_HITS, 1);
+        return unique_table[slot];
+    }
+
+    assert(var_indices.size() < NULL_NODE);
+    const NodeId new_node = static_cast<NodeId>(var_indices.size());
+    var_indices.push_back(var_index);
+    lows.push_back(low);
+    highs.push_back(high);
+    values.push_back(value);
+    unique_table[slot] = new_node;
+    return new_node;
+}
+
+void ArenaMtRobdd::clear_nodes() {
+    var_indices.clear();
+    lows.clear();
+    highs.clear();
+    values.clear();
+    unique_table.clear();
+    root_nodes_map.clear();
+}
+
+std::vector<NodeId> ArenaMtRobdd::get_reachable_post_order() const {
+    // Process roots by their names to get a deterministic order.
+    std::vector<std::pair<NodeName, NodeId>> roots(root_nodes_map.begin(), root_nodes_map.end());
+    std::sort(roots.begin(), roots.end());
+
+    std::vector<NodeId> order;
+    order.reserve(var_indices.size());
+    std::vector<bool> visited(var_indices.size(), false);
+
+    // Worklist of nodes paired with a flag telling whether their children were already scheduled.
+    std::vector<std::pair<NodeId, bool>> worklist;
+    for (const auto& [name, root_node] : roots) {
+        // A missing root denotes the virtual sink.
+        if (root_node == NULL_NODE) {
+            continue;
+        }
+        worklist.emplace_back(root_node, false);
+        while (!worklist.empty()) {
+            const auto [node, expanded] = worklist.back();
+            worklist.pop_back();
+
+            if (expanded) {
+                order.push_back(node);
+                continue;
+            }
+            if (visited[node]) {
+                continue;
+            }
+            visited[node] = true;
+
+            // LOW child is pushed last so that it is processed first.
+            worklist.emplace_back(node, true);
+            if (highs[node] != NULL_NODE && !visited[highs[node]]) {
+                worklist.emplace_back(highs[node], false);
+            }
+            if (lows[node] != NULL_NODE && !visited[lows[node]]) {
+                worklist.emplace_back(lows[node], false);
+            }
+        }
+    }
+
+    return order;
+}
+
+ArenaMtRobdd& ArenaMtRobdd::from_mona(const size_t num_of_vars, bdd_manager* bddm, bdd_ptr* root_behavior_ptrs, const size_t num_of_roots) {
+    this->num_of_vars = num_of_vars;
+    clear_nodes();
+
+    // Prepare MONA BDD manager for transfer
+    Table *table = tableInit();
+    bdd_prepare_apply1(bddm);
+
+    // Build table of tuples (idx,lo,hi)
+    for (size_t i = 0; i < num_of_roots; i++) {
+        _export(bddm, root_behavior_ptrs[i], table);
+    }
+
+    // Renumber lo/hi pointers to new table ordering
+    for (size_t i = 0; i < table->noelems; i++) {
+        if (table->elms[i].idx != -1) {
+            table->elms[i].lo = bdd_mark(bddm, table->elms[i].lo) - 1;
+            table->elms[i].hi = bdd_mark(bddm, table->elms[i].hi) - 1;
+        }
+    }
+
+    // MONA nodes are already unique, therefore each table entry becomes
+    // the arena node with the same index.
+    var_indices.resize(table->noelems);
+    lows.resize(table->noelems);
+    highs.resize(table->noelems);
+    values.resize(table->noelems);
+    for (NodeId i = 0; i < table->noelems; ++i) {
+        var_indices[i] = table->elms[i].idx;
+        if (table->elms[i].idx == -1) {
+            // terminal node
+            lows[i] = NULL_NODE;
+            highs[i] = NULL_NODE;
+            values[i] = static_cast<NodeValue>(table->elms[i].lo);
+        } else {
+            // inner node
+            lows[i] = static_cast<NodeId>(table->elms[i].lo);
+            highs[i] = static_cast<NodeId>(table->elms[i].hi);
+            values[i] = MAX_NODE_VALUE;
+        }
+    }
+    rebuild_unique_table();
+
+    // Set MTROBDD root nodes
+    for (NodeName state = 0; state < num_of_roots; ++state) {
+        root_nodes_map[state] = static_cast<NodeId>(bdd_mark(bddm, root_behavior_ptrs[state]) - 1);
+    }
+
+    tableFree(table);
+
+    return *this;
+}
+
+void ArenaMtRobdd::to_mona(bdd_manager* bddm, bdd_ptr* root_behavior_ptrs) const {
+    // assert for each i in 0 .. root_nodes_map.size()-1 there is a root with name i
+    assert(std::all_of(root_nodes_map.begin(), root_nodes_map.end(),
+                        [this](const auto& pair) {
+                            return pair.first < this->root_nodes_map.size();
+                        }));
+
+    // Children always precede their parents in post-order,
+    // so each MONA node can be created right away.
+    std::vector<bdd_ptr> mona_nodes(var_indices.size());
+    // MONA leaf of the virtual sink, created on its first use.
+    bdd_ptr sink_leaf = 0;
+    bool has_sink_leaf = false;
+    auto get_mona_node = [&](const NodeId node) -> bdd_ptr {
+        if (node != NULL_NODE) {
+            return mona_nodes[node];
+        }
+        assert(has_virtual_sink());
+        if (!has_sink_leaf) {
+            sink_leaf = bdd_find_leaf_sequential(bddm, static_cast<unsigned>(virtual_sink_value));
+            has_sink_leaf = true;
+        }
+        return sink_leaf;
+    };
+
+    for (const NodeId node : get_reachable_post_order()) {
+        if (is_terminal(node)) {
+            // MONA stores terminal value in 'lo' field
+            mona_nodes[node] = bdd_find_leaf_sequential(bddm, static_cast<unsigned>(values[node]));
+        } else {
+            assert(lows[node] != highs[node]);
+            const bdd_ptr low = get_mona_node(lows[node]);
+            const bdd_ptr high = get_mona_node(highs[node]);
+            mona_nodes[node] = bdd_find_node_sequential(bddm, low, high, static_cast<unsigned>(var_indices[node]));
+        }
+    }
+
+    // Fill the roots_behavior array with actual MONA node pointers
+    for (NodeName root_name = 0; root_name < root_nodes_map.size(); ++root_name) {
+        root_behavior_ptrs[root_name] = get_mona_node(root_nodes_map.at(root_name));
+    }
+}
+
+NodeId ArenaMtRobdd::insert_bit_string(const NodeId src_node, const VarIndex var_index, const BitVector& bit_string, const NodeValue terminal_value) {
+    assert(!bit_string.empty());
+    assert(var_index <= static_cast<VarIndex>(num_of_vars));
+
+    // Walk down the existing path and remember the node at each level.
+    // NULL_NODE marks levels where the path does not exist yet.
+    std::vector<NodeId> path;
+    path.reserve(num_of_vars - var_index);
+    NodeId node = src_node;
+    for (VarIndex level = var_index; level < static_cast<VarIndex>(num_of_vars); ++level) {
+        path.push_back(node);
+        if (node != NULL_NODE) {
+            node = (bit_string[level] == LO) ? lows[node] : highs[node];
+        }
+    }
+
+    // Rebuild the path bottom-up, reusing nodes that did not change.
+    NodeId child = create_terminal_node(terminal_value);
+    for (VarIndex level = static_cast<VarIndex>(num_of_vars) - 1; level >= var_index; --level) {
+        const NodeId old_node = path[level - var_index];
+        NodeId low_child = (old_node == NULL_NODE) ? NULL_NODE : lows[old_node];
+        NodeId high_child = (old_node == NULL_NODE) ? NULL_NODE : highs[old_node];
+        if (bit_string[level] == LO) {
+            low_child = child;
+        } else {
+            high_child = child;
+        }
+
+        if (old_node != NULL_NODE && low_child == lows[old_node] && high_child == highs[old_node]) {
+            child = old_node;
+        } else {
+            child = create_node(level, low_child, high_child);
+        }
+    }
+
+    return child;
+}
+
+NodeId ArenaMtRobdd::build_from_minterms(const VarIndex var_index, const Minterm* begin, const Minterm* end, const NodeId default_node) {
+    // No assignment with this prefix is listed.
+    if (begin == end) {
+        return default_node;
+    }
+
+    // Base case: the whole assignment is fixed
+    if (var_index == static_cast<VarIndex>(num_of_vars)) {
+        assert(end - begin == 1);
+        return create_terminal_node(begin->second);
+    }
+
+    // Minterms are sorted, so those with LO at this variable form a prefix of the range.
+    const unsigned shift = static_cast<unsigned>(num_of_vars - var_index - 1);
+    const Minterm* middle = std::partition_point(begin, end, [shift](const Minterm& minterm) {
+        return ((minterm.first >> shift) & 1) == LO;
+    });
+
+    const NodeId low_child = build_from_minterms(var_index + 1, begin, middle, default_node);
+    const NodeId high_child = build_from_minterms(var_index + 1, middle, end, default_node);
+
+    // Skip redundant tests right away
+    if (low_child == high_child) {
+        return low_child;
+    }
+    return create_node(var_index, low_child, high_child);
+}
+
+std::vector<NodeId> ArenaMtRobdd::import_nodes(const ArenaMtRobdd& other) {
+    assert(other.num_of_vars == num_of_vars);
+    // Missing children keep their meaning only if both MTROBDDs have the same virtual sink.
+    assert(other.virtual_sink_value == virtual_sink_value);
+
+    // Children are imported before parents.
+    std::vector<NodeId> new_ids(other.get_num_of_nodes(), NULL_NODE);
+    for (const NodeId node : other.get_reachable_post_order()) {
+        const NodeId low = other.lows[node];
+        const NodeId high = other.highs[node];
+        new_ids[node] = create_node(other.var_indices[node],
+                                    (low == NULL_NODE) ? NULL_NODE : new_ids[low],
+                                    (high == NULL_NODE) ? NULL_NODE : new_ids[high],
+                                    other.values[node]);
+    }
+
+    return new_ids;
+}
+
+NodeId ArenaMtRobdd::create_from_minterms(const std::vector<Minterm>& minterms, const NodeValue default_value) {
+    assert(num_of_vars <= 64);
+    assert(std::is_sorted(minterms.begin(), minterms.end()));
+
+    // The default terminal is created only if some assignment leads to it and it is not the virtual sink.
+    const bool covers_all = num_of_vars < 64 && minterms.size() == (uint64_t{1} << num_of_vars);
+    const NodeId default_node = covers_all ? NULL_NODE : create_leaf(default_value);
+
+    // Small alphabets have a table with an entry per assignment.
+    switch (num_of_vars) {
+        case 0: return build_from_table<0>(minterms, default_node);
+        case 1: return build_from_table<1>(minterms, default_node);
+        case 2: return build_from_table<2>(minterms, default_node);
+        case 3: return build_from_table<3>(minterms, default_node);
+        case 4: return build_from_table<4>(minterms, default_node);
+        case 5: return build_from_table<5>(minterms, default_node);
+        case 6: return build_from_table<6>(minterms, default_node);
+        case 7: return build_from_table<7>(minterms, default_node);
+        case 8: return build_from_table<8>(minterms, default_node);
+        default: break;
+    }
+    static_assert(MAX_TABLE_VARS == 8, "create_from_minterms dispatches up to MAX_TABLE_VARS variables");
+    return build_from_minterms(0, minterms.data(), minterms.data() + minterms.size(), default_node);
+}
+
+std::vector<std::pair<BitVector, NodeValue>> ArenaMtRobdd::get_all_bit_strings_from_root_node(const NodeId root_node) const {
+    // Helper function to calculate transition length.
+    auto get_transition_length = [&](const VarIndex src_idx, const NodeId tgt_node) -> size_t {
+        if (is_leaf(tgt_node)) {
+            return num_of_vars - src_idx;
+        }
+        return var_indices[tgt_node] - src_idx;
+    };
+
+    std::vector<std::pair<BitVector, NodeValue>> result;
+    std::stack<std::pair<NodeId, BitVector>> worklist;
+
+    // Pushes all expansions of the prefix with don't care bits onto the worklist.
+    auto push_expanded = [&](const NodeId node, BitVector prefix, const size_t dont_care_count) {
+        const size_t prefix_length = prefix.size();
+        prefix.resize(prefix_length + dont_care_count, LO);
+        for (size_t combination = 0; combination < (size_t{1} << dont_care_count); ++combination) {
+            for (size_t i = 0; i < dont_care_count; ++i) {
+                prefix[prefix_length + i] = ((combination >> (dont_care_count - i - 1)) & 1) ? HI : LO;
+            }
+            worklist.emplace(node, prefix);
+        }
+    };
+
+    // Initialize worklist with root node and possible prefixes
+    push_expanded(root_node, {}, get_transition_length(0, root_node));
+
+    while (!worklist.empty()) {
+        auto [current_node, current_prefix] = worklist.top();
+        worklist.pop();
+
+        // If terminal node, record the bit string and value
+        // Stop further descending
+        if (is_leaf(current_node)) {
+            result.emplace_back(std::move(current_prefix), get_leaf_value(current_node));
+            continue;
+        }
+
+        const VarIndex current_index = var_indices[current_node];
+        // Process LOW child
+        if (lows[current_node] != NULL_NODE || has_virtual_sink()) {
+            size_t transition_length = get_transition_length(current_index, lows[current_node]);
+            assert(transition_length > 0);
+            BitVector current_base = current_prefix;
+            // Append LO decision bit
+            current_base.push_back(LO);
+            // Process potential don't care bits
+            push_expanded(lows[current_node], std::move(current_base), transition_length - 1);
+        }
+        // Process HIGH child
+        if (highs[current_node] != NULL_NODE || has_virtual_sink()) {
+            size_t transition_length = get_transition_length(current_index, highs[current_node]);
+            assert(transition_length > 0);
+            BitVector current_base = std::move(current_prefix);
+            // Append HI decision bit
+            current_base.push_back(HI);
+            // Process potential don't care bits
+            push_expanded(highs[current_node], std::move(current_base), transition_length - 1);
+        }
+    }
+
+    return result;
+}
+
+NodeId ArenaMtRobdd::restrict(const NodeId f, const VarIndex var_index, const Bit value) {
+    UnaryTable computed_table;
+
+    std::function<NodeId(NodeId)> restrict_rec = [&](const NodeId node) -> NodeId {
+        // Variables are ordered, so nodes below the variable do not test it.
+        if (is_leaf(node) || var_indices[node] > var_index) {
+            return node;
+        }
+        if (var_indices[node] == var_index) {
+            return (value == HI) ? highs[node] : lows[node];
+        }
+        if (auto it = computed_table.find(node); it != computed_table.end()) {
+            return it->second;
+        }
+
+        const VarIndex node_var_index = var_indices[node];
+        const NodeId node_low = lows[node];
+        const NodeId node_high = highs[node];
+        assert(has_virtual_sink() || (node_low != NULL_NODE && node_high != NULL_NODE));
+        const NodeId low = restrict_rec(node_low);
+        const NodeId high = restrict_rec(node_high);
+        const NodeId result = create_reduced_node(node_var_index, low, high);
+
+        computed_table[node] = result;
+        return result;
+    };
+
+    return restrict_rec(f);
+}
+
+NodeId ArenaMtRobdd::ite(const NodeId f, const NodeId g, const NodeId h) {
+    struct TripleHash {
+        size_t operator()(const std::tuple<NodeId, NodeId, NodeId>& key) const {
+            const auto [a, b, c] = key;
+            return hash_node(static_cast<VarIndex>(a), b, c, 0);
+        }
+    };
+    std::unordered_map<std::tuple<NodeId, NodeId, NodeId>, NodeId, TripleHash> computed_table;
+
+    std::function<NodeId(NodeId, NodeId, NodeId)> ite_rec = [&](const NodeId cond, const NodeId then_node, const NodeId else_node) -> NodeId {
+        if (is_leaf(cond)) {
+            return (get_leaf_value(cond) != 0) ? then_node : else_node;
+        }
+        if (then_node == else_node) {
+            return then_node;
+        }
+        const auto key = std::make_tuple(cond, then_node, else_node);
+        if (auto it = computed_table.find(key); it != computed_table.end()) {
+            return it->second;
+        }
+
+        const VarIndex top = get_top_var_index(cond, then_node, else_node);
+        const auto [cond_low, cond_high] = get_cofactors(cond, top);
+        const auto [then_low, then_high] = get_cofactors(then_node, top);
+        const auto [else_low, else_high] = get_cofactors(else_node, top);
+        const NodeId low = ite_rec(cond_low, then_low, else_low);
+        const NodeId high = ite_rec(cond_high, then_high, else_high);
+        const NodeId result = create_reduced_node(top, low, high);
+
+        computed_table[key] = result;
+        return result;
+    };
+
+    return ite_rec(f, g, h);
+}
+
+bool ArenaMtRobdd::uses_virtual_sink() const {
+    for (const auto& [name, root_node] : root_nodes_map) {
+        if (root_node == NULL_NODE) {
+            return true;
+        }
+    }
+    for (const NodeId node : get_reachable_post_order()) {
+        if (!is_terminal(node) && (lows[node] == NULL_NODE || highs[node] == NULL_NODE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ArenaMtRobdd& ArenaMtRobdd::trim() {
+    const std::vector<NodeId> order = get_reachable_post_order();
+
+    // Compact the arena; new ids follow the post-order,
+    // so children always get smaller ids than their parents.
+    std::vector<NodeId> new_ids(var_indices.size(), NULL_NODE);
+    std::vector<VarIndex> new_var_indices(order.size());
+    std::vector<NodeId> new_lows(order.size());
+    std::vector<NodeId> new_highs(order.size());
+    std::vector<NodeValue> new_values(order.size());
+    for (NodeId new_id = 0; new_id < order.size(); ++new_id) {
+        const NodeId node = order[new_id];
+        new_ids[node] = new_id;
+        new_var_indices[new_id] = var_indices[node];
+        new_lows[new_id] = (lows[node] == NULL_NODE) ? NULL_NODE : new_ids[lows[node]];
+        new_highs[new_id] = (highs[node] == NULL_NODE) ? NULL_NODE : new_ids[highs[node]];
+        new_values[new_id] = values[node];
+    }
+
+    // Update nodes.
+    var_indices = std::move(new_var_indices);
+    lows = std::move(new_lows);
+    highs = std::move(new_highs);
+    values = std::move(new_values);
+    for (auto& [name, root_node] : root_nodes_map) {
+        if (root_node != NULL_NODE) {
+            root_node = new_ids[root_node];
+        }
+    }
+    rebuild_unique_table();
+
+    return *this;
+}
+
+ArenaMtRobdd& ArenaMtRobdd::remove_redundant_tests() {
+    ArenaMtRobdd reduced(num_of_vars);
+    reduced.virtual_sink_value = virtual_sink_value;
+    std::vector<NodeId> new_ids(var_indices.size(), NULL_NODE);
+
+    // Children are processed before parents, so their reduced form is already known.
+    for (const NodeId node : get_reachable_post_order()) {
+        if (is_terminal(node)) {
+            new_ids[node] = reduced.create_terminal_node(values[node]);
+            continue;
+        }
+
+        const NodeId low_child = (lows[node] == NULL_NODE) ? NULL_NODE : new_ids[lows[node]];
+        const NodeId high_child = (highs[node] == NULL_NODE) ? NULL_NODE : new_ids[highs[node]];
+
+        // If both children are the same, skip this test node
+        // (missing children are the same only if they lead to the virtual sink)
+        if (low_child == high_child && (low_child != NULL_NODE || has_virtual_sink())) {
+            new_ids[node] = low_child;
+        } else {
+            new_ids[node] = reduced.create_node(var_indices[node], low_child, high_child, values[node]);
+        }
+    }
+
+    for (const auto& [name, root_node] : root_nodes_map) {
+        reduced.root_nodes_map[name] = (root_node == NULL_NODE) ? NULL_NODE : new_ids[root_node];
+    }
+    *this = std::move(reduced);
+
+    return *this;
+}
+
+ArenaMtRobdd& ArenaMtRobdd::make_complete(const NodeValue sink_value, const bool complete_terminal_nodes) {
+    // Nodes are rebuilt into a new arena, because filling missing
+    // children in place would invalidate their unique table entries.
+    ArenaMtRobdd completed(num_of_vars);
+    std::vector<NodeId> new_ids(var_indices.size(), NULL_NODE);
+    NodeId terminal_sink = NULL_NODE;
+    // Missing children lead to the virtual sink if there is one.
+    const NodeValue completed_sink_value = has_virtual_sink() ? virtual_sink_value : sink_value;
+    auto get_sink = [&]() {
+        if (terminal_sink == NULL_NODE) {
+            terminal_sink = completed.create_terminal_node(completed_sink_value);
+        }
+        return terminal_sink;
+    };
+
+    for (const NodeId node : get_reachable_post_order()) {
+        if (is_terminal(node)) {
+            new_ids[node] = completed.create_terminal_node(values[node]);
+            // Complete terminal nodes that don't have an appropriate root mapping.
+            // Each such new root will point directly to the terminal sink node.
+            if (complete_terminal_nodes && !root_nodes_map.contains(values[node])) {
+                completed.root_nodes_map[values[node]] = get_sink();
+            }
+            continue;
+        }
+
+        const NodeId low_child = (lows[node] == NULL_NODE) ? get_sink() : new_ids[lows[node]];
+        const NodeId high_child = (highs[node] == NULL_NODE) ? get_sink() : new_ids[highs[node]];
+        new_ids[node] = completed.create_node(var_indices[node], low_child, high_child, values[node]);
+    }
+
+    for (const auto& [name, root_node] : root_nodes_map) {
+        completed.root_nodes_map[name] = (root_node == NULL_NODE) ? get_sink() : new_ids[root_node];
+    }
+    if (terminal_sink != NULL_NODE) {
+        completed.root_nodes_map[completed_sink_value] = terminal_sink;
+    }
+    *this = std::move(completed);
+
+    return *this;
+}
+
+void ArenaMtRobdd::_print_as_dot(std::ostream& os) const {
+    const std::vector<NodeId> order = get_reachable_post_order();
+
+    // Group nodes by variable index
+    std::unordered_map<VarIndex, std::vector<NodeId>> levels;
+    for (const NodeId node : order) {
+        levels[var_indices[node]].push_back(node);
+    }
+
+    // Header
+    os << "digraph MtRobdd {\n";
+    os << "  rankdir=LR;\n";
+
+    // Define pre-root nodes
+    os << "  node [shape=circle];\n";
+    os << "  // Pre-root nodes\n";
+    os << "  { rank=same; ";
+    for (const auto& [name, root_node] : root_nodes_map) {
+        std::string name_str = name == SINK_VALUE ? "sink" : std::to_string(name);
+        os << name << " [label=\""<< name_str << "\"]; ";
+    }
+    os << "}\n";
+
+    // Define non-terminal nodes
+    // with respect to their levels
+    os << "  node [shape=box];\n";
+    for (size_t var_index = 0; var_index < num_of_vars; ++var_index) {
+        os << "  // Level " << var_index << "\n";
+        os << "  { rank=same; ";
+        for (const NodeId node : levels[static_cast<VarIndex>(var_index)]) {
+            os << "n" << node << " [label=\"Var " << var_indices[node] << "\"]; ";
+        }
+        os << "}\n";
+    }
+
+    // Define terminal nodes
+    os << "  node [shape=doublecircle];\n";
+    os << "  // Terminal nodes\n";
+    os << "  { rank=same; ";
+    for (const NodeId node : levels[TERMINAL_INDEX]) {
+        std::string label = values[node] == SINK_VALUE ? "sink" : std::to_string(values[node]);
+        os << "n" << node << " [label=\"" << label << "\"]; ";
+    }
+    os << "}\n";
+
+    // The virtual sink is drawn as a dashed terminal node
+    if (has_virtual_sink()) {
+        os << "  vsink [label=\"" << virtual_sink_value << "\", style=dashed];\n";
+    }
+    auto node_name = [](const NodeId node) {
+        return (node == NULL_NODE) ? std::string("vsink") : "n" + std::to_string(node);
+    };
+
+    // Define edges from pre-root nodes to root nodes
+    os << "  // Edges from pre-root nodes\n";
+    for (const auto& [name, root_node] : root_nodes_map) {
+        os << "  " << name << " -> " << node_name(root_node) << ";\n";
+    }
+
+    // Define edges between rest of the nodes
+    os << "  // Edges between nodes\n";
+    for (const NodeId node : order) {
+        if (lows[node] != NULL_NODE || (has_virtual_sink() && !is_terminal(node))) {
+            os << "  n" << node << " -> " << node_name(lows[node]) << " [label=\"0\"];\n";
+        }
+        if (highs[node] != NULL_NODE || (has_virtual_sink() && !is_terminal(node))) {
+            os << "  n" << node << " -> " << node_name(highs[node]) << " [label=\"1\"];\n";
+        }
+    }
+    os << "}\n";
+}
+
+} // namespace mamonata::mtrobdd
@@ -1,5 +1,8 @@
 #include "mata-bridge/nfa.hh"
 
+#include <algorithm>
+#include <cassert>
+
 // In order to mitigate copy/move overhead, each function
 // returning a new Nfa instance uses a temporary variable
 // and swaps its content with the current instance.
@@ -10,8 +13,54 @@
 // around such function calls. Additionaly, the swap
 // operation is generally cheaper than move operation.
 
+namespace {
+
+// Parameters selecting the antichain-based algorithms of Mata.
+const mata::ParameterMap ANTICHAINS_PARAMS = { { "algorithm", "antichains" } };
+
+/**
+ * @brief Extracts the word of a run returned by Mata as a counterexample.
+ * If Mata provides only the path, one symbol of a transition between each pair of consecutive states is used.
+ *
+ * @param nfa NFA the run belongs to.
+ * @param run Counterexample run.
+ *
+ * @return Word read along the run.
+ */
+mata::Word get_run_word(const mata::nfa::Nfa& nfa, const mata::nfa::Run& run) {
+    if (run.path.size() <= 1 || run.word.size() + 1 == run.path.size()) {
+        return run.word;
+    }
+    mata::Word word;
+    word.reserve(run.path.size() - 1);
+    for (size_t i = 0; i + 1 < run.path.size(); ++i) {
+        for (const auto& symbol_post : nfa.delta[run.path[i]]) {
+            if (std::binary_search(symbol_post.targets.begin(), symbol_post.targets.end(), run.path[i + 1])) {
+                word.push_back(symbol_post.symbol);
+                break;
+            }
+        }
+    }
+    return word;
+}
+
+} // namespace
+
 namespace mamonata::mata::nfa {
 
+size_t Nfa::memory_footprint() const {
+    const size_t num_of_states = nfa_impl.num_of_states();
+    size_t bytes = sizeof(Nfa) + num_of_states * sizeof(StatePost);
+    for (State state = 0; state < nfa_impl.delta.num_of_states(); ++state) {
+        for (const SymbolPost& symbol_post : nfa_impl.delta[state]) {
+            bytes += sizeof(SymbolPost) + symbol_post.targets.size() * sizeof(State);
+        }
+    }
+    // Dense and sparse vectors of the initial and final sets span all states.
+    bytes += 2 * 2 * num_of_states * sizeof(State);
+    return bytes;
+}
+
 Nfa& Nfa::trim() {
     TIME(nfa_impl.trim());
     return *this;
@@ -71,17 +120,97 @@ Nfa& Nfa::union_det_complete(const Nfa& aut) {
 }
 
 Nfa& Nfa::determinize() {
-    TIME(auto tmp{ mata::nfa::determinize(nfa_impl) });
+    TIME(auto tmp{ mata::nfa::determinize(nfa_impl) };
+         COUNT(MATA_DETERMINIZE_STATES, tmp.num_of_states()));
     std::swap(nfa_impl, tmp);
     return *this;
 }
 
 Nfa& Nfa::intersection(const Nfa& aut, const Symbol first_epsilon) {
-    TIME(auto tmp{ mata::nfa::intersection(nfa_impl, aut.nfa_impl, first_epsilon) });
+    TIME(auto tmp{ mata::nfa::intersection(nfa_impl, aut.nfa_impl, first_epsilon) };
+         COUNT(MATA_INTERSECTION_STATES, tmp.num_of_states()));
     std::swap(nfa_impl, tmp);
     return *this;
 }
 
+Nfa Nfa::intersection_all(const std::span<const Nfa> operands, const ProductOptions& options) {
+    Timer::Span span(__func__);
+    return combine_all(operands, options,
+        [](const Nfa& aut) { return aut.num_of_states(); },
+        [](Nfa& lhs, const Nfa& rhs) { lhs.intersection(rhs).trim(); },
+        [](Nfa& aut) { aut.reduce_simulation(); },
+        [](const Nfa& aut) { return aut.num_of_states() == 0; },
+        true);
+}
+
+Nfa Nfa::union_all(const std::span<const Nfa> operands, const ProductOptions& options) {
+    Timer::Span span(__func__);
+    // Minimization expects a trimmed automaton and drops the sink state, which the next
+    // union needs, so reduced products are completed again over the alphabet of all operands.
+    SymbolVector symbols;
+    for (const Nfa& operand : operands) {
+        const SymbolVector used_symbols = operand.get_used_symbols();
+        symbols.insert(symbols.end(), used_symbols.begin(), used_symbols.end());
+    }
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    const OrdVector<Symbol> alphabet{ symbols.begin(), symbols.end() };
+
+    Nfa result = combine_all(operands, options,
+        [](const Nfa& aut) { return aut.num_of_states(); },
+        [](Nfa& lhs, const Nfa& rhs) { lhs.union_det_complete(rhs); },
+        [&alphabet](Nfa& aut) {
+            // A single pass adds the sink state and the missing transitions to the minimal DFA.
+            aut.trim().minimize_hopcroft();
+            aut.nfa_impl.make_complete(alphabet);
+        },
+        [](const Nfa&) { return false; },
+        true);
+
+#ifdef DEBUG
+    Nfa left_fold = operands.front();
+    for (size_t i = 1; i < operands.size(); ++i) {
+        left_fold.union_det_complete(operands[i]);
+    }
+    assert(result.are_equivalent(left_fold));
+#endif
+
+    return result;
+}
+
+bool Nfa::is_empty(SymbolVector* witness) const {
+    mata::nfa::Run run;
+    TIME(const bool is_lang_empty = nfa_impl.is_lang_empty((witness != nullptr) ? &run : nullptr));
+    if (!is_lang_empty && witness != nullptr) {
+        *witness = get_run_word(nfa_impl, run);
+    }
+    return is_lang_empty;
+}
+
+bool Nfa::is_included(const Nfa& other, SymbolVector* witness) const {
+    mata::nfa::Run run;
+    TIME(const bool included = mata::nfa::is_included(nfa_impl, other.nfa_impl, (witness != nullptr) ? &run : nullptr,
+                                                      nullptr, ANTICHAINS_PARAMS));
+    if (!included && witness != nullptr) {
+        *witness = run.word;
+    }
+    return included;
+}
+
+bool Nfa::are_equivalent(const Nfa& other, SymbolVector* witness) const {
+    if (witness == nullptr) {
+        TIME(const bool equivalent = mata::nfa::are_equivalent(nfa_impl, other.nfa_impl, nullptr, ANTICHAINS_PARAMS));
+        return equivalent;
+    }
+    mata::nfa::Run run;
+    TIME(const bool equivalent = mata::nfa::is_included(nfa_impl, other.nfa_impl, &run, nullptr, ANTICHAINS_PARAMS) &&
+                                 mata::nfa::is_included(other.nfa_impl, nfa_impl, &run, nullptr, ANTICHAINS_PARAMS));
+    if (!equivalent) {
+        *witness = run.word;
+    }
+    return equivalent;
+}
+
 Nfa& Nfa::complement_classical(const SymbolVector& symbols) {
     OrdVector<Symbol> ord_symbols{ symbols.begin(), symbols.end() };
     TIME(auto tmp{ mata::nfa::algorithms::complement_classical(nfa_impl, ord_symbols) });
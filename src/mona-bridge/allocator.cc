@@ -0,0 +1,240 @@
+#include "mona-bridge/allocator.hh"
+#include "counters.hh"
+
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+using mamonata::mona::MonaAllocator;
+
+// Size class of blocks allocated directly by malloc.
+constexpr size_t LARGE_SIZE_CLASS = MonaAllocator::NUM_OF_SIZE_CLASSES;
+
+// Header preceding every block; keeps the payload aligned as by malloc.
+struct alignas(std::max_align_t) BlockHeader {
+    size_t size_class;  // Size class of the block, or LARGE_SIZE_CLASS
+    size_t block_size;  // Usable size of the block
+};
+
+// Free lists of one thread. The first word of a cached block points to the next cached block.
+// Trivially destructible, so it stays accessible while other thread-local objects are destroyed.
+struct FreeLists {
+    std::array<void*, MonaAllocator::NUM_OF_SIZE_CLASSES> heads{};
+    size_t cached_bytes = 0;
+};
+
+thread_local FreeLists free_lists;
+thread_local bool is_thread_exiting = false;
+
+// Returns the cached blocks to the system when the thread exits.
+struct ThreadCacheReleaser {
+    void touch() {}
+
+    ~ThreadCacheReleaser() {
+        MonaAllocator::instance().release_cached();
+        is_thread_exiting = true;
+    }
+};
+
+thread_local ThreadCacheReleaser thread_cache_releaser;
+
+// Returns the size class of a block of the given size (LARGE_SIZE_CLASS if it has none).
+size_t get_size_class(const size_t size) {
+    if (size <= MonaAllocator::MIN_BLOCK_SIZE) {
+        return 0;
+    }
+    const size_t size_class = static_cast<size_t>(std::bit_width(size - 1)) -
+                              static_cast<size_t>(std::bit_width(MonaAllocator::MIN_BLOCK_SIZE - 1));
+    return (size_class < MonaAllocator::NUM_OF_SIZE_CLASSES) ? size_class : LARGE_SIZE_CLASS;
+}
+
+BlockHeader* get_header(void* ptr) {
+    return static_cast<BlockHeader*>(ptr) - 1;
+}
+
+// Reports the failed allocation and terminates the process as MONA's mem_alloc does.
+[[noreturn]] void out_of_memory() {
+    std::fputs("\n\n*** Out of memory ***\n", stderr);
+    std::exit(-1);
+}
+
+} // namespace
+
+namespace mamonata::mona {
+
+MonaAllocator& MonaAllocator::instance() {
+    static MonaAllocator instance;
+    return instance;
+}
+
+void MonaAllocator::record_allocation(const size_t block_size) {
+    // Also counted per thread, so the Timer attributes allocations to the running operation.
+    COUNT(MONA_ALLOCATIONS, 1);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes_allocated.fetch_add(block_size, std::memory_order_relaxed);
+    const size_t live = bytes_live.fetch_add(block_size, std::memory_order_relaxed) + block_size;
+    size_t peak = bytes_peak.load(std::memory_order_relaxed);
+    while (live > peak && !bytes_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void* MonaAllocator::allocate(const size_t size) {
+    const size_t size_class = get_size_class(size);
+    const size_t block_size = (size_class == LARGE_SIZE_CLASS) ? size : (MIN_BLOCK_SIZE << size_class);
+
+    void* payload = nullptr;
+    if (size_class != LARGE_SIZE_CLASS && free_lists.heads[size_class] != nullptr) {
+        payload = free_lists.heads[size_class];
+        free_lists.heads[size_class] = *static_cast<void**>(payload);
+        free_lists.cached_bytes -= block_size;
+        bytes_cached.fetch_sub(block_size, std::memory_order_relaxed);
+        pool_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        void* raw = std::malloc(sizeof(BlockHeader) + block_size);
+        if (raw == nullptr) {
+            out_of_memory();
+        }
+        payload = new (raw) BlockHeader{ size_class, block_size } + 1;
+    }
+    record_allocation(block_size);
+    return payload;
+}
+
+void MonaAllocator::deallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    BlockHeader* header = get_header(ptr);
+    const size_t block_size = header->block_size;
+    frees.fetch_add(1, std::memory_order_relaxed);
+    bytes_live.fetch_sub(block_size, std::memory_order_relaxed);
+
+    if (header->size_class != LARGE_SIZE_CLASS && is_recycling() && !is_thread_exiting &&
+        free_lists.cached_bytes + block_size <= cache_limit_bytes.load(std::memory_order_relaxed)) {
+        // Registers the release of the cache at thread exit.
+        thread_cache_releaser.touch();
+        *static_cast<void**>(ptr) = free_lists.heads[header->size_class];
+        free_lists.heads[header->size_class] = ptr;
+        free_lists.cached_bytes += block_size;
+        bytes_cached.fetch_add(block_size, std::memory_order_relaxed);
+        return;
+    }
+    std::free(header);
+}
+
+void* MonaAllocator::reallocate(void* ptr, const size_t size) {
+    resizes.fetch_add(1, std::memory_order_relaxed);
+    if (ptr == nullptr) {
+        return allocate(size);
+    }
+    BlockHeader* header = get_header(ptr);
+    if (size <= header->block_size) {
+        return ptr;
+    }
+
+    // Large blocks stay large, so realloc may grow them in place.
+    if (header->size_class == LARGE_SIZE_CLASS) {
+        const size_t old_size = header->block_size;
+        void* raw = std::realloc(header, sizeof(BlockHeader) + size);
+        if (raw == nullptr) {
+            out_of_memory();
+        }
+        header = static_cast<BlockHeader*>(raw);
+        header->block_size = size;
+        frees.fetch_add(1, std::memory_order_relaxed);
+        bytes_live.fetch_sub(old_size, std::memory_order_relaxed);
+        record_allocation(size);
+        return header + 1;
+    }
+
+    void* new_ptr = allocate(size);
+    std::memcpy(new_ptr, ptr, header->block_size);
+    deallocate(ptr);
+    return new_ptr;
+}
+
+void MonaAllocator::set_recycling(const bool enabled) {
+    recycling.store(enabled, std::memory_order_relaxed);
+    if (!enabled) {
+        release_cached();
+    }
+}
+
+void MonaAllocator::release_cached() {
+    for (void*& head : free_lists.heads) {
+        while (head != nullptr) {
+            void* next = *static_cast<void**>(head);
+            std::free(get_header(head));
+            head = next;
+        }
+    }
+    bytes_cached.fetch_sub(free_lists.cached_bytes, std::memory_order_relaxed);
+    free_lists.cached_bytes = 0;
+}
+
+void MonaAllocator::reset_statistics() {
+    allocations.store(0, std::memory_order_relaxed);
+    frees.store(0, std::memory_order_relaxed);
+    resizes.store(0, std::memory_order_relaxed);
+    pool_hits.store(0, std::memory_order_relaxed);
+    bytes_allocated.store(0, std::memory_order_relaxed);
+    bytes_peak.store(bytes_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+MonaAllocator::Statistics MonaAllocator::get_statistics() const {
+    Statistics stats;
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.frees = frees.load(std::memory_order_relaxed);
+    stats.resizes = resizes.load(std::memory_order_relaxed);
+    stats.pool_hits = pool_hits.load(std::memory_order_relaxed);
+    stats.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+    stats.bytes_live = bytes_live.load(std::memory_order_relaxed);
+    stats.bytes_peak = bytes_peak.load(std::memory_order_relaxed);
+    stats.bytes_cached = bytes_cached.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MonaAllocator::export_csv(std::ostream& os) const {
+    const Statistics stats = get_statistics();
+    os << "allocations,frees,resizes,pool_hits,bytes_allocated,bytes_live,bytes_peak,bytes_cached\n";
+    os << stats.allocations << ',' << stats.frees << ',' << stats.resizes << ',' << stats.pool_hits << ','
+       << stats.bytes_allocated << ',' << stats.bytes_live << ',' << stats.bytes_peak << ','
+       << stats.bytes_cached << '\n';
+}
+
+void MonaAllocator::export_json(std::ostream& os) const {
+    const Statistics stats = get_statistics();
+    os << "{\"allocations\":" << stats.allocations
+       << ",\"frees\":" << stats.frees
+       << ",\"resizes\":" << stats.resizes
+       << ",\"pool_hits\":" << stats.pool_hits
+       << ",\"bytes_allocated\":" << stats.bytes_allocated
+       << ",\"bytes_live\":" << stats.bytes_live
+       << ",\"bytes_peak\":" << stats.bytes_peak
+       << ",\"bytes_cached\":" << stats.bytes_cached << "}\n";
+}
+
+} // namespace mamonata::mona
+
+#ifdef MAMONATA_MONA_ALLOCATOR
+// Targets of the linker option --wrap: MONA's calls of mem_alloc, mem_free and mem_resize resolve here.
+extern "C" {
+
+void* __wrap_mem_alloc(size_t size) {
+    return mamonata::mona::MonaAllocator::instance().allocate(size);
+}
+
+void __wrap_mem_free(void* ptr) {
+    mamonata::mona::MonaAllocator::instance().deallocate(ptr);
+}
+
+void* __wrap_mem_resize(void* ptr, size_t size) {
+    return mamonata::mona::MonaAllocator::instance().reallocate(ptr, size);
+}
+
+}
+#endif
@@ -0,0 +1,313 @@
+#include "mona-bridge/nfa.hh"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary on-disk format of MONA-bridge automata.
+//
+// Layout (all sections are 8-byte aligned, values in native byte order):
+//   BinaryHeader
+//   BinaryNode[num_of_nodes]       shared BDD nodes, children precede parents
+//   uint32_t[num_of_states]        root node of each state
+//   int32_t[num_of_states]         final flags as in MONA (1 final, -1 nonfinal)
+//   BinaryAlphabetEntry[alphabet_size] followed by its code packed into
+//                                  code_words 64-bit words (first variable is the most significant bit)
+
+namespace {
+
+constexpr char BINARY_MAGIC[8] = { 'M', 'A', 'M', 'O', 'N', 'A', 'T', 'A' };
+constexpr uint32_t BINARY_VERSION = 1;
+constexpr uint32_t BINARY_BYTE_ORDER_MARK = 0x01020304;
+constexpr int32_t BINARY_TERMINAL_INDEX = -1;
+
+struct BinaryHeader {
+    char magic[8];                  // BINARY_MAGIC
+    uint32_t version;               // BINARY_VERSION
+    uint32_t byte_order;            // BINARY_BYTE_ORDER_MARK written in native byte order
+    uint64_t file_size;             // Size of the whole file in bytes
+    uint64_t num_of_states;         // Number of DFA states
+    uint64_t initial_state;         // Initial DFA state
+    uint64_t num_of_vars;           // Total number of variables (alphabet + nondet)
+    uint64_t num_of_alphabet_vars;  // Number of variables for alphabet encoding
+    uint64_t num_of_nondet_vars;    // Number of variables for nondeterminism encoding
+    uint64_t nondeterminism_level;  // Maximum number of nondeterministic transitions
+    uint64_t alphabet_size;         // Number of entries in the alphabet encoding dictionary
+    uint64_t num_of_nodes;          // Number of BDD nodes
+    uint64_t nodes_offset;          // Offset of the node table
+    uint64_t roots_offset;          // Offset of the state roots
+    uint64_t finals_offset;         // Offset of the final flags
+    uint64_t alphabet_offset;       // Offset of the alphabet encoding dictionary
+};
+
+struct BinaryNode {
+    int32_t var_index;  // Variable index; BINARY_TERMINAL_INDEX for terminal nodes
+    uint32_t low;       // LOW child; state for terminal nodes
+    uint32_t high;      // HIGH child; 0 for terminal nodes
+};
+
+struct BinaryAlphabetEntry {
+    uint64_t symbol;    // Symbol whose code follows
+};
+
+// Rounds a byte count up to the section alignment.
+constexpr uint64_t align_section(const uint64_t size) {
+    return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Returns number of 64-bit words needed to store a code of the given length.
+constexpr uint64_t get_num_of_code_words(const uint64_t num_of_bits) {
+    return (num_of_bits + 63) / 64;
+}
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+class MappedFile {
+    void* data = MAP_FAILED;
+    size_t size = 0;
+
+public:
+    explicit MappedFile(const std::filesystem::path& file_path) {
+        const int fd = ::open(file_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open file: " + file_path.string());
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(BinaryHeader))) {
+            ::close(fd);
+            throw std::runtime_error("Not a MaMONAta binary automaton: " + file_path.string());
+        }
+        size = static_cast<size_t>(st.st_size);
+        data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Could not map file: " + file_path.string());
+        }
+        // Sections are read front to back exactly once.
+        ::madvise(data, size, MADV_SEQUENTIAL | MADV_WILLNEED);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data != MAP_FAILED) {
+            ::munmap(data, size);
+        }
+    }
+
+    const char* bytes() const {
+        return static_cast<const char*>(data);
+    }
+
+    size_t get_size() const {
+        return size;
+    }
+};
+
+// Checks that a section of the given number of elements lies within the file.
+bool is_section_valid(const BinaryHeader& header, const uint64_t offset, const uint64_t count, const uint64_t element_size) {
+    return offset % 8 == 0 && offset <= header.file_size &&
+           (element_size == 0 || count <= (header.file_size - offset) / element_size);
+}
+
+} // namespace
+
+namespace mamonata::mona::nfa {
+
+void Nfa::save_binary(const std::filesystem::path& file_path) const {
+    assert(nfa_impl != nullptr);
+    const uint64_t num_of_states = static_cast<uint64_t>(nfa_impl->ns);
+
+    // Trimming the arena renumbers the nodes in post-order,
+    // which is exactly the order in which MONA nodes can be created when loading.
+    mamonata::mtrobdd::ArenaMtRobdd mtrobdd_manager(num_of_vars, nfa_impl->bddm, nfa_impl->q, num_of_states);
+    mtrobdd_manager.trim();
+    const uint64_t num_of_nodes = mtrobdd_manager.get_num_of_nodes();
+
+    // Entries are written in the order of their codes.
+    std::vector<std::pair<Symbol, Code>> alphabet_entries;
+    alphabet_entries.reserve(alphabet_encoding->size());
+    alphabet_encoding->for_each([&](const Symbol symbol, const Code code) {
+        alphabet_entries.emplace_back(symbol, code);
+    });
+    const uint64_t code_words = get_num_of_code_words(num_of_alphabet_vars);
+
+    BinaryHeader header{};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version = BINARY_VERSION;
+    header.byte_order = BINARY_BYTE_ORDER_MARK;
+    header.num_of_states = num_of_states;
+    header.initial_state = static_cast<uint64_t>(nfa_impl->s);
+    header.num_of_vars = num_of_vars;
+    header.num_of_alphabet_vars = num_of_alphabet_vars;
+    header.num_of_nondet_vars = num_of_nondet_vars;
+    header.nondeterminism_level = nondeterminism_level;
+    header.alphabet_size = alphabet_entries.size();
+    header.num_of_nodes = num_of_nodes;
+    header.nodes_offset = align_section(sizeof(BinaryHeader));
+    header.roots_offset = header.nodes_offset + align_section(num_of_nodes * sizeof(BinaryNode));
+    header.finals_offset = header.roots_offset + align_section(num_of_states * sizeof(uint32_t));
+    header.alphabet_offset = header.finals_offset + align_section(num_of_states * sizeof(int32_t));
+    header.file_size = header.alphabet_offset +
+                       alphabet_entries.size() * (sizeof(BinaryAlphabetEntry) + code_words * sizeof(uint64_t));
+
+    // Serialize into a single buffer; padding bytes stay zero.
+    std::vector<char> buffer(header.file_size, 0);
+    std::memcpy(buffer.data(), &header, sizeof(BinaryHeader));
+
+    BinaryNode* nodes = reinterpret_cast<BinaryNode*>(buffer.data() + header.nodes_offset);
+    for (mamonata::mtrobdd::NodeId node = 0; node < num_of_nodes; ++node) {
+        if (mtrobdd_manager.is_terminal(node)) {
+            nodes[node] = { BINARY_TERMINAL_INDEX, static_cast<uint32_t>(mtrobdd_manager.get_value(node)), 0 };
+        } else {
+            nodes[node] = { static_cast<int32_t>(mtrobdd_manager.get_var_index(node)),
+                            mtrobdd_manager.get_low(node),
+                            mtrobdd_manager.get_high(node) };
+        }
+    }
+
+    uint32_t* roots = reinterpret_cast<uint32_t*>(buffer.data() + header.roots_offset);
+    int32_t* finals = reinterpret_cast<int32_t*>(buffer.data() + header.finals_offset);
+    for (uint64_t state = 0; state < num_of_states; ++state) {
+        roots[state] = mtrobdd_manager.get_root_node(state);
+        finals[state] = nfa_impl->f[state];
+    }
+
+    char* entry_ptr = buffer.data() + header.alphabet_offset;
+    for (const auto& [symbol, code] : alphabet_entries) {
+        const BinaryAlphabetEntry entry{ static_cast<uint64_t>(symbol) };
+        std::memcpy(entry_ptr, &entry, sizeof(BinaryAlphabetEntry));
+        entry_ptr += sizeof(BinaryAlphabetEntry);
+        // Codes have less than 64 variables and are aligned to the most significant bit of the first word.
+        if (code_words > 0) {
+            std::vector<uint64_t> words(code_words, 0);
+            words[0] = code << (64 - num_of_alphabet_vars);
+            std::memcpy(entry_ptr, words.data(), code_words * sizeof(uint64_t));
+        }
+        entry_ptr += code_words * sizeof(uint64_t);
+    }
+
+    std::ofstream ofs(file_path, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+        throw std::runtime_error("Could not open file: " + file_path.string());
+    }
+    ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!ofs) {
+        throw std::runtime_error("Could not write file: " + file_path.string());
+    }
+}
+
+Nfa& Nfa::load_binary(const std::filesystem::path& file_path) {
+    const MappedFile file(file_path);
+    const std::string invalid_file_msg = "Not a valid MaMONAta binary automaton: " + file_path.string();
+
+    // Validate the header before touching any section.
+    BinaryHeader header;
+    std::memcpy(&header, file.bytes(), sizeof(BinaryHeader));
+    if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        throw std::runtime_error(invalid_file_msg);
+    }
+    if (header.byte_order != BINARY_BYTE_ORDER_MARK) {
+        throw std::runtime_error("Unsupported byte order of MaMONAta binary automaton: " + file_path.string());
+    }
+    if (header.version != BINARY_VERSION) {
+        throw std::runtime_error("Unsupported version " + std::to_string(header.version) +
+                                 " of MaMONAta binary automaton: " + file_path.string());
+    }
+    const uint64_t code_words = get_num_of_code_words(header.num_of_alphabet_vars);
+    if (header.file_size != file.get_size() ||
+        header.num_of_states == 0 || header.initial_state >= header.num_of_states ||
+        header.num_of_states > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+        header.num_of_nodes > static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) ||
+        header.num_of_alphabet_vars + header.num_of_nondet_vars != header.num_of_vars ||
+        header.num_of_alphabet_vars >= 64 ||
+        !is_section_valid(header, header.nodes_offset, header.num_of_nodes, sizeof(BinaryNode)) ||
+        !is_section_valid(header, header.roots_offset, header.num_of_states, sizeof(uint32_t)) ||
+        !is_section_valid(header, header.finals_offset, header.num_of_states, sizeof(int32_t)) ||
+        !is_section_valid(header, header.alphabet_offset, header.alphabet_size,
+                          sizeof(BinaryAlphabetEntry) + code_words * sizeof(uint64_t))) {
+        throw std::runtime_error(invalid_file_msg);
+    }
+
+    const BinaryNode* nodes = reinterpret_cast<const BinaryNode*>(file.bytes() + header.nodes_offset);
+    const uint32_t* roots = reinterpret_cast<const uint32_t*>(file.bytes() + header.roots_offset);
+    const int32_t* finals = reinterpret_cast<const int32_t*>(file.bytes() + header.finals_offset);
+
+    // Children precede parents in the node table,
+    // so each MONA node can be created right away.
+    DFA* loaded = dfaMake(static_cast<int>(header.num_of_states));
+    mamonata::mtrobdd::reserve_mona_nodes(loaded->bddm, header.num_of_nodes);
+    std::vector<bdd_ptr> mona_nodes(header.num_of_nodes);
+    // MONA expects variables to be tested in increasing order along every path.
+    auto is_below = [&](const BinaryNode& node, const uint32_t child) {
+        return nodes[child].var_index == BINARY_TERMINAL_INDEX || nodes[child].var_index > node.var_index;
+    };
+    for (uint64_t i = 0; i < header.num_of_nodes; ++i) {
+        const BinaryNode& node = nodes[i];
+        const bool is_valid = (node.var_index == BINARY_TERMINAL_INDEX)
+            ? node.low < header.num_of_states
+            : node.var_index >= 0 && static_cast<uint64_t>(node.var_index) < header.num_of_vars &&
+              node.low < i && node.high < i && node.low != node.high &&
+              is_below(node, node.low) && is_below(node, node.high);
+        if (!is_valid) {
+            dfaFree(loaded);
+            throw std::runtime_error(invalid_file_msg);
+        }
+        if (node.var_index == BINARY_TERMINAL_INDEX) {
+            mona_nodes[i] = bdd_find_leaf_sequential(loaded->bddm, node.low);
+        } else {
+            mona_nodes[i] = bdd_find_node_sequential(loaded->bddm,
+                                                     mona_nodes[node.low],
+                                                     mona_nodes[node.high],
+                                                     static_cast<unsigned>(node.var_index));
+        }
+    }
+    for (uint64_t state = 0; state < header.num_of_states; ++state) {
+        // Final flags are -1 (reject), 0 (don't care) or 1 (accept) as in the .mona format.
+        if (roots[state] >= header.num_of_nodes || finals[state] < -1 || finals[state] > 1) {
+            dfaFree(loaded);
+            throw std::runtime_error(invalid_file_msg);
+        }
+        loaded->q[state] = mona_nodes[roots[state]];
+        loaded->f[state] = finals[state];
+    }
+    loaded->s = static_cast<int>(header.initial_state);
+
+    // Restore the alphabet encoding.
+    AlphabetEncoding encoding(header.num_of_alphabet_vars);
+    const char* entry_ptr = file.bytes() + header.alphabet_offset;
+    for (uint64_t i = 0; i < header.alphabet_size; ++i) {
+        BinaryAlphabetEntry entry;
+        std::memcpy(&entry, entry_ptr, sizeof(BinaryAlphabetEntry));
+        entry_ptr += sizeof(BinaryAlphabetEntry);
+        uint64_t first_word = 0;
+        if (code_words > 0) {
+            std::memcpy(&first_word, entry_ptr, sizeof(uint64_t));
+        }
+        entry_ptr += code_words * sizeof(uint64_t);
+
+        const Code code = (code_words > 0) ? first_word >> (64 - header.num_of_alphabet_vars) : 0;
+        const Symbol symbol = static_cast<Symbol>(entry.symbol);
+        if (encoding.decode(code) != AlphabetEncoding::NO_SYMBOL || encoding.encode(symbol) != AlphabetEncoding::NO_CODE) {
+            dfaFree(loaded);
+            throw std::runtime_error(invalid_file_msg);
+        }
+        encoding.add(symbol, code);
+    }
+
+    if (nfa_impl != nullptr) {
+        dfaFree(nfa_impl);
+    }
+    nfa_impl = loaded;
+    num_of_vars = header.num_of_vars;
+    num_of_alphabet_vars = header.num_of_alphabet_vars;
+    num_of_nondet_vars = header.num_of_nondet_vars;
+    nondeterminism_level = header.nondeterminism_level;
+    alphabet_encoding = std::make_shared<const AlphabetEncoding>(std::move(encoding));
+
+    return *this;
+}
+
+} // namespace mamonata::mona::nfa
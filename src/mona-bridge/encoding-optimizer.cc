@@ -0,0 +1,263 @@
+#include "mona-bridge/nfa.hh"
+#include "mona-bridge/conversion-cache.hh"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+
+// Search for alphabet encodings with small MTROBDDs.
+//
+// A candidate encoding is represented by its code table, i.e., the symbol of each
+// of the 2^num_of_alphabet_vars codes (NO_SYMBOL for unused codes). Reordering the
+// alphabet variables is the same as permuting the bits of all codes, so variable
+// sifting and code permutations both operate on code tables. Nondeterminism
+// variables are not part of the code and always stay below the alphabet variables.
+
+namespace {
+
+using mamonata::mona::nfa::AlphabetEncoding;
+using mamonata::mona::nfa::Code;
+using mamonata::mona::nfa::Symbol;
+
+using CodeTable = std::vector<Symbol>;
+
+/**
+ * @brief Creates the encoding described by a code table.
+ *
+ * @param table Symbol of each code.
+ * @param num_of_vars Number of variables of a code.
+ *
+ * @return Alphabet encoding.
+ */
+AlphabetEncoding to_encoding(const CodeTable& table, const size_t num_of_vars) {
+    AlphabetEncoding encoding(num_of_vars);
+    for (Code code = 0; code < table.size(); ++code) {
+        if (table[code] != AlphabetEncoding::NO_SYMBOL) {
+            encoding.add(table[code], code);
+        }
+    }
+    return encoding;
+}
+
+/**
+ * @brief Reorders the variables of all codes of a code table.
+ *
+ * @param table Symbol of each code.
+ * @param num_of_vars Number of variables of a code.
+ * @param order Variable at each position of the new order.
+ *
+ * @return Code table under the new variable order.
+ */
+CodeTable permute_variables(const CodeTable& table, const size_t num_of_vars, const std::vector<size_t>& order) {
+    CodeTable result(table.size(), AlphabetEncoding::NO_SYMBOL);
+    for (Code code = 0; code < table.size(); ++code) {
+        Code new_code = 0;
+        for (size_t position = 0; position < num_of_vars; ++position) {
+            new_code = (new_code << 1) | ((code >> (num_of_vars - 1 - order[position])) & 1);
+        }
+        result[new_code] = table[code];
+    }
+    return result;
+}
+
+/**
+ * @brief Assigns consecutive codes to symbols with the same targets in all states of all operands.
+ *
+ * Such symbols are interchangeable in every MTROBDD, so a group of them aligned to a cube
+ * is represented without any test of the variables inside the cube. Larger groups come first,
+ * which keeps groups with a power-of-two size aligned.
+ *
+ * @param operands Automata to be encoded.
+ * @param alphabet Symbols to be encoded.
+ * @param num_of_codes Number of codes.
+ *
+ * @return Code table grouping the symbols.
+ */
+CodeTable group_by_signature(const std::vector<const mamonata::mata::nfa::Nfa*>& operands,
+                             const std::vector<Symbol>& alphabet, const size_t num_of_codes) {
+    constexpr uint64_t SIGNATURE_SEED = 0x5349474E;
+    std::unordered_map<Symbol, mamonata::mona::nfa::ConversionCache::Fingerprint> signatures;
+    signatures.reserve(alphabet.size());
+    for (const Symbol symbol : alphabet) {
+        signatures.emplace(symbol, mamonata::mona::nfa::ConversionCache::Fingerprint(SIGNATURE_SEED));
+    }
+    for (size_t operand = 0; operand < operands.size(); ++operand) {
+        const mamonata::mata::nfa::Nfa& nfa = *operands[operand];
+        for (mamonata::mata::nfa::State state = 0; state < nfa.num_of_states(); ++state) {
+            for (const auto& symbol_post : nfa.get_state_post(state)) {
+                auto it = signatures.find(symbol_post.symbol);
+                if (it == signatures.end()) {
+                    continue;
+                }
+                it->second.add(operand);
+                it->second.add(state);
+                it->second.add(symbol_post.targets.size());
+                for (const auto target : symbol_post.targets) {
+                    it->second.add(target);
+                }
+            }
+        }
+    }
+
+    // Groups in the order of their first symbol in the alphabet.
+    std::unordered_map<uint64_t, size_t> group_of_signature;
+    std::vector<std::vector<Symbol>> groups;
+    for (const Symbol symbol : alphabet) {
+        const uint64_t signature = signatures.at(symbol).get_key().first;
+        auto [it, inserted] = group_of_signature.emplace(signature, groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(symbol);
+    }
+    std::stable_sort(groups.begin(), groups.end(), [](const std::vector<Symbol>& lhs, const std::vector<Symbol>& rhs) {
+        return lhs.size() > rhs.size();
+    });
+
+    CodeTable table(num_of_codes, AlphabetEncoding::NO_SYMBOL);
+    Code code = 0;
+    for (const std::vector<Symbol>& group : groups) {
+        for (const Symbol symbol : group) {
+            table[code++] = symbol;
+        }
+    }
+    return table;
+}
+
+} // namespace
+
+namespace mamonata::mona::nfa {
+
+AlphabetEncodingPtr Nfa::optimize_alphabet_encoding(const std::vector<const mamonata::mata::nfa::Nfa*>& operands,
+                                                    const std::optional<MataSymbolVector>& alphabet,
+                                                    const EncodingOptimizerOptions& options) {
+    // Collect the alphabet in its given order, or the sorted symbols used by any operand.
+    std::vector<Symbol> symbols;
+    if (alphabet.has_value()) {
+        symbols.assign(alphabet->begin(), alphabet->end());
+    } else {
+        for (const mamonata::mata::nfa::Nfa* operand : operands) {
+            for (const auto symbol : operand->get_used_symbols()) {
+                symbols.push_back(symbol);
+            }
+        }
+        std::sort(symbols.begin(), symbols.end());
+        symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    }
+    const size_t num_of_alphabet_vars = (symbols.size() <= 1) ? 0
+        : static_cast<size_t>(std::ceil(std::log2(static_cast<double>(symbols.size()))));
+    if (num_of_alphabet_vars == 0 || operands.empty()) {
+        return std::make_shared<const AlphabetEncoding>(symbols, num_of_alphabet_vars);
+    }
+    const size_t num_of_codes = size_t{1} << num_of_alphabet_vars;
+
+    // Convert the operands the way from_mata does: with a single initial state.
+    std::deque<mamonata::mata::nfa::Nfa> unified_operands;
+    std::vector<const mamonata::mata::nfa::Nfa*> prepared_operands;
+    std::vector<size_t> operand_nondet_vars;
+    for (const mamonata::mata::nfa::Nfa* operand : operands) {
+        if (operand->num_of_initial_states() > 1) {
+            unified_operands.emplace_back(*operand);
+            unified_operands.back().unify_initial_states();
+            operand = &unified_operands.back();
+        }
+        prepared_operands.push_back(operand);
+        operand_nondet_vars.push_back(get_num_of_nondet_vars(operand->get_nondeterminism_level()));
+    }
+
+    // Total number of MTROBDD nodes of all operands under the encoding described by the table.
+    size_t num_of_evaluations = 0;
+    auto evaluate = [&](const CodeTable& table) -> size_t {
+        ++num_of_evaluations;
+        const AlphabetEncoding encoding = to_encoding(table, num_of_alphabet_vars);
+        size_t num_of_nodes = 0;
+        for (size_t operand = 0; operand < prepared_operands.size(); ++operand) {
+            mamonata::mtrobdd::ArenaMtRobdd manager(num_of_alphabet_vars + operand_nondet_vars[operand]);
+            build_state_mtrobdds(*prepared_operands[operand], encoding, operand_nondet_vars[operand], manager,
+                                 0, prepared_operands[operand]->num_of_states());
+            num_of_nodes += manager.get_num_of_nodes();
+        }
+        return num_of_nodes;
+    };
+    auto has_budget = [&]() {
+        return num_of_evaluations < options.max_evaluations;
+    };
+
+    // Start from the given order of symbols or from the grouping, whichever is smaller.
+    CodeTable best_table(num_of_codes, AlphabetEncoding::NO_SYMBOL);
+    std::copy(symbols.begin(), symbols.end(), best_table.begin());
+    size_t best_cost = evaluate(best_table);
+    if (options.group_by_signature && has_budget()) {
+        CodeTable grouped_table = group_by_signature(prepared_operands, symbols, num_of_codes);
+        const size_t grouped_cost = evaluate(grouped_table);
+        if (grouped_cost < best_cost) {
+            best_table = std::move(grouped_table);
+            best_cost = grouped_cost;
+        }
+    }
+
+    for (size_t pass = 0; pass < options.max_passes && has_budget(); ++pass) {
+        const size_t pass_cost = best_cost;
+
+        // Sift each alphabet variable through all positions of the order and keep the best one.
+        if (options.sift_variables) {
+            for (size_t var = 0; var < num_of_alphabet_vars && has_budget(); ++var) {
+                CodeTable sifted_table;
+                size_t sifted_cost = best_cost;
+                for (size_t position = 0; position < num_of_alphabet_vars && has_budget(); ++position) {
+                    if (position == var) {
+                        continue;
+                    }
+                    std::vector<size_t> order(num_of_alphabet_vars);
+                    std::iota(order.begin(), order.end(), size_t{0});
+                    order.erase(order.begin() + static_cast<std::ptrdiff_t>(var));
+                    order.insert(order.begin() + static_cast<std::ptrdiff_t>(position), var);
+                    CodeTable table = permute_variables(best_table, num_of_alphabet_vars, order);
+                    const size_t cost = evaluate(table);
+                    if (cost < sifted_cost) {
+                        sifted_table = std::move(table);
+                        sifted_cost = cost;
+                    }
+                }
+                if (sifted_cost < best_cost) {
+                    best_table = std::move(sifted_table);
+                    best_cost = sifted_cost;
+                }
+            }
+        }
+
+        // Try all permutations of each window of consecutive codes.
+        const size_t window_size = std::min(options.window_size, num_of_codes);
+        if (window_size > 1) {
+            for (size_t begin = 0; begin + window_size <= num_of_codes && has_budget(); ++begin) {
+                const auto window_begin = best_table.begin() + static_cast<std::ptrdiff_t>(begin);
+                const auto window_end = window_begin + static_cast<std::ptrdiff_t>(window_size);
+                if (std::all_of(window_begin, window_end, [](const Symbol symbol) { return symbol == AlphabetEncoding::NO_SYMBOL; })) {
+                    continue;
+                }
+                std::vector<size_t> permutation(window_size);
+                std::iota(permutation.begin(), permutation.end(), size_t{0});
+                const CodeTable window(window_begin, window_end);
+                CodeTable table = best_table;
+                while (std::next_permutation(permutation.begin(), permutation.end()) && has_budget()) {
+                    for (size_t i = 0; i < window_size; ++i) {
+                        table[begin + i] = window[permutation[i]];
+                    }
+                    const size_t cost = evaluate(table);
+                    if (cost < best_cost) {
+                        best_table = table;
+                        best_cost = cost;
+                    }
+                }
+            }
+        }
+
+        if (best_cost >= pass_cost) {
+            break;
+        }
+    }
+
+    return std::make_shared<const AlphabetEncoding>(to_encoding(best_table, num_of_alphabet_vars));
+}
+
+} // namespace mamonata::mona::nfa
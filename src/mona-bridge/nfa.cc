@@ -1,4 +1,13 @@
 #include "mona-bridge/nfa.hh"
+#include "mona-bridge/conversion-cache.hh"
+#include "parallel.hh"
+
+#include <deque>
+#include <iterator>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 // In order to mitigate copy/move overhead, each function
 // returning a new Nfa instance uses a temporary variable
@@ -12,50 +21,1206 @@
 
 namespace {
 
+// Seeds distinguishing fingerprints of Mata and MONA automata in the conversion cache.
+constexpr uint64_t MATA_FINGERPRINT_SEED = 0x4D415441;
+constexpr uint64_t MONA_FINGERPRINT_SEED = 0x4D4F4E41;
+// Estimated memory of a MONA BDD node including its share of the manager's hash table.
+constexpr size_t MONA_BYTES_PER_NODE = 32;
+
+/**
+ * @brief Computes the structural fingerprint of a Mata NFA for the conversion cache.
+ *
+ * @param nfa Mata NFA to be converted.
+ * @param encoding Alphabet encoding used by the conversion.
+ *
+ * @return Fingerprint of the NFA and the alphabet encoding.
+ */
+mamonata::mona::nfa::ConversionCache::Key get_mata_fingerprint(const mamonata::mata::nfa::Nfa& nfa,
+                                                               const mamonata::mona::nfa::AlphabetEncoding& encoding) {
+    mamonata::mona::nfa::ConversionCache::Fingerprint fingerprint(MATA_FINGERPRINT_SEED);
+    fingerprint.add(encoding.get_num_of_vars());
+    fingerprint.add(encoding.size());
+    encoding.for_each([&](const mamonata::mona::nfa::Symbol symbol, const mamonata::mona::nfa::Code code) {
+        fingerprint.add(symbol);
+        fingerprint.add(code);
+    });
+
+    const size_t num_of_states = nfa.num_of_states();
+    fingerprint.add(num_of_states);
+    for (const auto state : nfa.view_initial_states()) {
+        fingerprint.add(state);
+    }
+    fingerprint.add(num_of_states);
+    for (const auto state : nfa.view_final_states()) {
+        fingerprint.add(state);
+    }
+    for (mamonata::mata::nfa::State src = 0; src < num_of_states; ++src) {
+        const auto& state_post = nfa.get_state_post(src);
+        fingerprint.add(state_post.size());
+        for (const auto& symbol_post : state_post) {
+            fingerprint.add(symbol_post.symbol);
+            fingerprint.add(symbol_post.targets.size());
+            for (const auto target : symbol_post.targets) {
+                fingerprint.add(target);
+            }
+        }
+    }
+
+    return fingerprint.get_key();
+}
+
+/**
+ * @brief Computes the structural fingerprint of a MONA DFA for the conversion cache.
+ *
+ * The BDD nodes are walked directly in MONA's manager, so a cache hit does not
+ * require exporting the DFA into an MTROBDD first.
+ *
+ * @param dfa MONA DFA to be converted.
+ * @param num_of_vars Number of variables of the DFA.
+ * @param num_of_nondet_vars Number of nondeterminism variables of the DFA.
+ * @param encoding Alphabet encoding used by the conversion.
+ *
+ * @return Fingerprint of the DFA and the alphabet encoding.
+ */
+mamonata::mona::nfa::ConversionCache::Key get_mona_fingerprint(const DFA* dfa, const size_t num_of_vars,
+                                                               const size_t num_of_nondet_vars,
+                                                               const mamonata::mona::nfa::AlphabetEncoding& encoding) {
+    mamonata::mona::nfa::ConversionCache::Fingerprint fingerprint(MONA_FINGERPRINT_SEED);
+    // The split into alphabet and nondeterminism variables decides how the paths are read.
+    fingerprint.add(num_of_vars);
+    fingerprint.add(num_of_nondet_vars);
+    fingerprint.add(encoding.get_num_of_vars());
+    fingerprint.add(static_cast<uint64_t>(dfa->ns));
+    fingerprint.add(static_cast<uint64_t>(dfa->s));
+
+    // Nodes are numbered in the order of a depth-first traversal from the roots, which depends
+    // only on the structure of the BDDs. A node met again contributes its number only.
+    constexpr uint64_t LEAF_TAG = uint64_t{1} << 62;
+    constexpr uint64_t VISITED_TAG = uint64_t{1} << 63;
+    std::unordered_map<bdd_ptr, uint64_t> node_numbers;
+    std::vector<bdd_ptr> worklist;
+    for (int state = 0; state < dfa->ns; ++state) {
+        fingerprint.add(static_cast<uint64_t>(static_cast<int64_t>(dfa->f[state])));
+        worklist.push_back(dfa->q[state]);
+        while (!worklist.empty()) {
+            const bdd_ptr node = worklist.back();
+            worklist.pop_back();
+            const auto [it, inserted] = node_numbers.try_emplace(node, node_numbers.size());
+            if (!inserted) {
+                fingerprint.add(VISITED_TAG | it->second);
+            } else if (bdd_is_leaf(dfa->bddm, node)) {
+                fingerprint.add(LEAF_TAG | bdd_leaf_value(dfa->bddm, node));
+            } else {
+                fingerprint.add(bdd_ifindex(dfa->bddm, node));
+                worklist.push_back(bdd_then(dfa->bddm, node));
+                worklist.push_back(bdd_else(dfa->bddm, node));
+            }
+        }
+    }
+    fingerprint.add(node_numbers.size());
+    fingerprint.add(encoding.size());
+    encoding.for_each([&](const mamonata::mona::nfa::Symbol symbol, const mamonata::mona::nfa::Code code) {
+        fingerprint.add(symbol);
+        fingerprint.add(code);
+    });
+
+    return fingerprint.get_key();
+}
+
+// Implements a hash function for vectors of integral values.
+struct VectorHash {
+    template<typename T>
+    size_t operator()(const std::vector<T>& vec) const {
+        uint64_t hash = vec.size();
+        for (const T value : vec) {
+            hash ^= static_cast<uint64_t>(value) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+/**
+ * @brief Subset construction projecting out all nondeterminism variables at once.
+ *
+ * Nondeterminism variables are the last variables of the ordering, so every path of a state
+ * behaviour first decides the alphabet variables and then reaches a part of the BDD whose
+ * terminals are all nondeterministic successors for that symbol. The behaviour of a subset
+ * of states is built by a simultaneous traversal of the member behaviours over the alphabet
+ * variables only; the terminal of each path is the subset of all reachable successors.
+ *
+ * @param dfa MONA DFA with nondeterminism variables.
+ * @param num_of_vars Total number of variables of the DFA.
+ * @param num_of_alphabet_vars Number of alphabet variables.
+ *
+ * @return Newly allocated MONA DFA over the alphabet variables only.
+ */
+DFA* project_nondeterminism(DFA* dfa, const size_t num_of_vars, const size_t num_of_alphabet_vars) {
+    using namespace mamonata::mtrobdd;
+    using StateSet = std::vector<NodeValue>;
+
+    const size_t num_of_states = static_cast<size_t>(dfa->ns);
+    const VarIndex alphabet_end = static_cast<VarIndex>(num_of_alphabet_vars);
+    ArenaMtRobdd input(num_of_vars, dfa->bddm, dfa->q, num_of_states);
+    ArenaMtRobdd output(num_of_alphabet_vars);
+
+    // Rejecting states looping to themselves on every symbol do not change
+    // acceptance of a subset and are dropped from nontrivial subsets.
+    std::vector<bool> is_trap(num_of_states, false);
+    for (size_t state = 0; state < num_of_states; ++state) {
+        const NodeId root = input.get_root_node(state);
+        is_trap[state] = dfa->f[state] != 1 && input.is_terminal(root) && input.get_value(root) == state;
+    }
+
+    // Successors reachable from a node below the alphabet variables.
+    std::unordered_map<NodeId, StateSet> successors_memo;
+    std::function<const StateSet&(NodeId)> get_successors = [&](const NodeId node) -> const StateSet& {
+        auto it = successors_memo.find(node);
+        if (it != successors_memo.end()) {
+            return it->second;
+        }
+        StateSet successors;
+        if (input.is_terminal(node)) {
+            successors.push_back(input.get_value(node));
+        } else {
+            const StateSet& low_successors = get_successors(input.get_low(node));
+            const StateSet& high_successors = get_successors(input.get_high(node));
+            std::set_union(low_successors.begin(), low_successors.end(),
+                           high_successors.begin(), high_successors.end(),
+                           std::back_inserter(successors));
+        }
+        return successors_memo.emplace(node, std::move(successors)).first->second;
+    };
+
+    // Subsets discovered so far and those waiting for their behaviour.
+    std::unordered_map<StateSet, NodeValue, VectorHash> subset_ids;
+    std::vector<StateSet> subsets;
+    auto get_subset_id = [&](StateSet subset) -> NodeValue {
+        if (subset.size() > 1) {
+            StateSet nontrap;
+            std::copy_if(subset.begin(), subset.end(), std::back_inserter(nontrap),
+                         [&](const NodeValue state) { return !is_trap[state]; });
+            if (!nontrap.empty()) {
+                subset = std::move(nontrap);
+            }
+        }
+        auto [it, inserted] = subset_ids.emplace(subset, subsets.size());
+        if (inserted) {
+            subsets.push_back(std::move(subset));
+        }
+        return it->second;
+    };
+
+    // Behaviour of a set of input nodes over the alphabet variables.
+    std::unordered_map<std::vector<NodeId>, NodeId, VectorHash> behaviour_memo;
+    std::function<NodeId(std::vector<NodeId>)> build_behaviour = [&](std::vector<NodeId> nodes) -> NodeId {
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        auto it = behaviour_memo.find(nodes);
+        if (it != behaviour_memo.end()) {
+            return it->second;
+        }
+
+        // Branch on the topmost alphabet variable tested by any of the nodes.
+        VarIndex level = alphabet_end;
+        for (const NodeId node : nodes) {
+            if (!input.is_terminal(node)) {
+                level = std::min(level, input.get_var_index(node));
+            }
+        }
+
+        NodeId result;
+        if (level == alphabet_end) {
+            // All alphabet variables are decided; collect all successors.
+            StateSet successors;
+            for (const NodeId node : nodes) {
+                const StateSet& node_successors = get_successors(node);
+                successors.insert(successors.end(), node_successors.begin(), node_successors.end());
+            }
+            std::sort(successors.begin(), successors.end());
+            successors.erase(std::unique(successors.begin(), successors.end()), successors.end());
+            result = output.create_terminal_node(get_subset_id(std::move(successors)));
+        } else {
+            std::vector<NodeId> low_nodes;
+            std::vector<NodeId> high_nodes;
+            low_nodes.reserve(nodes.size());
+            high_nodes.reserve(nodes.size());
+            for (const NodeId node : nodes) {
+                const bool tests_level = !input.is_terminal(node) && input.get_var_index(node) == level;
+                low_nodes.push_back(tests_level ? input.get_low(node) : node);
+                high_nodes.push_back(tests_level ? input.get_high(node) : node);
+            }
+            const NodeId low_child = build_behaviour(std::move(low_nodes));
+            const NodeId high_child = build_behaviour(std::move(high_nodes));
+            result = (low_child == high_child) ? low_child : output.create_node(level, low_child, high_child);
+        }
+
+        behaviour_memo.emplace(std::move(nodes), result);
+        return result;
+    };
+
+    // Explore subsets reachable from the initial state.
+    get_subset_id({ static_cast<NodeValue>(dfa->s) });
+    std::vector<NodeId> subset_roots;
+    for (size_t i = 0; i < subsets.size(); ++i) {
+        std::vector<NodeId> member_roots;
+        member_roots.reserve(subsets[i].size());
+        for (const NodeValue state : subsets[i]) {
+            member_roots.push_back(input.get_root_node(state));
+        }
+        subset_roots.push_back(build_behaviour(std::move(member_roots)));
+    }
+    for (size_t i = 0; i < subsets.size(); ++i) {
+        output.promote_to_root(subset_roots[i], i);
+    }
+
+    // Construct the projected MONA DFA.
+    DFA* result = dfaMake(static_cast<int>(subsets.size()));
+    reserve_mona_nodes(result->bddm, output.get_num_of_nodes());
+    result->s = 0;
+    for (size_t i = 0; i < subsets.size(); ++i) {
+        const bool accepting = std::any_of(subsets[i].begin(), subsets[i].end(),
+                                           [&](const NodeValue state) { return dfa->f[state] == 1; });
+        result->f[i] = accepting ? 1 : -1;
+    }
+    output.to_mona(result->bddm, result->q);
+
+    return result;
+}
+
+// Sorted set of successor states.
+using SuccessorSet = std::vector<mamonata::mtrobdd::NodeValue>;
+
+/**
+ * @brief Behaviours of the states of a MONA DFA over the alphabet variables only.
+ *
+ * The terminal of a path is the id of the set of successors reached below it, i.e., over all codes
+ * of the nondeterminism variables, so the behaviour of a state of a DFA without nondeterminism
+ * variables is its transition function with singleton terminals.
+ */
+struct SuccessorBehaviours {
+    mamonata::mtrobdd::ArenaMtRobdd diagrams;
+    std::vector<mamonata::mtrobdd::NodeId> roots;    // Behaviour of every state.
+    std::vector<SuccessorSet> sets;                  // Successor sets indexed by their ids.
+    std::unordered_map<SuccessorSet, mamonata::mtrobdd::NodeValue, VectorHash> set_ids;
+
+    SuccessorBehaviours(DFA* dfa, const size_t num_of_vars, const size_t num_of_alphabet_vars) : diagrams(num_of_alphabet_vars) {
+        using namespace mamonata::mtrobdd;
+        const size_t num_of_states = static_cast<size_t>(dfa->ns);
+        const VarIndex alphabet_end = static_cast<VarIndex>(num_of_alphabet_vars);
+        ArenaMtRobdd input(num_of_vars, dfa->bddm, dfa->q, num_of_states);
+
+        // Successors reachable from a node below the alphabet variables.
+        std::unordered_map<NodeId, NodeValue> successors_memo;
+        std::function<NodeValue(NodeId)> get_successors = [&](const NodeId node) -> NodeValue {
+            auto it = successors_memo.find(node);
+            if (it != successors_memo.end()) {
+                return it->second;
+            }
+            SuccessorSet successors;
+            if (input.is_terminal(node)) {
+                successors.push_back(input.get_value(node));
+            } else {
+                const NodeValue low_successors = get_successors(input.get_low(node));
+                const NodeValue high_successors = get_successors(input.get_high(node));
+                std::set_union(sets[low_successors].begin(), sets[low_successors].end(),
+                               sets[high_successors].begin(), sets[high_successors].end(),
+                               std::back_inserter(successors));
+            }
+            const NodeValue id = get_set_id(std::move(successors));
+            successors_memo.emplace(node, id);
+            return id;
+        };
+
+        std::unordered_map<NodeId, NodeId> behaviour_memo;
+        std::function<NodeId(NodeId)> build_behaviour = [&](const NodeId node) -> NodeId {
+            auto it = behaviour_memo.find(node);
+            if (it != behaviour_memo.end()) {
+                return it->second;
+            }
+            NodeId result;
+            if (input.is_terminal(node) || input.get_var_index(node) >= alphabet_end) {
+                result = diagrams.create_terminal_node(get_successors(node));
+            } else {
+                const NodeId low_child = build_behaviour(input.get_low(node));
+                const NodeId high_child = build_behaviour(input.get_high(node));
+                result = (low_child == high_child) ? low_child : diagrams.create_node(input.get_var_index(node), low_child, high_child);
+            }
+            behaviour_memo.emplace(node, result);
+            return result;
+        };
+
+        roots.resize(num_of_states);
+        for (size_t state = 0; state < num_of_states; ++state) {
+            roots[state] = build_behaviour(input.get_root_node(state));
+        }
+    }
+
+    // Returns the id of a successor set, interning it on its first use.
+    mamonata::mtrobdd::NodeValue get_set_id(SuccessorSet set) {
+        auto [it, inserted] = set_ids.emplace(set, sets.size());
+        if (inserted) {
+            sets.push_back(std::move(set));
+        }
+        return it->second;
+    }
+};
+
+/**
+ * @brief Partitions the paths over the alphabet variables into atoms, the coarsest partition on which
+ * every behaviour is constant, and returns the successor set of every state on every atom.
+ *
+ * The atoms are built by refining a single atom by each distinct behaviour; they share the arena
+ * with the behaviours and their terminals are atom ids.
+ *
+ * @param behaviours Behaviours of the states.
+ * @param num_of_alphabet_vars Number of alphabet variables.
+ * @param[out] num_of_atoms Number of atoms.
+ *
+ * @return Ids of successor sets indexed by state * num_of_atoms + atom.
+ */
+std::vector<mamonata::mtrobdd::NodeValue> get_atom_successors(SuccessorBehaviours& behaviours, const size_t num_of_alphabet_vars,
+                                                              size_t& num_of_atoms) {
+    using namespace mamonata::mtrobdd;
+    ArenaMtRobdd& diagrams = behaviours.diagrams;
+
+    std::vector<NodeId> distinct_roots(behaviours.roots);
+    std::sort(distinct_roots.begin(), distinct_roots.end());
+    distinct_roots.erase(std::unique(distinct_roots.begin(), distinct_roots.end()), distinct_roots.end());
+    NodeId atom_root = diagrams.create_terminal_node(0);
+    for (const NodeId root : distinct_roots) {
+        std::unordered_map<uint64_t, NodeValue> refined_atoms;
+        ArenaMtRobdd::ApplyTable refine_table;
+        atom_root = diagrams.apply(atom_root, root, [&](const NodeValue atom, const NodeValue set) {
+            return refined_atoms.emplace((static_cast<uint64_t>(atom) << 32) | set, refined_atoms.size()).first->second;
+        }, refine_table);
+    }
+
+    // A cube of every atom; variables the path does not test stay -1 and follow the low branch.
+    std::vector<std::vector<int8_t>> atom_cubes;
+    std::vector<int8_t> cube(num_of_alphabet_vars, -1);
+    std::unordered_set<NodeId> visited;
+    auto visit = [&](auto& self, const NodeId node) -> void {
+        if (!visited.insert(node).second) {
+            return;
+        }
+        if (diagrams.is_terminal(node)) {
+            const NodeValue atom = diagrams.get_value(node);
+            if (atom >= atom_cubes.size()) {
+                atom_cubes.resize(atom + 1);
+            }
+            atom_cubes[atom] = cube;
+            return;
+        }
+        const VarIndex var_index = diagrams.get_var_index(node);
+        cube[var_index] = 0;
+        self(self, diagrams.get_low(node));
+        cube[var_index] = 1;
+        self(self, diagrams.get_high(node));
+        cube[var_index] = -1;
+    };
+    visit(visit, atom_root);
+    num_of_atoms = atom_cubes.size();
+
+    const size_t num_of_states = behaviours.roots.size();
+    std::vector<NodeValue> post(num_of_states * num_of_atoms);
+    for (size_t state = 0; state < num_of_states; ++state) {
+        for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+            NodeId node = behaviours.roots[state];
+            while (!diagrams.is_terminal(node)) {
+                node = (atom_cubes[atom][diagrams.get_var_index(node)] == 1) ? diagrams.get_high(node) : diagrams.get_low(node);
+            }
+            post[state * num_of_atoms + atom] = diagrams.get_value(node);
+        }
+    }
+    return post;
+}
+
+/**
+ * @brief Computes the maximal forward simulation over atoms by the worklist algorithm of
+ * Henzinger, Henzinger and Kopke.
+ *
+ * remove[a * n + v] holds states whose successors on a avoid all simulators of v, so they cannot
+ * simulate a predecessor of v on a. Only the pairs affected by a removal are revisited. The initial
+ * remove sets are computed when their entry is first taken, so at most one is held at a time.
+ * Behaviours are complete, so every state has successors on every atom.
+ *
+ * @param post Successor set ids indexed by state * num_of_atoms + atom (see get_atom_successors()).
+ * @param num_of_atoms Number of atoms.
+ * @param sets Successor sets indexed by their ids.
+ * @param dfa MONA DFA providing the final flags.
+ *
+ * @return Relation where the element p * n + q holds if q simulates p.
+ */
+std::vector<bool> compute_simulation(const std::vector<mamonata::mtrobdd::NodeValue>& post, const size_t num_of_atoms,
+                                     const std::vector<SuccessorSet>& sets, const DFA* dfa) {
+    using namespace mamonata::mtrobdd;
+    const size_t num_of_states = static_cast<size_t>(dfa->ns);
+
+    // Predecessors of every state as (atom, predecessor) sorted by atoms, in a single array.
+    std::vector<size_t> pre_begin(num_of_states + 1, 0);
+    for (const NodeValue set : post) {
+        for (const NodeValue successor : sets[set]) {
+            ++pre_begin[successor + 1];
+        }
+    }
+    std::partial_sum(pre_begin.begin(), pre_begin.end(), pre_begin.begin());
+    std::vector<std::pair<uint32_t, uint32_t>> pre(pre_begin.back());
+    {
+        std::vector<size_t> fill(pre_begin.begin(), pre_begin.end() - 1);
+        for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+            for (size_t state = 0; state < num_of_states; ++state) {
+                for (const NodeValue successor : sets[post[state * num_of_atoms + atom]]) {
+                    pre[fill[successor]++] = { static_cast<uint32_t>(atom), static_cast<uint32_t>(state) };
+                }
+            }
+        }
+    }
+
+    // Accepting states are simulated by accepting states only.
+    auto is_accepting = [&](const size_t state) { return dfa->f[state] == 1; };
+    std::vector<bool> simulated(num_of_states * num_of_states);
+    for (size_t p = 0; p < num_of_states; ++p) {
+        for (size_t q = 0; q < num_of_states; ++q) {
+            simulated[p * num_of_states + q] = !is_accepting(p) || is_accepting(q);
+        }
+    }
+    auto meets_simulators = [&](const NodeValue set, const size_t state) {
+        return std::any_of(sets[set].begin(), sets[set].end(),
+                           [&](const NodeValue successor) { return simulated[state * num_of_states + successor]; });
+    };
+
+    std::vector<std::vector<uint32_t>> remove(num_of_atoms * num_of_states);
+    std::vector<bool> is_initial(num_of_atoms * num_of_states, true);
+    std::vector<uint64_t> worklist(num_of_atoms * num_of_states);
+    std::iota(worklist.begin(), worklist.end(), uint64_t{0});
+    auto add_removal = [&](const size_t atom, const size_t state, const uint32_t removed) {
+        const uint64_t key = static_cast<uint64_t>(atom) * num_of_states + state;
+        if (remove[key].empty() && !is_initial[key]) {
+            worklist.push_back(key);
+        }
+        remove[key].push_back(removed);
+    };
+    while (!worklist.empty()) {
+        const uint64_t key = worklist.back();
+        worklist.pop_back();
+        std::vector<uint32_t> removed_states;
+        removed_states.swap(remove[key]);
+        const uint32_t atom = static_cast<uint32_t>(key / num_of_states);
+        const size_t v = static_cast<size_t>(key % num_of_states);
+        const auto predecessors = std::equal_range(pre.begin() + pre_begin[v], pre.begin() + pre_begin[v + 1],
+                                                   std::pair<uint32_t, uint32_t>(atom, 0),
+                                                   [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        if (is_initial[key]) {
+            // States removed meanwhile are found again here; removing them twice is harmless.
+            is_initial[key] = false;
+            for (size_t u = 0; u < num_of_states && predecessors.first != predecessors.second; ++u) {
+                if (!meets_simulators(post[u * num_of_atoms + atom], v)) {
+                    removed_states.push_back(static_cast<uint32_t>(u));
+                }
+            }
+        }
+        for (auto predecessor = predecessors.first; predecessor != predecessors.second; ++predecessor) {
+            const size_t u = predecessor->second;
+            for (const uint32_t w : removed_states) {
+                if (!simulated[u * num_of_states + w]) {
+                    continue;
+                }
+                simulated[u * num_of_states + w] = false;
+                // Predecessors of w may have lost their last successor simulating u.
+                for (size_t i = pre_begin[w]; i < pre_begin[w + 1]; ++i) {
+                    const auto [pre_atom, pre_state] = pre[i];
+                    if (!meets_simulators(post[pre_state * num_of_atoms + pre_atom], u)) {
+                        add_removal(pre_atom, u, pre_state);
+                    }
+                }
+            }
+        }
+    }
+    return simulated;
+}
+
+/**
+ * @brief Builds a MONA DFA with nondeterminism variables from behaviours over the alphabet variables.
+ *
+ * Every terminal of a behaviour is replaced by a subtree over the nondeterminism variables choosing
+ * one of the successors of the terminal; codes past the last successor repeat it.
+ *
+ * @param diagrams MTROBDD holding the behaviours.
+ * @param roots Behaviour of every state of the result.
+ * @param num_of_alphabet_vars Number of alphabet variables.
+ * @param get_successors Callable returning the nonempty successors of a terminal value as std::vector<NodeValue>.
+ * @param finals Final flags of the states of the result.
+ * @param initial_state Initial state of the result.
+ * @param[out] nondeterminism_level Maximal number of successors of a terminal.
+ *
+ * @return Newly allocated MONA DFA over the alphabet variables followed by
+ *         Nfa::get_num_of_nondet_vars(nondeterminism_level) nondeterminism variables.
+ */
+template<typename GetSuccessors>
+DFA* encode_nondeterminism(const mamonata::mtrobdd::ArenaMtRobdd& diagrams, const std::vector<mamonata::mtrobdd::NodeId>& roots,
+                           const size_t num_of_alphabet_vars, GetSuccessors&& get_successors, const std::vector<int>& finals,
+                           const size_t initial_state, size_t& nondeterminism_level) {
+    using namespace mamonata::mtrobdd;
+    const VarIndex alphabet_end = static_cast<VarIndex>(num_of_alphabet_vars);
+
+    std::unordered_map<NodeValue, std::vector<NodeValue>> successors;
+    std::unordered_set<NodeId> visited;
+    nondeterminism_level = 1;
+    std::function<void(NodeId)> collect_successors = [&](const NodeId node) {
+        if (!visited.insert(node).second) {
+            return;
+        }
+        if (diagrams.is_terminal(node)) {
+            const NodeValue value = diagrams.get_value(node);
+            auto it = successors.emplace(value, get_successors(value)).first;
+            assert(!it->second.empty());
+            nondeterminism_level = std::max(nondeterminism_level, it->second.size());
+            return;
+        }
+        collect_successors(diagrams.get_low(node));
+        collect_successors(diagrams.get_high(node));
+    };
+    for (const NodeId root : roots) {
+        collect_successors(root);
+    }
+
+    const VarIndex output_end = alphabet_end + static_cast<VarIndex>(mamonata::mona::nfa::Nfa::get_num_of_nondet_vars(nondeterminism_level));
+    ArenaMtRobdd output(static_cast<size_t>(output_end));
+    std::function<NodeId(const std::vector<NodeValue>&, size_t, VarIndex)> build_choice =
+        [&](const std::vector<NodeValue>& targets, const size_t first_code, const VarIndex var_index) -> NodeId {
+        if (var_index == output_end) {
+            return output.create_terminal_node(targets[std::min(first_code, targets.size() - 1)]);
+        }
+        const size_t half = size_t{1} << (output_end - var_index - 1);
+        const NodeId low_child = build_choice(targets, first_code, var_index + 1);
+        const NodeId high_child = (first_code + half < targets.size()) ? build_choice(targets, first_code + half, var_index + 1) : low_child;
+        return (low_child == high_child) ? low_child : output.create_node(var_index, low_child, high_child);
+    };
+    std::unordered_map<NodeId, NodeId> output_memo;
+    std::function<NodeId(NodeId)> build_output = [&](const NodeId node) -> NodeId {
+        auto it = output_memo.find(node);
+        if (it != output_memo.end()) {
+            return it->second;
+        }
+        NodeId result;
+        if (diagrams.is_terminal(node)) {
+            result = build_choice(successors.at(diagrams.get_value(node)), 0, alphabet_end);
+        } else {
+            const NodeId low_child = build_output(diagrams.get_low(node));
+            const NodeId high_child = build_output(diagrams.get_high(node));
+            result = (low_child == high_child) ? low_child : output.create_node(diagrams.get_var_index(node), low_child, high_child);
+        }
+        output_memo.emplace(node, result);
+        return result;
+    };
+    for (size_t state = 0; state < roots.size(); ++state) {
+        output.promote_to_root(build_output(roots[state]), state);
+    }
+
+    DFA* result = dfaMake(static_cast<int>(roots.size()));
+    reserve_mona_nodes(result->bddm, output.get_num_of_nodes());
+    result->s = static_cast<int>(initial_state);
+    for (size_t state = 0; state < roots.size(); ++state) {
+        result->f[state] = finals[state];
+    }
+    output.to_mona(result->bddm, result->q);
+
+    return result;
+}
+
+/**
+ * @brief Quotients a DFA with nondeterminism variables by its maximal forward simulation.
+ *
+ * The behaviour of every state over the alphabet variables has one terminal per set of successors
+ * of a path (see SuccessorBehaviours). The simulation is computed over the atoms of the paths
+ * (see get_atom_successors() and compute_simulation()), so the refinement works on cubes of the
+ * diagrams rather than on symbols. Mutually similar states are merged and successors strictly
+ * simulated by another successor on the same path are dropped, which lowers the level of
+ * nondeterminism before a subset construction.
+ *
+ * @param dfa MONA DFA whose last variables are nondeterminism variables.
+ * @param num_of_vars Total number of variables of the DFA.
+ * @param num_of_alphabet_vars Number of alphabet variables.
+ * @param[out] nondeterminism_level Maximal number of successors of a state on a symbol in the result.
+ *
+ * @return Newly allocated MONA DFA over the alphabet variables followed by
+ *         Nfa::get_num_of_nondet_vars(nondeterminism_level) nondeterminism variables.
+ */
+DFA* reduce_by_simulation(DFA* dfa, const size_t num_of_vars, const size_t num_of_alphabet_vars, size_t& nondeterminism_level) {
+    using namespace mamonata::mtrobdd;
+
+    const size_t num_of_states = static_cast<size_t>(dfa->ns);
+    SuccessorBehaviours behaviours(dfa, num_of_vars, num_of_alphabet_vars);
+    size_t num_of_atoms = 0;
+    const std::vector<NodeValue> post = get_atom_successors(behaviours, num_of_alphabet_vars, num_of_atoms);
+    const std::vector<bool> simulated = compute_simulation(post, num_of_atoms, behaviours.sets, dfa);
+
+    // Classes of mutually similar states, numbered by their first state.
+    constexpr NodeValue NO_CLASS = std::numeric_limits<NodeValue>::max();
+    std::vector<NodeValue> class_of(num_of_states, NO_CLASS);
+    std::vector<size_t> representatives;
+    for (size_t p = 0; p < num_of_states; ++p) {
+        if (class_of[p] != NO_CLASS) {
+            continue;
+        }
+        class_of[p] = representatives.size();
+        for (size_t q = p + 1; q < num_of_states; ++q) {
+            if (class_of[q] == NO_CLASS && simulated[p * num_of_states + q] && simulated[q * num_of_states + p]) {
+                class_of[q] = representatives.size();
+            }
+        }
+        representatives.push_back(p);
+    }
+    const size_t num_of_classes = representatives.size();
+
+    // Behaviour of a class is the union of the behaviours of its members.
+    ArenaMtRobdd::ApplyTable union_table;
+    auto unite = [&](const NodeValue lhs, const NodeValue rhs) -> NodeValue {
+        const SuccessorSet& lhs_set = behaviours.sets[lhs];
+        const SuccessorSet& rhs_set = behaviours.sets[rhs];
+        SuccessorSet successors;
+        std::set_union(lhs_set.begin(), lhs_set.end(), rhs_set.begin(), rhs_set.end(), std::back_inserter(successors));
+        return behaviours.get_set_id(std::move(successors));
+    };
+    std::vector<NodeId> class_roots(num_of_classes, NULL_NODE);
+    for (size_t state = 0; state < num_of_states; ++state) {
+        NodeId& class_root = class_roots[class_of[state]];
+        class_root = (class_root == NULL_NODE) ? behaviours.roots[state]
+                                               : behaviours.diagrams.apply(class_root, behaviours.roots[state], unite, union_table);
+    }
+
+    // Successor classes of a successor set without the classes strictly simulated by another one.
+    auto get_successor_classes = [&](const NodeValue set) {
+        std::vector<NodeValue> classes;
+        for (const NodeValue state : behaviours.sets[set]) {
+            classes.push_back(class_of[state]);
+        }
+        std::sort(classes.begin(), classes.end());
+        classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+        std::vector<NodeValue> maximal;
+        for (const NodeValue lhs : classes) {
+            const bool is_little_brother = std::any_of(classes.begin(), classes.end(), [&](const NodeValue rhs) {
+                return lhs != rhs && simulated[representatives[lhs] * num_of_states + representatives[rhs]];
+            });
+            if (!is_little_brother) {
+                maximal.push_back(lhs);
+            }
+        }
+        return maximal;
+    };
+
+    // Mutually similar states agree on acceptance.
+    std::vector<int> finals(num_of_classes);
+    for (size_t i = 0; i < num_of_classes; ++i) {
+        finals[i] = (dfa->f[representatives[i]] == 1) ? 1 : -1;
+    }
+    return encode_nondeterminism(behaviours.diagrams, class_roots, num_of_alphabet_vars, get_successor_classes, finals,
+                                 class_of[static_cast<size_t>(dfa->s)], nondeterminism_level);
+}
+
+/**
+ * @brief Reduces a minimal DFA to its canonical residual automaton.
+ *
+ * The states of a minimal DFA are the residual languages, and their inclusion is the simulation of
+ * the DFA (see compute_simulation()). A state is covered if its language is the union of the languages
+ * strictly included in it, which is checked by exploring the state against the subsets of the
+ * included states over the atoms. Covered states are dropped and a transition to a covered state is
+ * replaced by transitions to the maximal prime states included in it. The initial state and the state
+ * with the empty language are kept even if covered, since MONA has a single initial state and every
+ * path needs a successor.
+ *
+ * @param dfa Minimal MONA DFA without nondeterminism variables.
+ * @param num_of_alphabet_vars Number of alphabet variables.
+ * @param[out] nondeterminism_level Maximal number of successors of a state on a symbol in the result.
+ *
+ * @return Newly allocated MONA DFA over the alphabet variables followed by
+ *         Nfa::get_num_of_nondet_vars(nondeterminism_level) nondeterminism variables.
+ */
+DFA* reduce_to_residuals(DFA* dfa, const size_t num_of_alphabet_vars, size_t& nondeterminism_level) {
+    using namespace mamonata::mtrobdd;
+
+    const size_t num_of_states = static_cast<size_t>(dfa->ns);
+    SuccessorBehaviours behaviours(dfa, num_of_alphabet_vars, num_of_alphabet_vars);
+    size_t num_of_atoms = 0;
+    const std::vector<NodeValue> post = get_atom_successors(behaviours, num_of_alphabet_vars, num_of_atoms);
+    const std::vector<bool> simulated = compute_simulation(post, num_of_atoms, behaviours.sets, dfa);
+    // The successor of a state on an atom; set ids of a DFA stand for singletons.
+    auto get_successor = [&](const size_t state, const size_t atom) {
+        return behaviours.sets[post[state * num_of_atoms + atom]].front();
+    };
+    auto is_included = [&](const size_t lhs, const size_t rhs) { return simulated[lhs * num_of_states + rhs]; };
+    auto is_accepting = [&](const size_t state) { return dfa->f[state] == 1; };
+
+    std::vector<bool> is_empty(num_of_states);
+    for (size_t state = 0; state < num_of_states; ++state) {
+        bool empty = true;
+        for (size_t other = 0; other < num_of_states && empty; ++other) {
+            empty = is_included(state, other);
+        }
+        is_empty[state] = empty;
+    }
+
+    // Checks if the language of a state is the union of the languages strictly included in it.
+    auto is_covered = [&](const size_t state) {
+        if (is_empty[state]) {
+            return true;
+        }
+        SuccessorSet included;
+        for (size_t other = 0; other < num_of_states; ++other) {
+            if (is_included(other, state) && !is_included(state, other)) {
+                included.push_back(static_cast<NodeValue>(other));
+            }
+        }
+        std::unordered_set<SuccessorSet, VectorHash> visited;
+        std::vector<std::pair<NodeValue, SuccessorSet>> worklist{ { static_cast<NodeValue>(state), std::move(included) } };
+        while (!worklist.empty()) {
+            auto [current, cover] = std::move(worklist.back());
+            worklist.pop_back();
+            // A member of the cover including the current language covers all its continuations.
+            if (is_empty[current] || std::any_of(cover.begin(), cover.end(), [&](const NodeValue member) { return is_included(current, member); })) {
+                continue;
+            }
+            if (cover.empty() || (is_accepting(current) && std::none_of(cover.begin(), cover.end(), is_accepting))) {
+                return false;
+            }
+            SuccessorSet key(cover);
+            key.push_back(current);
+            if (!visited.insert(std::move(key)).second) {
+                continue;
+            }
+            for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+                SuccessorSet successors;
+                for (const NodeValue member : cover) {
+                    successors.push_back(get_successor(member, atom));
+                }
+                std::sort(successors.begin(), successors.end());
+                successors.erase(std::unique(successors.begin(), successors.end()), successors.end());
+                worklist.emplace_back(get_successor(current, atom), std::move(successors));
+            }
+        }
+        return true;
+    };
+    std::vector<bool> is_prime(num_of_states);
+    for (size_t state = 0; state < num_of_states; ++state) {
+        is_prime[state] = !is_covered(state);
+    }
+
+    // Targets replacing a transition to a state: the state itself if it is prime or empty,
+    // otherwise the maximal prime states included in it.
+    auto get_cover = [&](const size_t state) {
+        SuccessorSet cover;
+        if (is_prime[state] || is_empty[state]) {
+            cover.push_back(static_cast<NodeValue>(state));
+            return cover;
+        }
+        for (size_t other = 0; other < num_of_states; ++other) {
+            if (!is_prime[other] || !is_included(other, state)) {
+                continue;
+            }
+            const bool is_maximal = std::none_of(cover.begin(), cover.end(), [&](const NodeValue member) {
+                return is_included(other, member);
+            });
+            if (is_maximal) {
+                cover.erase(std::remove_if(cover.begin(), cover.end(), [&](const NodeValue member) { return is_included(member, other); }),
+                            cover.end());
+                cover.push_back(static_cast<NodeValue>(other));
+            }
+        }
+        assert(!cover.empty());
+        return cover;
+    };
+
+    // Keep the states reachable from the initial state through the covers, numbered in discovery order.
+    constexpr NodeValue NO_STATE = std::numeric_limits<NodeValue>::max();
+    std::vector<NodeValue> new_ids(num_of_states, NO_STATE);
+    std::vector<size_t> kept{ static_cast<size_t>(dfa->s) };
+    new_ids[static_cast<size_t>(dfa->s)] = 0;
+    std::vector<SuccessorSet> covers(num_of_states);
+    std::vector<bool> has_cover(num_of_states, false);
+    for (size_t i = 0; i < kept.size(); ++i) {
+        for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+            const NodeValue target = get_successor(kept[i], atom);
+            if (!has_cover[target]) {
+                covers[target] = get_cover(target);
+                has_cover[target] = true;
+            }
+            for (const NodeValue member : covers[target]) {
+                if (new_ids[member] == NO_STATE) {
+                    new_ids[member] = static_cast<NodeValue>(kept.size());
+                    kept.push_back(member);
+                }
+            }
+        }
+    }
+
+    std::vector<NodeId> roots;
+    std::vector<int> finals;
+    for (const size_t state : kept) {
+        roots.push_back(behaviours.roots[state]);
+        finals.push_back(is_accepting(state) ? 1 : -1);
+    }
+    auto get_successors = [&](const NodeValue set) {
+        std::vector<NodeValue> successors;
+        for (const NodeValue member : covers[behaviours.sets[set].front()]) {
+            successors.push_back(new_ids[member]);
+        }
+        std::sort(successors.begin(), successors.end());
+        return successors;
+    };
+    return encode_nondeterminism(behaviours.diagrams, roots, num_of_alphabet_vars, get_successors, finals, 0, nondeterminism_level);
+}
+
 /**
- * @brief Converts a decimal value to its binary representation as a BitVector.
+ * @brief Minimizes a MONA DFA by Hopcroft's partition refinement over the atoms of its behaviours.
+ *
+ * The transitions are read as a complete DFA over the atoms, so every state has exactly one successor
+ * on every atom. Blocks start as the reachable states grouped by their final flags and a worklist holds
+ * the splitters (block, atom) still to be processed. A splitter marks the predecessors of its block on
+ * its atom and splits every block with a marked and an unmarked part; only the smaller half of a split
+ * block is queued for the atoms on which the block itself is not queued any more.
+ *
+ * The atoms are timed by the session `atoms`, the splitting by `refinement` and the construction of
+ * the result by `rebuild`.
  *
- * @param decimal_value Decimal value to be converted.
- * @param num_of_bits Number of bits in the resulting BitVector.
+ * @param dfa MONA DFA to minimize.
+ * @param num_of_vars Total number of variables of the DFA.
  *
- * @return BitVector Binary representation of the decimal value.
+ * @return Newly allocated minimal MONA DFA.
  */
-mamonata::mtrobdd::BitVector get_binary_code(size_t decimal_value, size_t num_of_bits) {
-    mamonata::mtrobdd::BitVector code(num_of_bits, mamonata::mtrobdd::LO);
-    for (size_t i = 0; i < num_of_bits; ++i) {
-        if (decimal_value % 2 == 1) {
-            code[num_of_bits - i - 1] = mamonata::mtrobdd::HI;
+DFA* minimize_by_hopcroft(DFA* dfa, const size_t num_of_vars) {
+    using namespace mamonata::mtrobdd;
+
+    const size_t num_of_states = static_cast<size_t>(dfa->ns);
+
+    Timer::Span atoms_span("atoms");
+    SuccessorBehaviours behaviours(dfa, num_of_vars, num_of_vars);
+    size_t num_of_atoms = 0;
+    const std::vector<NodeValue> post = get_atom_successors(behaviours, num_of_vars, num_of_atoms);
+    auto get_successor = [&](const NodeValue state, const size_t atom) {
+        return behaviours.sets[post[state * num_of_atoms + atom]].front();
+    };
+    atoms_span.stop();
+
+    Timer::Span refinement_span("refinement");
+    // Reachable states in the order of discovery from the initial state.
+    std::vector<bool> is_reachable(num_of_states, false);
+    std::vector<NodeValue> reachable{ static_cast<NodeValue>(dfa->s) };
+    is_reachable[static_cast<size_t>(dfa->s)] = true;
+    for (size_t i = 0; i < reachable.size(); ++i) {
+        for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+            const NodeValue successor = get_successor(reachable[i], atom);
+            if (!is_reachable[successor]) {
+                is_reachable[successor] = true;
+                reachable.push_back(successor);
+            }
+        }
+    }
+
+    // Predecessors of the reachable states, packed by atom * num_of_states + successor.
+    std::vector<size_t> pre_begin(num_of_atoms * num_of_states + 1, 0);
+    for (const NodeValue state : reachable) {
+        for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+            ++pre_begin[atom * num_of_states + get_successor(state, atom) + 1];
+        }
+    }
+    std::partial_sum(pre_begin.begin(), pre_begin.end(), pre_begin.begin());
+    std::vector<NodeValue> pre(pre_begin.back());
+    {
+        std::vector<size_t> pre_end(pre_begin.begin(), pre_begin.end() - 1);
+        for (const NodeValue state : reachable) {
+            for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+                pre[pre_end[atom * num_of_states + get_successor(state, atom)]++] = state;
+            }
         }
-        decimal_value /= 2;
     }
-    return code;
+
+    // Every block is a range of `elements`; its marked states are moved to the front of the range.
+    std::vector<NodeValue> block_of(num_of_states, 0);
+    std::vector<NodeValue> elements;
+    std::vector<size_t> location(num_of_states, 0);
+    std::vector<size_t> block_begin;
+    std::vector<size_t> block_end;
+    {
+        std::unordered_map<int, NodeValue> flag_blocks;
+        std::vector<size_t> block_sizes;
+        for (const NodeValue state : reachable) {
+            auto [it, inserted] = flag_blocks.emplace(dfa->f[state], flag_blocks.size());
+            if (inserted) {
+                block_sizes.push_back(0);
+            }
+            block_of[state] = it->second;
+            ++block_sizes[it->second];
+        }
+        size_t begin = 0;
+        for (const size_t block_size : block_sizes) {
+            block_begin.push_back(begin);
+            block_end.push_back(begin);
+            begin += block_size;
+        }
+        elements.resize(reachable.size());
+        for (const NodeValue state : reachable) {
+            location[state] = block_end[block_of[state]]++;
+            elements[location[state]] = state;
+        }
+    }
+    std::vector<size_t> num_of_marked(block_begin.size(), 0);
+
+    std::vector<bool> is_queued;
+    std::vector<std::pair<NodeValue, size_t>> worklist;
+    auto add_splitter = [&](const NodeValue block, const size_t atom) {
+        if (is_queued.size() < (block + 1) * num_of_atoms) {
+            is_queued.resize((block + 1) * num_of_atoms, false);
+        }
+        if (!is_queued[block * num_of_atoms + atom]) {
+            is_queued[block * num_of_atoms + atom] = true;
+            worklist.emplace_back(block, atom);
+        }
+    };
+    // All blocks but the largest one are enough to split the initial partition.
+    if (block_begin.size() > 1) {
+        NodeValue largest = 0;
+        for (NodeValue block = 1; block < block_begin.size(); ++block) {
+            if (block_end[block] - block_begin[block] > block_end[largest] - block_begin[largest]) {
+                largest = block;
+            }
+        }
+        for (NodeValue block = 0; block < block_begin.size(); ++block) {
+            if (block != largest) {
+                for (size_t atom = 0; atom < num_of_atoms; ++atom) {
+                    add_splitter(block, atom);
+                }
+            }
+        }
+    }
+
+    std::vector<NodeValue> predecessors;
+    std::vector<NodeValue> touched_blocks;
+    while (!worklist.empty()) {
+        const auto [splitter, atom] = worklist.back();
+        worklist.pop_back();
+        is_queued[splitter * num_of_atoms + atom] = false;
+
+        // Every state has a single successor on the atom, so the predecessors are distinct.
+        predecessors.clear();
+        for (size_t i = block_begin[splitter]; i < block_end[splitter]; ++i) {
+            const size_t key = atom * num_of_states + elements[i];
+            predecessors.insert(predecessors.end(), pre.begin() + pre_begin[key], pre.begin() + pre_begin[key + 1]);
+        }
+        for (const NodeValue state : predecessors) {
+            const NodeValue block = block_of[state];
+            const size_t marked_end = block_begin[block] + num_of_marked[block];
+            if (num_of_marked[block] == 0) {
+                touched_blocks.push_back(block);
+            }
+            std::swap(elements[location[state]], elements[marked_end]);
+            location[elements[location[state]]] = location[state];
+            location[state] = marked_end;
+            ++num_of_marked[block];
+        }
+
+        for (const NodeValue block : touched_blocks) {
+            const size_t split = block_begin[block] + num_of_marked[block];
+            num_of_marked[block] = 0;
+            if (split == block_end[block]) {
+                continue;
+            }
+            // The marked part becomes a new block.
+            const NodeValue new_block = static_cast<NodeValue>(block_begin.size());
+            block_begin.push_back(block_begin[block]);
+            block_end.push_back(split);
+            num_of_marked.push_back(0);
+            block_begin[block] = split;
+            for (size_t i = block_begin[new_block]; i < split; ++i) {
+                block_of[elements[i]] = new_block;
+            }
+            const bool is_new_smaller = split - block_begin[new_block] <= block_end[block] - split;
+            for (size_t splitter_atom = 0; splitter_atom < num_of_atoms; ++splitter_atom) {
+                const bool is_block_queued = block * num_of_atoms + splitter_atom < is_queued.size() &&
+                                             is_queued[block * num_of_atoms + splitter_atom];
+                add_splitter((is_block_queued || is_new_smaller) ? new_block : block, splitter_atom);
+            }
+        }
+        touched_blocks.clear();
+    }
+    const size_t num_of_blocks = block_begin.size();
+    refinement_span.stop();
+
+    // Construct the minimal MONA DFA from the behaviour of the first state of every block.
+    Timer::Span rebuild_span("rebuild");
+    ArenaMtRobdd input(num_of_vars, dfa->bddm, dfa->q, num_of_states);
+    ArenaMtRobdd output(num_of_vars);
+    std::vector<NodeId> output_memo(input.get_num_of_nodes(), NULL_NODE);
+    std::function<NodeId(NodeId)> build_output = [&](const NodeId node) -> NodeId {
+        if (output_memo[node] != NULL_NODE) {
+            return output_memo[node];
+        }
+        NodeId result;
+        if (input.is_terminal(node)) {
+            result = output.create_terminal_node(block_of[input.get_value(node)]);
+        } else {
+            const NodeId low_child = build_output(input.get_low(node));
+            const NodeId high_child = build_output(input.get_high(node));
+            result = (low_child == high_child) ? low_child : output.create_node(input.get_var_index(node), low_child, high_child);
+        }
+        output_memo[node] = result;
+        return result;
+    };
+    DFA* result = dfaMake(static_cast<int>(num_of_blocks));
+    for (NodeValue block = 0; block < num_of_blocks; ++block) {
+        const NodeValue state = elements[block_begin[block]];
+        output.promote_to_root(build_output(input.get_root_node(state)), block);
+        result->f[block] = dfa->f[state];
+    }
+    reserve_mona_nodes(result->bddm, output.get_num_of_nodes());
+    result->s = static_cast<int>(block_of[static_cast<size_t>(dfa->s)]);
+    output.to_mona(result->bddm, result->q);
+
+    return result;
+}
+
+// Transitions of a state over a range of alphabet codes.
+struct CodeSegment {
+    mamonata::mona::nfa::Code first;                  // First code of the range.
+    mamonata::mona::nfa::Code last;                   // Last code of the range (inclusive).
+    std::vector<mamonata::mtrobdd::NodeValue> targets; // Sorted targets of all codes in the range.
 };
 
+/**
+ * @brief Splits the transitions of a state into disjoint ranges of codes with equal sets of targets.
+ *
+ * Each cube of the state's MTROBDD covers the codes agreeing with it on the tested alphabet
+ * variables. Don't-care variables at the end of the code span a contiguous range, so a cube
+ * yields one range per assignment of its remaining don't-care variables. The ranges are then
+ * swept in the order of codes, so the work depends on the number of ranges rather than codes.
+ *
+ * @param manager MTROBDD of the automaton.
+ * @param root_node Root of the state's transitions.
+ * @param num_of_alphabet_vars Number of alphabet variables, the most significant bits of a cube.
+ * @param num_of_nondet_vars Number of nondeterminism variables, the least significant bits of a cube.
+ * @param events Buffer for the boundaries of the ranges; cleared before use.
+ * @param segments Output segments in the increasing order of codes; cleared before use.
+ */
+void collect_code_segments(const mamonata::mtrobdd::ArenaMtRobdd& manager, const mamonata::mtrobdd::NodeId root_node,
+                           const size_t num_of_alphabet_vars, const size_t num_of_nondet_vars,
+                           std::vector<std::tuple<mamonata::mona::nfa::Code, bool, mamonata::mtrobdd::NodeValue>>& events,
+                           std::vector<CodeSegment>& segments) {
+    using namespace mamonata::mtrobdd;
+    using mamonata::mona::nfa::Code;
+    const uint64_t alphabet_mask = (num_of_alphabet_vars >= 64) ? ~uint64_t{0} : (uint64_t{1} << num_of_alphabet_vars) - 1;
+    events.clear();
+    segments.clear();
+    manager.for_each_cube(root_node, [&](const Cube& cube, const NodeValue target) {
+        COUNT(BIT_STRINGS_ENUMERATED, 1);
+        const uint64_t code_values = (cube.values >> num_of_nondet_vars) & alphabet_mask;
+        const uint64_t free_mask = ~(cube.care_mask >> num_of_nondet_vars) & alphabet_mask;
+        // Trailing don't-cares form the range; the other don't-cares are enumerated.
+        const uint64_t range_mask = free_mask & ~(free_mask + 1);
+        const uint64_t split_mask = free_mask & ~range_mask;
+        uint64_t split_values = split_mask;
+        while (true) {
+            const Code first = code_values | split_values;
+            events.emplace_back(first, true, target);
+            events.emplace_back(first | range_mask, false, target);
+            if (split_values == 0) {
+                break;
+            }
+            split_values = (split_values - 1) & split_mask;
+        }
+    });
+
+    // Starts of ranges precede ends at the same code, so every range covers its last code.
+    std::sort(events.begin(), events.end(), [](const auto& lhs, const auto& rhs) {
+        if (std::get<0>(lhs) != std::get<0>(rhs)) {
+            return std::get<0>(lhs) < std::get<0>(rhs);
+        }
+        return std::get<1>(lhs) && !std::get<1>(rhs);
+    });
+
+    // Number of active ranges leading to each target; several cubes may overlap with nondeterminism bits.
+    std::vector<std::pair<NodeValue, size_t>> active;
+    Code segment_first = 0;
+    auto close_segment = [&](const Code last) {
+        if (active.empty() || segment_first > last) {
+            return;
+        }
+        std::vector<NodeValue> targets;
+        targets.reserve(active.size());
+        for (const auto& [target, count] : active) {
+            targets.push_back(target);
+        }
+        if (!segments.empty() && segments.back().last + 1 == segment_first && segments.back().targets == targets) {
+            segments.back().last = last;
+        } else {
+            segments.push_back(CodeSegment{ segment_first, last, std::move(targets) });
+        }
+    };
+    for (const auto& [code, is_start, target] : events) {
+        auto it = std::lower_bound(active.begin(), active.end(), target,
+                                   [](const auto& entry, const NodeValue value) { return entry.first < value; });
+        if (is_start) {
+            if (it != active.end() && it->first == target) {
+                ++it->second;
+                continue;
+            }
+            if (code > 0) {
+                close_segment(code - 1);
+            }
+            active.insert(it, { target, 1 });
+            segment_first = code;
+        } else {
+            assert(it != active.end() && it->first == target);
+            if (--it->second > 0) {
+                continue;
+            }
+            close_segment(code);
+            active.erase(it);
+            segment_first = code + 1;
+        }
+    }
+}
+
 }
 
 namespace mamonata::mona::nfa {
 
 void Nfa::generate_alphabet(const size_t size) {
-    alphabet_size = size;
-    alphabet_encode_dict.clear();
-    alphabet_decode_dict.clear();
-    for (size_t a = 0; a < alphabet_size; ++a) {
-        mamonata::mtrobdd::BitVector code = get_binary_code(a, num_of_alphabet_vars);
-        alphabet_encode_dict[a] = code;
-        alphabet_decode_dict[code] = a;
-    }
+    alphabet_encoding = std::make_shared<const AlphabetEncoding>(AlphabetEncoding::identity(size, num_of_alphabet_vars));
 }
 
 void Nfa::update_alphabet(const Nfa& other) {
-    assert(alphabet_encode_dict.size() == alphabet_decode_dict.size());
-    for (const auto& [code, symbol] : other.alphabet_decode_dict) {
-        assert(alphabet_encode_dict.size() == alphabet_decode_dict.size());
-        if (!alphabet_decode_dict.contains(code)) {
-            assert(!alphabet_encode_dict.contains(symbol));
-            alphabet_decode_dict[code] = symbol;
-            alphabet_encode_dict[symbol] = code;
+    if (alphabet_encoding == other.alphabet_encoding) {
+        return;
+    }
+    assert(alphabet_encoding->get_num_of_vars() == other.alphabet_encoding->get_num_of_vars());
+    std::optional<AlphabetEncoding> updated_encoding;
+    other.alphabet_encoding->for_each([&](const Symbol symbol, const Code code) {
+        if (alphabet_encoding->decode(code) == AlphabetEncoding::NO_SYMBOL) {
+            assert(alphabet_encoding->encode(symbol) == AlphabetEncoding::NO_CODE);
+            if (!updated_encoding.has_value()) {
+                updated_encoding.emplace(*alphabet_encoding);
+            }
+            updated_encoding->add(symbol, code);
         }
+    });
+    if (updated_encoding.has_value()) {
+        alphabet_encoding = std::make_shared<const AlphabetEncoding>(std::move(*updated_encoding));
+    }
+}
+
+AlphabetEncodingPtr Nfa::make_alphabet_encoding(const MataSymbolVector& alphabet) {
+    assert(!alphabet.empty());
+    const size_t alphabet_vars = static_cast<size_t>(std::ceil(std::log2(static_cast<double>(alphabet.size()))));
+    return std::make_shared<const AlphabetEncoding>(std::vector<Symbol>(alphabet.begin(), alphabet.end()), alphabet_vars);
+}
+
+void Nfa::check_alphabet_encoding(const Nfa& other) {
+    if (alphabet_encoding == other.alphabet_encoding) {
+        return;
+    }
+    if (!has_same_alphabet_encoding(other)) {
+        throw std::runtime_error("Operands use different alphabet encodings");
     }
+    alphabet_encoding = other.alphabet_encoding;
 }
 
 void Nfa::_print(const std::string& file_path) const {
@@ -143,92 +1308,138 @@ Nfa& Nfa::load(const std::string& file_path){
     }
 
     // Generate alphabet symbols from 0 to 2^(num_of_alphabet_vars)-1
-    alphabet_size = 1 << num_of_alphabet_vars;
-    alphabet_encode_dict.clear();
-    alphabet_decode_dict.clear();
-    for (size_t a = 0; a < alphabet_size; ++a) {
-        mamonata::mtrobdd::BitVector code = get_binary_code(a, num_of_alphabet_vars);
-        alphabet_encode_dict[a] = code;
-        alphabet_decode_dict[code] = a;
-    }
+    alphabet_encoding = std::make_shared<const AlphabetEncoding>(
+        AlphabetEncoding::identity(size_t{1} << num_of_alphabet_vars, num_of_alphabet_vars));
 
-    // Clean up
+    // Clean up (dfaImport allocates the names and orders by mem_alloc)
     for (size_t i = 0; i < total_var_count; ++i) {
-        delete[] names[i];
+        mem_free(names[i]);
     }
-    delete[] names;
-    delete[] orders;
+    mem_free(names);
+    mem_free(orders);
 
     return *this;
 }
 
-Nfa& Nfa::from_mata(const mamonata::mata::nfa::Nfa& input, const std::optional<MataSymbolVector>& alphabet_order) {
-    // Ensure single initial state. Don't modify input NFA.
-    mamonata::mata::nfa::Nfa mata_nfa(input);
-    if (mata_nfa.get_initial_states().size() > 1) {
-        mata_nfa.unify_initial_states();
+bool Nfa::build_state_mtrobdds(const mamonata::mata::nfa::Nfa& input, const AlphabetEncoding& encoding, const size_t num_of_nondet_vars,
+                               mamonata::mtrobdd::ArenaMtRobdd& manager, const State begin, const State end) {
+    const size_t num_of_vars = manager.get_num_of_vars();
+    const mamonata::mtrobdd::NodeValue sink_state = input.num_of_states();
+    // The sink is virtual, so no node of the arena leads to it explicitly.
+    manager.set_virtual_sink(sink_state);
+    std::vector<mamonata::mtrobdd::Minterm> minterms;
+    bool sink_used = false;
+    for (State src = begin; src < end; ++src) {
+        minterms.clear();
+        for (const auto& symbol_post : input.get_state_post(src)) {
+            const Code code = encoding.encode(symbol_post.symbol);
+            if (code == AlphabetEncoding::NO_CODE) {
+                // Symbol is not part of the alphabet.
+                continue;
+            }
+            uint64_t nondet_code = 0;
+            for (const State target : symbol_post.targets) {
+                minterms.emplace_back((code << num_of_nondet_vars) | nondet_code, target);
+                ++nondet_code;
+            }
+        }
+        // Symbol codes are unique and symbol posts are not necessarily ordered by their codes.
+        std::sort(minterms.begin(), minterms.end());
+
+        COUNT(BIT_STRINGS_INSERTED, minterms.size());
+        const mamonata::mtrobdd::NodeId root_node = manager.create_from_minterms(minterms, sink_state);
+        manager.promote_to_root(root_node, src);
+        sink_used |= (num_of_vars >= 64 || minterms.size() < (uint64_t{1} << num_of_vars));
     }
+    return sink_used;
+}
 
-    // Determine number of noneterminism bits.
-    nondeterminism_level = mata_nfa.get_nondeterminism_level();
-    if (nondeterminism_level > 1) {
-        num_of_nondet_vars = static_cast<size_t>(std::ceil(std::log2(static_cast<double>(nondeterminism_level))));
-    } else {
-        // Set to 0 when deterministic.
-        num_of_nondet_vars = 0;
+Nfa& Nfa::from_mata(const mamonata::mata::nfa::Nfa& input, const std::optional<MataSymbolVector>& alphabet_order,
+                    const size_t num_of_threads) {
+    // Symbol alphabet[a] is encoded as a.
+    return from_mata(input, make_alphabet_encoding(alphabet_order.has_value() ? *alphabet_order : input.get_used_symbols()),
+                     num_of_threads);
+}
+
+Nfa& Nfa::from_mata(const mamonata::mata::nfa::Nfa& input, const AlphabetEncodingPtr& encoding, const size_t num_of_threads) {
+    assert(encoding != nullptr);
+
+    // Reuse a previous conversion of the same automaton if caching is enabled.
+    ConversionCache& cache = ConversionCache::instance();
+    std::optional<ConversionCache::Key> cache_key;
+    if (cache.is_enabled()) {
+        cache_key = get_mata_fingerprint(input, *encoding);
+        if (std::optional<Nfa> cached = cache.find_mona(*cache_key)) {
+            *this = std::move(*cached);
+            return *this;
+        }
     }
 
-    // Determine alphabet size and number of alphabet bits.
-    MataSymbolVector alphabet = alphabet_order.has_value() ? *alphabet_order
-                                                           : mata_nfa.get_used_symbols();
-    alphabet_size = alphabet.size();
-    assert(alphabet_size > 0);
-    num_of_alphabet_vars = static_cast<size_t>(std::ceil(std::log2(static_cast<double>(alphabet_size))));
+    // Ensure single initial state. Don't modify input NFA; copy it only if the initial states have to be unified.
+    std::optional<mamonata::mata::nfa::Nfa> unified_input;
+    if (input.num_of_initial_states() > 1) {
+        unified_input.emplace(input);
+        unified_input->unify_initial_states();
+    }
+    const mamonata::mata::nfa::Nfa& mata_nfa = unified_input.has_value() ? *unified_input : input;
 
-    // Total number of variables.
+    // Determine number of noneterminism bits.
+    nondeterminism_level = mata_nfa.get_nondeterminism_level();
+    num_of_nondet_vars = get_num_of_nondet_vars(nondeterminism_level);
+
+    // Alphabet bits come first, nondeterminism bits last.
+    alphabet_encoding = encoding;
+    num_of_alphabet_vars = alphabet_encoding->get_num_of_vars();
     num_of_vars = num_of_alphabet_vars + num_of_nondet_vars;
 
-    // Build encoding and decoding dictionaries for alphabet symbols.
-    alphabet_encode_dict.clear();
-    alphabet_decode_dict.clear();
-    for (size_t a = 0; a < alphabet_size; ++a) {
-        mamonata::mtrobdd::BitVector code = get_binary_code(a, num_of_alphabet_vars);
-        alphabet_encode_dict[alphabet[a]] = code;
-        alphabet_decode_dict[code] = alphabet[a];
-    }
-
-    // Build NFA transitions using MTROBDD encoding.
-    mamonata::mtrobdd::MtRobdd mtrobdd_manager(num_of_vars);
-    for (size_t src = 0; src < mata_nfa.num_of_states(); ++src) {
-        for (const Symbol symbol: alphabet) {
-            StateVector targets = mata_nfa.get_successors(src, symbol);
-            for (size_t i = 0; i < targets.size(); ++i) {
-                mamonata::mtrobdd::BitVector transition_code(num_of_vars, mamonata::mtrobdd::LO);
-                // Set alphabet bits.
-                const mamonata::mtrobdd::BitVector& symbol_code = alphabet_encode_dict[symbol];
-                for (size_t j = 0; j < num_of_alphabet_vars; ++j) {
-                    transition_code[j] = symbol_code[j];
-                }
-                // Set nondeterminism bits.
-                mamonata::mtrobdd::BitVector nondet_code = get_binary_code(i, num_of_nondet_vars);
-                for (size_t j = 0; j < num_of_nondet_vars; ++j) {
-                    transition_code[num_of_alphabet_vars + j] = nondet_code[j];
-                }
-                // Add transition to MTORBDD.
-                mtrobdd_manager.insert_bit_string_from_root(src, transition_code, targets[i]);
+    // Build the complete reduced MTROBDD of each state in a single bottom-up pass.
+    const size_t num_of_states = mata_nfa.num_of_states();
+    const mamonata::mtrobdd::NodeValue sink_state = num_of_states;
+    auto build_states = [&](mamonata::mtrobdd::ArenaMtRobdd& manager, const State begin, const State end) -> bool {
+        return build_state_mtrobdds(mata_nfa, *alphabet_encoding, num_of_nondet_vars, manager, begin, end);
+    };
+
+    mamonata::mtrobdd::ArenaMtRobdd mtrobdd_manager(num_of_vars);
+    mtrobdd_manager.set_virtual_sink(sink_state);
+    bool sink_used = false;
+    if (num_of_threads <= 1) {
+        sink_used = build_states(mtrobdd_manager, 0, num_of_states);
+    } else {
+        // Each worker builds the states of its range in its own arena;
+        // the arenas are then merged into the shared one.
+        std::vector<mamonata::mtrobdd::ArenaMtRobdd> worker_managers;
+        std::vector<std::pair<State, State>> worker_ranges(num_of_threads);
+        std::vector<char> worker_sink_used(num_of_threads, false);
+        worker_managers.reserve(num_of_threads);
+        for (size_t worker = 0; worker < num_of_threads; ++worker) {
+            worker_managers.emplace_back(num_of_vars).set_virtual_sink(sink_state);
+        }
+        mamonata::run_in_parallel(num_of_states, num_of_threads, [&](const size_t begin, const size_t end, const size_t worker) {
+            worker_ranges[worker] = { begin, end };
+            worker_sink_used[worker] = build_states(worker_managers[worker], begin, end);
+        });
+        for (size_t worker = 0; worker < num_of_threads; ++worker) {
+            const std::vector<mamonata::mtrobdd::NodeId> new_ids = mtrobdd_manager.import_nodes(worker_managers[worker]);
+            for (State src = worker_ranges[worker].first; src < worker_ranges[worker].second; ++src) {
+                const mamonata::mtrobdd::NodeId root_node = worker_managers[worker].get_root_node(src);
+                mtrobdd_manager.promote_to_root((root_node == mamonata::mtrobdd::NULL_NODE) ? root_node : new_ids[root_node], src);
             }
+            sink_used |= worker_sink_used[worker];
         }
     }
+    // MONA DFAs are complete, so the sink becomes a real state looping to itself on every symbol
+    // if some assignment leads to it. Its MONA leaf is created by to_mona().
+    if (sink_used) {
+        mtrobdd_manager.promote_to_root(mamonata::mtrobdd::NULL_NODE, sink_state);
+    }
 
-    // Reduce MTROBDD to canonical form.
-    mtrobdd_manager.trim().remove_redundant_tests().make_complete(input.num_of_states());
-
-    // Construct MONA DFA.
+    // Construct MONA DFA with a BDD manager fitting all nodes (and the leaf of the virtual sink).
     nfa_impl = dfaMake(static_cast<int>(mtrobdd_manager.get_num_of_roots()));
+    mamonata::mtrobdd::reserve_mona_nodes(nfa_impl->bddm, mtrobdd_manager.get_num_of_nodes() + 1);
     // Set initial state.
-    nfa_impl->s = static_cast<int>(mata_nfa.get_initial_states().front());
+    nfa_impl->s = static_cast<int>(mata_nfa.view_initial_states().front());
     // Set final states.
-    for (State state = 0; state < mata_nfa.num_of_states(); ++state) {
+    for (State state = 0; state < num_of_states; ++state) {
         if (mata_nfa.is_final_state(state)) {
             nfa_impl->f[state] = 1;
         } else {
@@ -236,19 +1447,38 @@ Nfa& Nfa::from_mata(const mamonata::mata::nfa::Nfa& input, const std::optional<M
         }
     }
     // Set sink state as reject if exists.
-    for (State state = mata_nfa.num_of_states(); state < mtrobdd_manager.get_num_of_roots(); ++state) {
+    for (State state = num_of_states; state < mtrobdd_manager.get_num_of_roots(); ++state) {
         nfa_impl->f[state] = -1;
     }
 
     // Export MTROBDD to MONA representation.
     mtrobdd_manager.to_mona(nfa_impl->bddm, nfa_impl->q);
+    COUNT(MONA_BDD_NODES, bdd_size(nfa_impl->bddm));
+
+    if (cache_key.has_value()) {
+        cache.insert_mona(*cache_key, *this, memory_footprint());
+    }
 
     return *this;
 }
 
-mamonata::mata::nfa::Nfa Nfa::to_mata() const {
-    // Construct mata NFA states
+mamonata::mata::nfa::Nfa Nfa::to_mata(const size_t num_of_threads) const {
     const size_t num_of_states = static_cast<size_t>(nfa_impl->ns);
+
+    // Reuse a previous conversion of the same automaton if caching is enabled.
+    ConversionCache& cache = ConversionCache::instance();
+    std::optional<ConversionCache::Key> cache_key;
+    if (cache.is_enabled()) {
+        cache_key = get_mona_fingerprint(nfa_impl, num_of_vars, num_of_nondet_vars, *alphabet_encoding);
+        if (std::optional<mamonata::mata::nfa::Nfa> cached = cache.find_mata(*cache_key)) {
+            return std::move(*cached);
+        }
+    }
+
+    // Build MTROBDD from MONA representation
+    mtrobdd::ArenaMtRobdd mtrobdd_manager(num_of_vars, nfa_impl->bddm, nfa_impl->q, num_of_states);
+
+    // Construct mata NFA states
     mamonata::mata::nfa::Nfa mata_nfa(num_of_states);
 
     // Set initial and final states
@@ -259,46 +1489,121 @@ mamonata::mata::nfa::Nfa Nfa::to_mata() const {
         }
     }
 
-    // Build MTROBDD from MONA representation
-    mtrobdd::MtRobdd mtrobdd_manager(num_of_vars, nfa_impl->bddm, nfa_impl->q, num_of_states);
-
-    // Extract transitions
-    for (mtrobdd::NodeName src = 0; src < num_of_states; ++src) {
-        mtrobdd::MtBddNodePtr root_node = mtrobdd_manager.get_root_node(src);
-        assert(root_node != nullptr);
-        for (const auto& [bit_string, target_value] : mtrobdd_manager.get_all_bit_strings_from_root_node(root_node)) {
-            try {
-                mata_nfa.add_transition(
-                    static_cast<State>(src),
-                    decode_symbol(bit_string),
-                    static_cast<State>(target_value)
-                );
-            } catch (const std::out_of_range& e) {
-                // Symbol not found in decoding dictionary - skip transition
-                continue;
+    // Posts of all states exist already, so workers may fill them concurrently.
+    std::vector<mamonata::mata::nfa::StatePost*> state_posts(num_of_states);
+    for (State state = 0; state < num_of_states; ++state) {
+        state_posts[state] = &mata_nfa.get_mutable_state_post(state);
+    }
+
+    // Extract transitions as ranges of codes, so a cube covering many codes is processed at once.
+    // Symbol posts are appended in the order of codes, which is the order required by Mata
+    // for order-preserving encodings; otherwise they are sorted by symbols first.
+    const bool is_order_preserving = alphabet_encoding->is_order_preserving();
+    mamonata::run_in_parallel(num_of_states, num_of_threads, [&](const size_t begin, const size_t end, size_t) {
+        std::vector<std::tuple<Code, bool, mtrobdd::NodeValue>> events;
+        std::vector<CodeSegment> segments;
+        std::vector<mamonata::mata::nfa::SymbolPost> symbol_posts;
+        for (mtrobdd::NodeName src = begin; src < end; ++src) {
+            mtrobdd::NodeId root_node = mtrobdd_manager.get_root_node(src);
+            assert(root_node != mtrobdd::NULL_NODE);
+            collect_code_segments(mtrobdd_manager, root_node, num_of_alphabet_vars, num_of_nondet_vars, events, segments);
+
+            symbol_posts.clear();
+            for (const CodeSegment& segment : segments) {
+                const mamonata::mata::nfa::StateSet targets(segment.targets.begin(), segment.targets.end());
+                // Codes without a symbol are not part of the alphabet - skip them.
+                alphabet_encoding->for_each_symbol_run(segment.first, segment.last, [&](const Symbol first, const Symbol last) {
+                    for (Symbol symbol = first; symbol <= last; ++symbol) {
+                        symbol_posts.emplace_back(static_cast<mamonata::mata::nfa::Symbol>(symbol), targets);
+                    }
+                });
+            }
+            if (!is_order_preserving) {
+                std::sort(symbol_posts.begin(), symbol_posts.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.symbol < rhs.symbol;
+                });
+            }
+
+            mamonata::mata::nfa::StatePost& state_post = *state_posts[src];
+            state_post.reserve(symbol_posts.size());
+            for (mamonata::mata::nfa::SymbolPost& symbol_post : symbol_posts) {
+                state_post.push_back(std::move(symbol_post));
             }
         }
+    });
+
+    if (cache_key.has_value()) {
+        cache.insert_mata(*cache_key, mata_nfa, mata_nfa.memory_footprint());
     }
 
     return mata_nfa;
 }
 
-Nfa& Nfa::determinize() {
-    DFA* tmp = nfa_impl;
-    std::vector<DFA*> to_free(num_of_nondet_vars, nullptr);
-    TIME(
-        for (size_t i = 0; i < num_of_nondet_vars; ++i) {
-            to_free[i] = tmp;
-            tmp = dfaProject(tmp, static_cast<unsigned>(num_of_vars - 0 - 1));
+std::vector<SymbolInterval> Nfa::get_symbol_intervals(const size_t num_of_threads) const {
+    const size_t num_of_states = static_cast<size_t>(nfa_impl->ns);
+    mtrobdd::ArenaMtRobdd mtrobdd_manager(num_of_vars, nfa_impl->bddm, nfa_impl->q, num_of_states);
+
+    std::vector<std::vector<SymbolInterval>> intervals_by_state(num_of_states);
+    mamonata::run_in_parallel(num_of_states, num_of_threads, [&](const size_t begin, const size_t end, size_t) {
+        std::vector<std::tuple<Code, bool, mtrobdd::NodeValue>> events;
+        std::vector<CodeSegment> segments;
+        for (mtrobdd::NodeName src = begin; src < end; ++src) {
+            mtrobdd::NodeId root_node = mtrobdd_manager.get_root_node(src);
+            assert(root_node != mtrobdd::NULL_NODE);
+            collect_code_segments(mtrobdd_manager, root_node, num_of_alphabet_vars, num_of_nondet_vars, events, segments);
+
+            std::vector<SymbolInterval>& intervals = intervals_by_state[src];
+            for (const CodeSegment& segment : segments) {
+                alphabet_encoding->for_each_symbol_run(segment.first, segment.last, [&](const Symbol first, const Symbol last) {
+                    for (const mtrobdd::NodeValue target : segment.targets) {
+                        intervals.push_back(SymbolInterval{ static_cast<State>(src), static_cast<mamonata::mata::nfa::Symbol>(first),
+                                                            static_cast<mamonata::mata::nfa::Symbol>(last), static_cast<State>(target) });
+                    }
+                });
+            }
+
+            // Join adjacent intervals of each target, split by codes or by other targets.
+            std::sort(intervals.begin(), intervals.end(), [](const SymbolInterval& lhs, const SymbolInterval& rhs) {
+                return std::tie(lhs.target, lhs.first) < std::tie(rhs.target, rhs.first);
+            });
+            size_t num_of_joined = 0;
+            for (const SymbolInterval& interval : intervals) {
+                if (num_of_joined > 0 && intervals[num_of_joined - 1].target == interval.target &&
+                    intervals[num_of_joined - 1].last + 1 >= interval.first) {
+                    intervals[num_of_joined - 1].last = std::max(intervals[num_of_joined - 1].last, interval.last);
+                } else {
+                    intervals[num_of_joined++] = interval;
+                }
+            }
+            intervals.resize(num_of_joined);
+            std::sort(intervals.begin(), intervals.end(), [](const SymbolInterval& lhs, const SymbolInterval& rhs) {
+                return std::tie(lhs.first, lhs.target) < std::tie(rhs.first, rhs.target);
+            });
         }
-    );
+    });
 
-    // Free intermediate DFAs
-    for (size_t i = 0; i < num_of_nondet_vars; ++i) {
-        assert(to_free[i] != nullptr);
-        dfaFree(to_free[i]);
+    std::vector<SymbolInterval> result;
+    for (std::vector<SymbolInterval>& intervals : intervals_by_state) {
+        result.insert(result.end(), intervals.begin(), intervals.end());
     }
-    nfa_impl = tmp;
+    return result;
+}
+
+Nfa& Nfa::determinize(const bool minimize_result) {
+    TIME(
+        if (num_of_nondet_vars > 0) {
+            DFA* tmp = project_nondeterminism(nfa_impl, num_of_vars, num_of_alphabet_vars);
+            COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm));
+            dfaFree(nfa_impl);
+            nfa_impl = tmp;
+            if (minimize_result) {
+                tmp = dfaMinimize(nfa_impl);
+                COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm));
+                dfaFree(nfa_impl);
+                nfa_impl = tmp;
+            }
+        }
+    );
 
     num_of_vars = num_of_alphabet_vars;
     num_of_nondet_vars = 0;
@@ -307,27 +1612,246 @@ Nfa& Nfa::determinize() {
     return *this;
 }
 
+Nfa& Nfa::reduce_simulation() {
+    TIME(auto tmp { reduce_by_simulation(nfa_impl, num_of_vars, num_of_alphabet_vars, nondeterminism_level) };
+         COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm)));
+    dfaFree(nfa_impl);
+    nfa_impl = tmp;
+    num_of_nondet_vars = get_num_of_nondet_vars(nondeterminism_level);
+    num_of_vars = num_of_alphabet_vars + num_of_nondet_vars;
+    return *this;
+}
+
+Nfa& Nfa::reduce_residual() {
+    TIME(if (num_of_nondet_vars > 0) { determinize(); } else { minimize(); }
+         auto tmp { reduce_to_residuals(nfa_impl, num_of_alphabet_vars, nondeterminism_level) };
+         COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm)));
+    dfaFree(nfa_impl);
+    nfa_impl = tmp;
+    num_of_nondet_vars = get_num_of_nondet_vars(nondeterminism_level);
+    num_of_vars = num_of_alphabet_vars + num_of_nondet_vars;
+    return *this;
+}
+
 Nfa& Nfa::minimize() {
-    TIME(auto tmp { dfaMinimize(nfa_impl) });
+    TIME(auto tmp { dfaMinimize(nfa_impl) };
+         COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm)));
+    dfaFree(nfa_impl);
+    nfa_impl = tmp;
+    return *this;
+}
+
+Nfa& Nfa::minimize_hopcroft() {
+    TIME(auto tmp { minimize_by_hopcroft(nfa_impl, num_of_vars) };
+         COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm)));
     dfaFree(nfa_impl);
     nfa_impl = tmp;
     return *this;
 }
 
 Nfa& Nfa::union_det_complete(const Nfa& aut) {
-    TIME(auto tmp { dfaProduct(nfa_impl, aut.nfa_impl, dfaOR) });
+    check_alphabet_encoding(aut);
+    TIME(auto tmp { dfaProduct(nfa_impl, aut.nfa_impl, dfaOR) };
+         COUNT(MONA_PRODUCT_STATES, tmp->ns);
+         COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm)));
     dfaFree(nfa_impl);
     nfa_impl = tmp;
     return *this;
 }
 
+Nfa& Nfa::union_det_complete(Nfa&& aut) {
+    union_det_complete(static_cast<const Nfa&>(aut));
+    if (&aut != this) {
+        aut = Nfa();
+    }
+    return *this;
+}
+
 Nfa& Nfa::intersection(const Nfa& aut) {
-    TIME(auto tmp { dfaProduct(nfa_impl, aut.nfa_impl, dfaAND) });
+    check_alphabet_encoding(aut);
+    TIME(auto tmp { dfaProduct(nfa_impl, aut.nfa_impl, dfaAND) };
+         COUNT(MONA_PRODUCT_STATES, tmp->ns);
+         COUNT(MONA_BDD_NODES, bdd_size(tmp->bddm)));
     dfaFree(nfa_impl);
     nfa_impl = tmp;
     return *this;
 }
 
+Nfa& Nfa::intersection(Nfa&& aut) {
+    intersection(static_cast<const Nfa&>(aut));
+    if (&aut != this) {
+        aut = Nfa();
+    }
+    return *this;
+}
+
+template<typename Operands>
+Nfa Nfa::combine_intersection(Operands&& operands, const ProductOptions& options) {
+    return combine_all(std::forward<Operands>(operands), options,
+        [](const Nfa& aut) { return aut.num_of_states(); },
+        [](Nfa& lhs, const Nfa& rhs) { lhs.intersection(rhs); },
+        [](Nfa& aut) { aut.minimize(); },
+        [](const Nfa& aut) { return aut.is_empty(); },
+        false);
+}
+
+template<typename Operands>
+Nfa Nfa::combine_union(Operands&& operands, const ProductOptions& options) {
+    return combine_all(std::forward<Operands>(operands), options,
+        [](const Nfa& aut) { return aut.num_of_states(); },
+        [](Nfa& lhs, const Nfa& rhs) { lhs.union_det_complete(rhs); },
+        [](Nfa& aut) { aut.minimize(); },
+        // A single final state loops on every symbol.
+        [](const Nfa& aut) { return aut.num_of_states() == 1 && aut.nfa_impl->f[0] == 1; },
+        false);
+}
+
+Nfa Nfa::intersection_all(const std::span<const Nfa> operands, const ProductOptions& options) {
+    Timer::Span span(__func__);
+    return combine_intersection(operands, options);
+}
+
+Nfa Nfa::intersection_all(std::vector<Nfa>&& operands, const ProductOptions& options) {
+    Timer::Span span(__func__);
+    return combine_intersection(std::move(operands), options);
+}
+
+Nfa Nfa::union_all(const std::span<const Nfa> operands, const ProductOptions& options) {
+    Timer::Span span(__func__);
+    return combine_union(operands, options);
+}
+
+Nfa Nfa::union_all(std::vector<Nfa>&& operands, const ProductOptions& options) {
+    Timer::Span span(__func__);
+    return combine_union(std::move(operands), options);
+}
+
+bool Nfa::find_product_witness(const Nfa& other, bool (*is_target)(bool, bool), MataSymbolVector* witness) const {
+    using namespace mamonata::mtrobdd;
+
+    // Nondeterminism variables would be read as symbols, so pseudo-nondeterministic automata are determinized.
+    std::optional<Nfa> lhs_det;
+    std::optional<Nfa> rhs_det;
+    const Nfa* lhs = this;
+    const Nfa* rhs = &other;
+    if (!lhs->is_deterministic()) {
+        lhs_det.emplace(lhs->clone());
+        lhs_det->determinize(false);
+        lhs = &*lhs_det;
+    }
+    if (&other == this) {
+        rhs = lhs;
+    } else if (!rhs->is_deterministic()) {
+        rhs_det.emplace(rhs->clone());
+        rhs_det->determinize(false);
+        rhs = &*rhs_det;
+    }
+    if (!lhs->has_same_alphabet_encoding(*rhs) || lhs->num_of_vars != rhs->num_of_vars) {
+        throw std::runtime_error("Operands use different alphabet encodings");
+    }
+
+    // Both automata share a single arena so their MTROBDDs can be traversed simultaneously.
+    const size_t lhs_num_of_states = static_cast<size_t>(lhs->nfa_impl->ns);
+    const size_t rhs_num_of_states = static_cast<size_t>(rhs->nfa_impl->ns);
+    ArenaMtRobdd mtrobdd_manager(lhs->num_of_vars, lhs->nfa_impl->bddm, lhs->nfa_impl->q, lhs_num_of_states);
+    std::vector<NodeId> lhs_roots(lhs_num_of_states);
+    for (State state = 0; state < lhs_num_of_states; ++state) {
+        lhs_roots[state] = mtrobdd_manager.get_root_node(state);
+    }
+    std::vector<NodeId> rhs_roots = lhs_roots;
+    if (rhs != lhs) {
+        const ArenaMtRobdd rhs_manager(rhs->num_of_vars, rhs->nfa_impl->bddm, rhs->nfa_impl->q, rhs_num_of_states);
+        const std::vector<NodeId> new_ids = mtrobdd_manager.import_nodes(rhs_manager);
+        rhs_roots.resize(rhs_num_of_states);
+        for (State state = 0; state < rhs_num_of_states; ++state) {
+            rhs_roots[state] = new_ids[rhs_manager.get_root_node(state)];
+        }
+    }
+
+    // Breadth-first search over pairs of states; each discovered pair remembers its predecessor and symbol.
+    struct Discovery {
+        uint64_t parent;
+        Symbol symbol;
+    };
+    auto get_key = [&](const State lhs_state, const State rhs_state) {
+        return static_cast<uint64_t>(lhs_state) * rhs_num_of_states + rhs_state;
+    };
+    const AlphabetEncoding& encoding = *lhs->alphabet_encoding;
+    const uint64_t all_vars_mask = (lhs->num_of_vars >= 64) ? ~uint64_t{0} : (uint64_t{1} << lhs->num_of_vars) - 1;
+    std::unordered_map<uint64_t, Discovery> discovered;
+    std::deque<std::pair<State, State>> queue;
+    const State lhs_initial = static_cast<State>(lhs->nfa_impl->s);
+    const State rhs_initial = static_cast<State>(rhs->nfa_impl->s);
+    discovered.emplace(get_key(lhs_initial, rhs_initial), Discovery{ 0, AlphabetEncoding::NO_SYMBOL });
+    queue.emplace_back(lhs_initial, rhs_initial);
+    while (!queue.empty()) {
+        const auto [lhs_state, rhs_state] = queue.front();
+        queue.pop_front();
+        const uint64_t key = get_key(lhs_state, rhs_state);
+        if (is_target(lhs->nfa_impl->f[lhs_state] == 1, rhs->nfa_impl->f[rhs_state] == 1)) {
+            if (witness != nullptr) {
+                witness->clear();
+                for (uint64_t current = key; current != get_key(lhs_initial, rhs_initial);) {
+                    const Discovery& discovery = discovered.at(current);
+                    witness->push_back(static_cast<mamonata::mata::nfa::Symbol>(discovery.symbol));
+                    current = discovery.parent;
+                }
+                std::reverse(witness->begin(), witness->end());
+            }
+            return true;
+        }
+        mtrobdd_manager.for_each_product_cube(lhs_roots[lhs_state], rhs_roots[rhs_state],
+            [&](const Cube& cube, const NodeValue lhs_target, const NodeValue rhs_target) {
+                const uint64_t target_key = get_key(lhs_target, rhs_target);
+                if (discovered.contains(target_key)) {
+                    return;
+                }
+                // Pick any code of the cube that encodes a symbol (don't-care variables enumerated as submasks).
+                const uint64_t free_mask = ~cube.care_mask & all_vars_mask;
+                uint64_t free_values = 0;
+                do {
+                    const Symbol symbol = encoding.decode(cube.values | free_values);
+                    if (symbol != AlphabetEncoding::NO_SYMBOL) {
+                        discovered.emplace(target_key, Discovery{ key, symbol });
+                        queue.emplace_back(lhs_target, rhs_target);
+                        return;
+                    }
+                    free_values = (free_values - free_mask) & free_mask;
+                } while (free_values != 0);
+            });
+    }
+    return false;
+}
+
+size_t Nfa::memory_footprint() const {
+    size_t bytes = sizeof(Nfa);
+    if (alphabet_encoding != nullptr) {
+        bytes += alphabet_encoding->memory_footprint();
+    }
+    if (nfa_impl != nullptr) {
+        bytes += sizeof(DFA) + static_cast<size_t>(nfa_impl->ns) * (sizeof(bdd_handle) + sizeof(int)) +
+                 bdd_size(nfa_impl->bddm) * MONA_BYTES_PER_NODE;
+    }
+    return bytes;
+}
+
+bool Nfa::is_empty(MataSymbolVector* witness) const {
+    TIME(const bool is_nonempty = find_product_witness(*this, [](const bool lhs_final, const bool) { return lhs_final; }, witness));
+    return !is_nonempty;
+}
+
+bool Nfa::is_included(const Nfa& other, MataSymbolVector* witness) const {
+    TIME(const bool has_counterexample = find_product_witness(other,
+        [](const bool lhs_final, const bool rhs_final) { return lhs_final && !rhs_final; }, witness));
+    return !has_counterexample;
+}
+
+bool Nfa::are_equivalent(const Nfa& other, MataSymbolVector* witness) const {
+    TIME(const bool has_counterexample = find_product_witness(other,
+        [](const bool lhs_final, const bool rhs_final) { return lhs_final != rhs_final; }, witness));
+    return !has_counterexample;
+}
+
 Nfa& Nfa::complement() {
     TIME(dfaNegation(nfa_impl));
     return *this;
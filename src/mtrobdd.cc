@@ -3,6 +3,98 @@
 namespace mamonata::mtrobdd
 {
 
+size_t NodeTable::find_slot(const MtBddNode& node) const {
+    assert(!slots.empty());
+    const size_t mask = slots.size() - 1;
+    size_t slot = NodePtrHash()(node) & mask;
+    while (slots[slot] != nullptr && !(*slots[slot] == node)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void NodeTable::rehash(const size_t capacity) {
+    assert(capacity != 0 && (capacity & (capacity - 1)) == 0 && capacity >= 2 * num_of_nodes);
+    std::vector<MtBddNodePtr> old_slots = std::exchange(slots, std::vector<MtBddNodePtr>(capacity));
+    for (MtBddNodePtr& node : old_slots) {
+        if (node != nullptr) {
+            const size_t slot = find_slot(*node);
+            slots[slot] = std::move(node);
+        }
+    }
+}
+
+void NodeTable::erase_slot(size_t hole) {
+    assert(slots[hole] != nullptr);
+    const size_t mask = slots.size() - 1;
+    slots[hole] = nullptr;
+    --num_of_nodes;
+    // Move back every following node whose home slot does not lie between the hole and the node.
+    for (size_t slot = (hole + 1) & mask; slots[slot] != nullptr; slot = (slot + 1) & mask) {
+        const size_t home = NodePtrHash()(slots[slot]) & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            slots[hole] = std::move(slots[slot]);
+            hole = slot;
+        }
+    }
+}
+
+NodeTable::const_iterator NodeTable::find(const MtBddNodePtr& node) const {
+    if (slots.empty()) {
+        return end();
+    }
+    const size_t slot = find_slot(*node);
+    return (slots[slot] == nullptr) ? end() : const_iterator(slots.data() + slot, slots.data() + slots.size());
+}
+
+std::pair<NodeTable::const_iterator, bool> NodeTable::insert(MtBddNodePtr node) {
+    // Keep the load factor at most 1/2 to have short probe sequences.
+    if (2 * (num_of_nodes + 1) > slots.size()) {
+        rehash(std::max<size_t>(16, 2 * slots.size()));
+    }
+    const size_t slot = find_slot(*node);
+    const bool inserted = (slots[slot] == nullptr);
+    if (inserted) {
+        slots[slot] = std::move(node);
+        ++num_of_nodes;
+    }
+    return { const_iterator(slots.data() + slot, slots.data() + slots.size()), inserted };
+}
+
+void NodeTable::erase(const const_iterator it) {
+    assert(it != end());
+    erase_slot(static_cast<size_t>(it.slot - slots.data()));
+}
+
+size_t NodeTable::erase(const MtBddNodePtr& node) {
+    const const_iterator it = find(node);
+    if (it == end()) {
+        return 0;
+    }
+    erase(it);
+    return 1;
+}
+
+ProbeStatistics NodeTable::get_probe_statistics() const {
+    ProbeStatistics statistics;
+    statistics.num_of_keys = num_of_nodes;
+    statistics.capacity = slots.size();
+    if (num_of_nodes == 0) {
+        return statistics;
+    }
+    const size_t mask = slots.size() - 1;
+    size_t total = 0;
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+        if (slots[slot] != nullptr) {
+            const size_t length = ((slot - (NodePtrHash()(slots[slot]) & mask)) & mask) + 1;
+            total += length;
+            statistics.max_probe_length = std::max(statistics.max_probe_length, length);
+        }
+    }
+    statistics.mean_probe_length = static_cast<double>(total) / static_cast<double>(num_of_nodes);
+    return statistics;
+}
+
 MtRobdd& MtRobdd::from_mona(const size_t num_of_vars, bdd_manager* bddm, bdd_ptr* root_behavior_ptrs, const size_t num_of_roots) {
     this->num_of_vars = num_of_vars;
 
@@ -68,69 +160,77 @@ void MtRobdd::to_mona(bdd_manager* bddm, bdd_ptr* root_behavior_ptrs) const {
                             return pair.first >= 0 && pair.first < this->root_nodes_map.size();
                         }));
 
-    const size_t num_of_nodes = nodes.size();
-
-    // Create positioning for each node in MTROBDD
-    NodeToNameMap node_to_position_map;
-    size_t position = 0;
-    for (const auto& node : nodes) {
-        node_to_position_map[node] = position++;
-    }
-
-    // Set root behavior pointers
-    for (const auto& [root_name, root_node] : root_nodes_map) {
-        root_behavior_ptrs[root_name] = static_cast<bdd_ptr>(node_to_position_map[root_node]);
-    }
-
-    // Create MONA BDD node table
-    BddNode* node_table = (BddNode*)mem_alloc(sizeof(BddNode) * num_of_nodes);
+    // Level of a node counted from the bottom: terminals are at level 0, the last variable at level 1.
+    auto get_level = [this](const MtBddNode* node) -> size_t {
+        return node->is_terminal() ? 0 : num_of_vars - static_cast<size_t>(node->var_index);
+    };
 
-    // Recursive function to create MONA nodes and initialize BDD manager
-    std::function<bdd_ptr(bdd_ptr)> make_mona_node = [&](bdd_ptr i) -> bdd_ptr {
-        if (node_table[i].p != -1) {
-            return node_table[i].p;
+    // Collect the reachable nodes with an explicit worklist, starting from the roots in the order of their names.
+    std::unordered_map<const MtBddNode*, size_t> positions;
+    positions.reserve(nodes.size());
+    std::vector<const MtBddNode*> reachable;
+    reachable.reserve(nodes.size());
+    std::vector<size_t> level_sizes(num_of_vars + 1, 0);
+    for (NodeName root_name = 0; root_name < root_nodes_map.size(); ++root_name) {
+        const MtBddNode* root_node = root_nodes_map.at(root_name).get();
+        if (!positions.emplace(root_node, 0).second) {
+            continue;
         }
-
-        if (node_table[i].idx == -1) {
-            // Terminal node
-            node_table[i].p = bdd_find_leaf_sequential(bddm, node_table[i].lo);
-        } else {
-            assert(node_table[i].lo != node_table[i].hi);
-            node_table[i].lo = make_mona_node(node_table[i].lo);
-            node_table[i].hi = make_mona_node(node_table[i].hi);
-            node_table[i].p = bdd_find_node_sequential(bddm,
-                                                       node_table[i].lo,
-                                                       node_table[i].hi,
-                                                       node_table[i].idx);
+        std::vector<const MtBddNode*> worklist{ root_node };
+        while (!worklist.empty()) {
+            const MtBddNode* node = worklist.back();
+            worklist.pop_back();
+            reachable.push_back(node);
+            ++level_sizes[get_level(node)];
+            if (node->is_terminal()) {
+                continue;
+            }
+            assert(node->low != nullptr);
+            assert(node->high != nullptr);
+            assert(node->low != node->high);
+            for (const MtBddNode* child : { node->low.get(), node->high.get() }) {
+                if (positions.emplace(child, 0).second) {
+                    worklist.push_back(child);
+                }
+            }
         }
+    }
 
-        return node_table[i].p;
-    };
+    // Order the nodes bottom-up by levels (counting sort keeps the discovery order within a level).
+    // Children are on lower levels than their parents, so they get smaller positions.
+    std::vector<size_t> level_offsets(num_of_vars + 1, 0);
+    for (size_t level = 1; level <= num_of_vars; ++level) {
+        level_offsets[level] = level_offsets[level - 1] + level_sizes[level - 1];
+    }
+    std::vector<const MtBddNode*> order(reachable.size());
+    for (const MtBddNode* node : reachable) {
+        const size_t position = level_offsets[get_level(node)]++;
+        order[position] = node;
+        positions[node] = position;
+    }
 
-    // Create all MONA nodes
-    for (const auto [node, node_pos]: node_to_position_map) {
-        node_table[node_pos].p = -1; // mark as uncreated
+    // Create the MONA nodes sequentially in the order of positions.
+    std::vector<bdd_ptr> mona_nodes(order.size());
+    for (size_t position = 0; position < order.size(); ++position) {
+        const MtBddNode* node = order[position];
         if (node->is_terminal()) {
             // MONA stores terminal value in 'lo' field
-            node_table[node_pos].lo = static_cast<unsigned>(node->value);
-            node_table[node_pos].hi = 0;
-            node_table[node_pos].idx = -1;
+            mona_nodes[position] = bdd_find_leaf_sequential(bddm, static_cast<unsigned>(node->value));
         } else {
-            assert(node->high != nullptr);
-            assert(node->low != nullptr);
-            node_table[node_pos].lo = static_cast<bdd_ptr>(node_to_position_map[node->low]);
-            node_table[node_pos].hi = static_cast<bdd_ptr>(node_to_position_map[node->high]);
-            node_table[node_pos].idx = static_cast<int>(node->var_index);
+            const size_t low_position = positions.at(node->low.get());
+            const size_t high_position = positions.at(node->high.get());
+            assert(low_position < position && high_position < position);
+            mona_nodes[position] = bdd_find_node_sequential(bddm,
+                                                            mona_nodes[low_position],
+                                                            mona_nodes[high_position],
+                                                            static_cast<unsigned>(node->var_index));
         }
     }
 
     // Fill the roots_behavior array with actual MONA node pointers
     for (NodeName root_name = 0; root_name < root_nodes_map.size(); ++root_name) {
-        root_behavior_ptrs[root_name] = make_mona_node(root_behavior_ptrs[root_name]);
+        root_behavior_ptrs[root_name] = mona_nodes[positions.at(root_nodes_map.at(root_name).get())];
     }
-
-    // Free MONA node table
-    mem_free(node_table);
 }
 
 MtBddNodePtr MtRobdd::insert_bit_string(const MtBddNodePtr src_node, const VarIndex var_index, const BitVector& bit_string, const NodeValue terminal_value) {
@@ -171,6 +271,79 @@ MtBddNodePtr MtRobdd::insert_bit_string(const MtBddNodePtr src_node, const VarIn
     return create_node(var_index, low_child, high_child);
 }
 
+MtBddNodePtr MtRobdd::update_bit_string(const MtBddNodePtr& node, const VarIndex var_index, const BitVector& bit_string, const MtBddNodePtr& terminal) {
+    if (var_index == static_cast<VarIndex>(num_of_vars)) {
+        return terminal;
+    }
+
+    // A missing node or a node testing a later variable does not depend on this variable.
+    const bool is_tested = (node != nullptr && node->var_index == var_index);
+    MtBddNodePtr low_child = is_tested ? node->low : node;
+    MtBddNodePtr high_child = is_tested ? node->high : node;
+    if (bit_string[var_index] == LO) {
+        low_child = update_bit_string(low_child, var_index + 1, bit_string, terminal);
+    } else {
+        high_child = update_bit_string(high_child, var_index + 1, bit_string, terminal);
+    }
+    return create_reduced_node(var_index, low_child, high_child);
+}
+
+void MtRobdd::replace_root(const NodeName name, MtBddNodePtr node) {
+    MtBddNodePtr old_node;
+    auto it = root_nodes_map.find(name);
+    if (it != root_nodes_map.end()) {
+        old_node = std::move(it->second);
+        if (node == nullptr) {
+            root_nodes_map.erase(it);
+        } else {
+            it->second = std::move(node);
+        }
+    } else if (node != nullptr) {
+        root_nodes_map.emplace(name, std::move(node));
+    }
+    release_node(std::move(old_node));
+}
+
+void MtRobdd::release_node(MtBddNodePtr node) {
+    std::vector<MtBddNodePtr> worklist;
+    worklist.push_back(std::move(node));
+    while (!worklist.empty()) {
+        MtBddNodePtr current = std::move(worklist.back());
+        worklist.pop_back();
+        // Still referenced by a parent, a root or a caller besides the unique table and current.
+        if (current == nullptr || current.use_count() > 2) {
+            continue;
+        }
+        auto it = nodes.find(current);
+        if (it == nodes.end() || *it != current) {
+            continue;
+        }
+        nodes.erase(it);
+        // Children lose a reference when current is destroyed at the end of this iteration.
+        worklist.push_back(current->low);
+        worklist.push_back(current->high);
+    }
+}
+
+MtBddNodePtr MtRobdd::set_bit_string(const NodeName root_name, const BitVector& bit_string, const NodeValue terminal_value) {
+    assert(bit_string.size() == num_of_vars);
+    MtBddNodePtr new_root = update_bit_string(get_root_node(root_name), 0, bit_string, create_terminal_node(terminal_value));
+    replace_root(root_name, new_root);
+    return new_root;
+}
+
+MtBddNodePtr MtRobdd::remove_bit_string(const NodeName root_name, const BitVector& bit_string) {
+    assert(bit_string.size() == num_of_vars);
+    MtBddNodePtr root_node = get_root_node(root_name);
+    if (root_node == nullptr) {
+        return nullptr;
+    }
+    MtBddNodePtr new_root = update_bit_string(root_node, 0, bit_string, nullptr);
+    root_node.reset();
+    replace_root(root_name, new_root);
+    return new_root;
+}
+
 std::vector<std::pair<BitVector, NodeValue>> MtRobdd::get_all_bit_strings_from_root_node(const MtBddNodePtr root_node) const {
     // Helper function to calculate transition length.
     auto get_transition_length = [&](const VarIndex src_idx, const VarIndex tgt_idx) -> size_t {
@@ -331,33 +504,58 @@ MtRobdd& MtRobdd::remove_redundant_tests() {
 }
 
 MtRobdd& MtRobdd::make_complete(const NodeValue sink_value, const bool complete_terminal_nodes) {
-    MtBddNodePtr terminal_sink = std::make_shared<MtBddNode>(TERMINAL_INDEX, nullptr, nullptr, sink_value);
+    // Nodes are hashed by their children, so completed nodes are created anew
+    // instead of modifying the children of nodes inside the unique table.
+    NodeSet old_nodes = std::move(nodes);
+    nodes = NodeSet();
+    MtBddNodePtr terminal_sink = create_terminal_node(sink_value);
     bool sink_usage_flag = false;
 
-    for (const auto& node : nodes) {
-        if (complete_terminal_nodes && node->is_terminal()) {
-            // Complete terminal nodes that don't have an appropriate root mapping.
-            // Each such new root will point directly to the terminal sink node.
-            if (!root_nodes_map.contains(node->value)) {
+    std::unordered_map<const MtBddNode*, MtBddNodePtr> completed_nodes;
+    std::function<MtBddNodePtr(const MtBddNodePtr&)> complete_rec = [&](const MtBddNodePtr& node) -> MtBddNodePtr {
+        if (node == nullptr) {
+            sink_usage_flag = true;
+            return terminal_sink;
+        }
+        auto it = completed_nodes.find(node.get());
+        if (it != completed_nodes.end()) {
+            return it->second;
+        }
+        MtBddNodePtr completed_node;
+        if (node->is_terminal()) {
+            completed_node = create_node(TERMINAL_INDEX, nullptr, nullptr, node->value);
+        } else {
+            MtBddNodePtr low_child = complete_rec(node->low);
+            MtBddNodePtr high_child = complete_rec(node->high);
+            completed_node = create_node(node->var_index, low_child, high_child, node->value);
+        }
+        completed_nodes.emplace(node.get(), completed_node);
+        return completed_node;
+    };
+
+    for (const auto& node : old_nodes) {
+        complete_rec(node);
+    }
+    for (auto& [name, root_node] : root_nodes_map) {
+        root_node = complete_rec(root_node);
+    }
+
+    if (complete_terminal_nodes) {
+        // Complete terminal nodes that don't have an appropriate root mapping.
+        // Each such new root will point directly to the terminal sink node.
+        for (const auto& node : old_nodes) {
+            if (node->is_terminal() && !root_nodes_map.contains(node->value)) {
                 root_nodes_map[node->value] = terminal_sink;
                 sink_usage_flag = true;
             }
-            continue;
-        }
-
-        if (node->low == nullptr) {
-            node->low = terminal_sink;
-            sink_usage_flag = true;
-        }
-        if (node->high == nullptr) {
-            node->high = terminal_sink;
-            sink_usage_flag = true;
         }
     }
 
     if (sink_usage_flag) {
-        nodes.insert(terminal_sink);
         root_nodes_map[sink_value] = terminal_sink;
+    } else if (terminal_sink.use_count() <= 2) {
+        // The sink was not part of the diagram before.
+        nodes.erase(terminal_sink);
     }
 
     return *this;